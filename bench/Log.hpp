@@ -48,6 +48,7 @@ struct Log {
   std::size_t   cxx_ver_size_;
   std::size_t   build_size_;
   std::size_t   tbb_malloc_size_;
+  std::size_t   index_size_;
   std::ofstream out_;
   std::ostream& os_;
 
@@ -97,6 +98,7 @@ struct Log {
     cxx_ver_size_    = std::max(sizeof(CXX_VERSION), sizeof("CXX_VER")) + 1;
     build_size_      = std::max(sizeof(BUILD_TYPE), sizeof("Build")) + 1;
     tbb_malloc_size_ = std::max(sizeof(USE_TBBMALLOC), sizeof("TBBMALLOC")) + 1;
+    index_size_      = std::max(sizeof(INDEX_64BIT), sizeof("INDEX64")) + 1;
   }
 
   template <class... Times>
@@ -113,6 +115,7 @@ struct Log {
     os_ << std::setw(cxx_ver_size_) << std::left << "CXX_VER";
     os_ << std::setw(build_size_) << std::left << "Build";
     os_ << std::setw(tbb_malloc_size_) << std::left << "TBBMALLOC";
+    os_ << std::setw(index_size_) << std::left << "INDEX64";
     os_ << std::setw(15) << std::left << "Date";
     os_ << std::setw(sizeof(host_)) << std::left << "Host";
     os_ << std::setw(10) << std::left << "Benchmark";
@@ -146,6 +149,7 @@ struct Log {
     os_ << std::setw(cxx_ver_size_) << std::left << CXX_VERSION;
     os_ << std::setw(build_size_) << std::left << BUILD_TYPE;
     os_ << std::setw(tbb_malloc_size_) << std::left << USE_TBBMALLOC;
+    os_ << std::setw(index_size_) << std::left << INDEX_64BIT;
     os_ << std::setw(15) << std::left << date_;
     os_ << std::setw(sizeof(host_)) << std::left << host_;
     os_ << std::setw(10) << std::left << benchmark;
@@ -18,17 +18,21 @@ static constexpr const char USAGE[] =
   Usage:
       process_edge_list (-h | --help)
       process_edge_list --version
-      process_edge_list [-d <file>] [-u <file>] <input>
+      process_edge_list [-d <file>] [-u <file>] [-c <file>] [--memory <bytes>] [--scratch <dir>] <input>
 
   Options:
       -h, --help      show this screen
       --version       driver version
       -d <file>       generate directed graph
       -u <file>       generate undirected graph
+      -c <file>       build a mapped undirected adjacency out of core
+      --memory <bytes>  memory budget for -c [default: 1073741824]
+      --scratch <dir>   directory for -c to spill sorted runs to [default: ]
 )";
 
 #include "common.hpp"
 #include "nwgraph/graph_base.hpp"
+#include "nwgraph/io/out_of_core_build.hpp"
 #include <docopt.h>
 
 using namespace nw::graph;
@@ -64,5 +68,14 @@ int main(int argc, char* const argv[]) {
     eval<nw::graph::directedness::undirected, int>(input, args["-u"].asString());
   }
 
+  if (args["-c"]) {
+    std::cout << "Building mapped adjacency out of core\n";
+    auto&& [build] = nw::graph::bench::time_op([&] {
+      out_of_core_build<0, nw::graph::directedness::undirected>(input, args["-c"].asString(), std::stoul(args["--memory"].asString()),
+                                                                args["--scratch"].asString());
+    });
+    std::cout << build << " seconds\n";
+  }
+
   return 0;
 }
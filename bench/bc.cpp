@@ -17,7 +17,7 @@ static constexpr const char USAGE[] =
     R"(bc2.exe : BGL17 betweenness centrality benchmark driver.
   Usage:
       bc2.exe (-h | --help)
-      bc2.exe -f FILE [-r NODE | -s FILE ] [-i NUM] [-n NUM] [--seed NUM] [--version ID...] [--log FILE] [--log-header] [-dvV] [THREADS]...
+      bc2.exe -f FILE [-r NODE | -s FILE ] [-i NUM] [-n NUM] [--seed NUM] [-w NUM] [--version ID...] [--log FILE] [--log-header] [-dvV] [THREADS]...
 
   Options:
       -h, --help              show this screen
@@ -27,6 +27,7 @@ static constexpr const char USAGE[] =
       -r NODE                 start from node r (default is random)
       -s, --sources FILE      sources file
       --seed NUM              random seed [default: 27491095]
+      -w NUM                  sources per batch of versions 5 and 8, at most 64 [default: 64]
       --version ID            algorithm version to run [default: 5]
       --log FILE              log times to a file
       --log-header            add a header to the log file
@@ -69,6 +70,7 @@ int main(int argc, char* argv[]) {
   bool        debug      = args["--debug"].asBool();
   long        trials     = args["-n"].asLong() ?: 1;
   long        iterations = args["-i"].asLong() ?: 1;
+  long        width      = args["-w"].asLong();
   std::string file       = args["-f"].asString();
 
   std::vector ids     = parse_ids(args["--version"].asStringList());
@@ -133,13 +135,13 @@ int main(int argc, char* argv[]) {
             case 4:
               return bc2_v4<score_t, accum_t>(graph, trial_sources, thread);
             case 5:
-              return brandes_bc<score_t, accum_t>(graph, trial_sources, thread);
+              return brandes_bc<score_t, accum_t>(graph, trial_sources, thread, std::execution::par_unseq, std::execution::par_unseq, true, width);
             case 6:
               return brandes_bc(graph);
             case 7:
               return approx_betweenness_brandes(graph, trial_sources);
             case 8:
-              return exact_brandes_bc<score_t, accum_t, decltype(graph)>(graph, thread);
+              return exact_brandes_bc<score_t, accum_t, decltype(graph)>(graph, thread, std::execution::par_unseq, std::execution::par_unseq, true, width);
             default:
               std::cerr << "Invalid BC version " << id << "\n";
               return {};
@@ -25,7 +25,7 @@ static constexpr const char USAGE[] =
       -i NUM                  number of iteration [default: 1]
       -a NUM                  alpha parameter [default: 15]
       -b NUM                  beta parameter [default: 18]
-      -B NUM                  number of bins [default: 32]
+      -B NUM                  number of bins of versions 1 and 2 [default: 32]
       -n NUM                  number of trials [default: 1]
       -r NODE                 start from node r (default is random)
       -s, --sources FILE      sources file
@@ -108,6 +108,8 @@ int main(int argc, char* argv[]) {
           std::cout << "source: " << source << "\n";
         }
 
+        std::vector<frontier_level> trace;
+
         auto&& [time, parents] = time_op([&] {
           switch (id) {
             case 0:
@@ -127,7 +129,7 @@ int main(int argc, char* argv[]) {
             case 10:
               return bfs_top_down(graph, source);
             case 11:
-              return bfs(graph, gx, source, num_bins, alpha, beta);
+              return bfs(graph, gx, source, num_bins, alpha, beta, verbose ? &trace : nullptr);
             case 12:
               return bfs_top_down_bitmap(graph, source);
             case 13:
@@ -138,6 +140,10 @@ int main(int argc, char* argv[]) {
           }
         });
 
+        for (auto&& step : trace) {
+          std::cout << (step.bottom_up ? "  bottom-up " : "  top-down  ") << step.frontier << " " << step.seconds << "\n";
+        }
+
         if (verify) {
           BFSVerifier(graph, gx, source, parents);
         }
@@ -121,10 +121,7 @@ int main(int argc, char* argv[]) {
         // Clean up the edgelist to deal with the normal issues related to
         // undirectedness.
         if (args["--clean"].asBool()) {
-          swap_to_triangular<0>(aos_a, args["--succession"].asString());
-          lexical_sort_by<0>(aos_a);
-          uniq(aos_a);
-          remove_self_loops(aos_a);
+          simplify_triangular<0>(aos_a, args["--succession"].asString());
         }
 
         adjacency<0> graph(aos_a);
@@ -144,10 +141,7 @@ int main(int argc, char* argv[]) {
         // Clean up the edgelist to deal with the normal issues related to
         // undirectedness.
         if (args["--clean"].asBool()) {
-          swap_to_triangular<0>(aos_a, args["--succession"].asString());
-          lexical_sort_by<0>(aos_a);
-          uniq(aos_a);
-          remove_self_loops(aos_a);
+          simplify_triangular<0>(aos_a, args["--succession"].asString());
         }
 
         adjacency<0> graph(aos_a);
@@ -231,6 +225,9 @@ int main(int argc, char* argv[]) {
            case 11: 
               record([&] { return lpcc_cyclic(std::execution::par_unseq, graph, thread); }); //lp
               break;
+            case 12:
+              record([&] { return union_find_components(std::execution::par_unseq, graph); });    //union-find
+              break;
             default:
               std::cout << "Unknown version v" << id << "\n";
           }
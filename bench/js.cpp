@@ -66,10 +66,7 @@ static void tc_relabel(edge_list<nw::graph::directedness::undirected>& A, Vector
 template <std::size_t id = 0>
 static void clean(edge_list<nw::graph::directedness::undirected>& A, const std::string& succession) {
   life_timer _(__func__);
-  swap_to_triangular<id>(A, succession);
-  lexical_sort_by<id>(A);
-  uniq(A);
-  remove_self_loops(A);
+  simplify_triangular<id>(A, succession);
 }
 
 template <typename Graph>
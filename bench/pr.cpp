@@ -38,6 +38,8 @@ static constexpr const char USAGE[] =
 #include "nwgraph/experimental/algorithms/page_rank.hpp"
 #include "common.hpp"
 #include <docopt.h>
+#include <algorithm>
+#include <optional>
 
 using namespace nw::graph::bench;
 using namespace nw::graph;
@@ -76,6 +78,12 @@ int main(int argc, char* argv[]) {
     }
 
     auto graph = build_adjacency<1>(aos_a);
+
+    // Only page_rank_delta (version 16) uses the out-edges.
+    std::optional<decltype(build_adjacency<0>(aos_a))> out;
+    if (std::find(ids.begin(), ids.end(), 16) != ids.end()) {
+      out.emplace(build_adjacency<0>(aos_a));
+    }
     if (verbose) {
       graph.stream_stats();
     }
@@ -150,6 +158,14 @@ int main(int argc, char* argv[]) {
                 page_rank_v14(graph, degrees, rankings, 0.85f, tolerance, max_iters);
                 break;
 
+              case 15:
+                page_rank_pull(graph, rankings, 0.85, tolerance, max_iters);
+                break;
+
+              case 16:
+                page_rank_delta(*out, graph, rankings, 0.85, tolerance, max_iters);
+                break;
+
               default:
                 std::cerr << "Unknown version id " << id << std::endl;
                 break;
@@ -0,0 +1,186 @@
+/**
+ * @file reorder.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+static constexpr const char USAGE[] =
+    R"(reorder.exe: BGL17 vertex reordering benchmark driver.
+  Usage:
+      reorder.exe (-h | --help)
+      reorder.exe -f FILE [--version ID...] [-n NUM] [-i NUM] [--seed NUM] [-V] [THREADS]...
+
+  Options:
+      -h, --help              show this screen
+      -f FILE                 input file path (read as undirected)
+      --version ID            ordering to run: 0 none, 1 rcm, 2 dbg, 3 hub cluster, 4 gorder, 5 rabbit [default: 0 1 2 3 4 5]
+      -n NUM                  number of bfs sources [default: 8]
+      -i NUM                  maximum page rank iterations [default: 20]
+      --seed NUM              random seed [default: 27491095]
+      -V, --verbose           run in verbose mode
+)";
+
+#include "nwgraph/algorithms/bfs.hpp"
+#include "nwgraph/algorithms/page_rank.hpp"
+#include "nwgraph/reorder.hpp"
+#include "common.hpp"
+#include <docopt.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace nw::graph::bench;
+using namespace nw::graph;
+using namespace nw::util;
+
+/// Counts last-level cache misses of this process (and its threads) while
+/// running an operation.  The count is -1 where the counter is unavailable,
+/// e.g., off Linux or when perf events are not permitted.
+class cache_misses {
+  int fd_ = -1;
+
+public:
+  cache_misses() {
+#if defined(__linux__)
+    perf_event_attr attr{};
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled       = 1;
+    attr.inherit        = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd_                 = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+  }
+
+  ~cache_misses() {
+#if defined(__linux__)
+    if (fd_ != -1) {
+      close(fd_);
+    }
+#endif
+  }
+
+  template <class Op>
+  long long operator()(Op&& op) {
+#if defined(__linux__)
+    if (fd_ != -1) {
+      long long count = 0;
+      ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+      op();
+      ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+      return read(fd_, &count, sizeof(count)) == sizeof(count) ? count : -1;
+    }
+#endif
+    op();
+    return -1;
+  }
+};
+
+static const char* names[] = {"none", "rcm", "dbg", "hub", "gorder", "rabbit"};
+
+int main(int argc, char* argv[]) {
+  std::vector<std::string> strings(argv + 1, argv + argc);
+  auto                     args = docopt::docopt(USAGE, strings, true);
+
+  bool        verbose   = args["--verbose"].asBool();
+  long        n_sources = args["-n"].asLong() ?: 8;
+  long        max_iters = args["-i"].asLong() ?: 20;
+  std::string file      = args["-f"].asString();
+
+  std::vector ids     = parse_ids(args["--version"].asStringList());
+  std::vector threads = parse_n_threads(args["THREADS"].asStringList());
+
+  auto el_a  = load_graph<directedness::undirected>(file);
+  auto graph = build_adjacency<0>(el_a);
+  if (verbose) {
+    graph.stream_stats();
+  }
+
+  using vertex_id_type = vertex_id_t<decltype(graph)>;
+  auto sources         = build_random_sources(graph, n_sources, args["--seed"].asLong());
+
+  std::cout << std::setw(10) << std::left << "Order" << std::setw(10) << "Threads" << std::setw(14) << "Reorder(s)" << std::setw(14)
+            << "BFS(s)" << std::setw(16) << "BFS misses" << std::setw(14) << "PR(s)" << std::setw(16) << "PR misses" << std::setw(12)
+            << "BFS x" << std::setw(12) << "PR x"
+            << "\n";
+
+  for (auto&& thread : threads) {
+    auto _ = set_n_threads(thread);
+
+    double       bfs_base = 0, pr_base = 0;
+    cache_misses counter;
+    for (auto&& id : ids) {
+      if (id < 0 || id > 5) {
+        std::cerr << "Unknown version " << id << "\n";
+        continue;
+      }
+
+      auto&& [reorder_time, perm] = time_op([&] {
+        switch (id) {
+          case 1:
+            return rcm(graph);
+          case 2:
+            return degree_based_grouping(graph);
+          case 3:
+            return hub_cluster(graph);
+          case 4:
+            return gorder(graph);
+          case 5:
+            return rabbit_order(graph);
+          default: {
+            std::vector<vertex_id_type> identity(num_vertices(graph));
+            std::iota(identity.begin(), identity.end(), 0);
+            return identity;
+          }
+        }
+      });
+      auto g = permute_vertices(graph, perm);
+
+      std::vector<vertex_id_type> iperm(perm.size());
+      for (std::size_t i = 0; i < perm.size(); ++i) {
+        iperm[perm[i]] = i;
+      }
+
+      // The graph is symmetric, so it is its own transpose.
+      long long bfs_misses = 0;
+      auto [bfs_time]      = time_op([&] {
+        bfs_misses = counter([&] {
+          for (auto&& source : sources) {
+            bfs(g, g, iperm[source]);
+          }
+        });
+      });
+
+      std::vector<float> rank(num_vertices(g));
+      long long          pr_misses = 0;
+      auto [pr_time]               = time_op([&] { pr_misses = counter([&] { page_rank_pull<float>(g, rank, 0.85, 1e-4, max_iters); }); });
+
+      // Speedups are relative to the first version run.
+      if (id == ids.front()) {
+        bfs_base = bfs_time;
+        pr_base  = pr_time;
+      }
+
+      std::cout << std::setw(10) << std::left << names[id] << std::setw(10) << thread << std::setw(14) << std::setprecision(6) << std::fixed
+                << reorder_time << std::setw(14) << bfs_time << std::setw(16) << bfs_misses << std::setw(14) << pr_time << std::setw(16)
+                << pr_misses << std::setw(12) << std::setprecision(3) << bfs_base / bfs_time << std::setw(12) << pr_base / pr_time << "\n";
+    }
+  }
+
+  return 0;
+}
@@ -25,11 +25,11 @@ static constexpr const char USAGE[] =
       -i NUM                  number of iteration [default: 1]
       -n NUM                  number of trials [default: 1]
       -r NODE                 start from node r
-      -d, --delta NUM         value for delta [default: 2]
+      -d, --delta NUM         value for delta, by default 2, except that version 12 picks it from the edge weights
       -s, --sources FILE      sources file
       --seed NUM              random seed [default: 27491095]
       --version ID            algorithm version to run [default: 0]
-      --log FILE              log times to a file
+      --log FILE              log times to a file, and those of version 12, with its Edges/s, to FILE.edges
       --log-header            add a header to the log file
       --debug                 run in debug mode
       -v, --verify            verify results
@@ -115,10 +115,11 @@ Weight weight) {
 
 /// The heart of the SSSP benchmark, dispatches to the right algorithm version
 /// and verifies the result, based on the verifier. Returns the time it took to
-/// run, as well as a boolean indicating if we passed verification.
+/// run, as well as a boolean indicating if we passed verification. Versions
+/// that count their relaxations store the count in `relaxed`.
 template <adjacency_list_graph Graph, class Weight, class Verifier>
 static std::tuple<double, bool> sssp(int id, const Graph& graph, vertex_id_t<Graph> source, distance_t delta, Weight weight,
-                                     Verifier&& verifier) {
+                                     Verifier&& verifier, std::size_t& relaxed) {
   switch (id) {
     case 0:
       return time_op_verify([&] { return delta_stepping<distance_t>(graph, source, delta, weight); }, std::forward<Verifier>(verifier));
@@ -135,7 +136,8 @@ static std::tuple<double, bool> sssp(int id, const Graph& graph, vertex_id_t<Gra
     case 11:
       return time_op_verify([&] { return delta_stepping_v11<distance_t>(graph, source, delta, weight); }, std::forward<Verifier>(verifier));
     case 12:
-      return time_op_verify([&] { return delta_stepping<distance_t>(graph, source, delta); }, std::forward<Verifier>(verifier));
+      return time_op_verify([&] { return parallel_delta_stepping<distance_t>(graph, source, delta, weight, &relaxed); },
+                            std::forward<Verifier>(verifier));
     case 13:
       return time_op_verify([&] { return dijkstra<Graph, Weight>(graph, source, weight); }, std::forward<Verifier>(verifier));
     default:
@@ -144,6 +146,9 @@ static std::tuple<double, bool> sssp(int id, const Graph& graph, vertex_id_t<Gra
   }
 }
 
+/// Whether the version stores its relaxations in `relaxed`, i.e., has an Edges/s rate.
+static bool counts_relaxations(int id) { return id == 12; }
+
 int main(int argc, char* argv[]) {
   std::vector strings = std::vector<std::string>(argv + 1, argv + argc);
   std::map    args    = docopt::docopt(USAGE, strings, true);
@@ -155,7 +160,8 @@ int main(int argc, char* argv[]) {
   long        trials     = args["-n"].asLong() ?: 1;    // at least one trial
   long        iterations = args["-i"].asLong() ?: 1;    // at least one iteration
   std::string file       = args["-f"].asString();
-  std::size_t delta      = args["--delta"].asLong() ?: 1;    // at least one
+  bool        set_delta  = bool(args["--delta"]);
+  std::size_t delta      = set_delta ? args["--delta"].asLong() : 2;
 
   std::vector ids     = parse_ids(args["--version"].asStringList());
   std::vector threads = parse_n_threads(args["THREADS"].asStringList());
@@ -169,8 +175,12 @@ int main(int argc, char* argv[]) {
   auto graph = build_adjacency<0>(aos_a);
   auto weight = [](auto& e) -> auto& { return std::get<1>(e); };
 
+  // The versions that count their relaxations pick delta from the edge weights
+  // unless it is given; the others keep the fixed default.
+  std::size_t counted_delta = set_delta ? delta : choose_delta<distance_t>(graph, weight);
   if (verbose) {
     graph.stream_stats();
+    std::cout << "delta: " << delta << " (version 12: " << counted_delta << ")\n";
   }
 
   if (debug) {
@@ -188,7 +198,8 @@ int main(int argc, char* argv[]) {
     sources = build_random_sources(graph, trials, args["--seed"].asLong());
   }
 
-  Times times;
+  Times<>       times;      // versions that do not count their relaxations
+  Times<double> counted;    // versions that do, with their Edges/s
 
   for (auto&& thread : threads) {
     auto _ = set_n_threads(thread);
@@ -196,31 +207,58 @@ int main(int argc, char* argv[]) {
       for (int i = 0; i < trials; ++i) {
         std::cout << "running version: " << id << " trial: " << i << "\n";
 
-        double time = 0;
+        double      time    = 0;
+        std::size_t relaxed = 0;
         for (int j = 0; j < iterations; ++j) {
           auto source = sources[i * iterations + j];
           if (verbose) {
             std::cout << "iteration: " << j << " source: " << source << "\n";
           }
-          auto [t, v] = sssp(id, graph, source, delta, weight, [&](auto&& dist) {
+          std::size_t edges = 0;
+          auto [t, v]       = sssp(id, graph, source, counts_relaxations(id) ? counted_delta : delta, weight, [&](auto&& dist) {
             if (verify) {
               return SSSPVerifier(graph, source, std::forward<decltype(dist)>(dist), verbose, weight);
             }
             return true;
-          });
+          }, edges);
           time += t;
+          relaxed += edges;
+        }
+        if (counts_relaxations(id)) {
+          double rate = relaxed / time;
+          std::cout << "edges relaxed: " << relaxed << " (" << rate << " per second)\n";
+          counted.append(file, id, thread, time, rate);
+        } else {
+          times.append(file, id, thread, time);
         }
-        times.append(file, id, thread, time);
       }
     }
   }
 
-  times.print(std::cout);
+  bool any_counted = counted.begin() != counted.end();
+  bool any_other   = times.begin() != times.end();
+  if (any_counted) {
+    counted.print(std::cout);
+  }
+  if (any_other) {
+    times.print(std::cout);
+  }
 
   if (args["--log"]) {
     auto file   = args["--log"].asString();
     bool header = args["--log-header"].asBool();
-    log("sssp", file, times, header, "Time(s)");
+    if (any_other) {
+      log("sssp", file, times, header, "Time(s)");
+    }
+    // The Edges/s column changes the layout, so those rows get a file of their
+    // own, or, on standard output, a header of their own.
+    if (any_counted) {
+      if (file == "-") {
+        log("sssp", file, counted, header || any_other, "Time(s)", "Edges/s");
+      } else {
+        log("sssp", file + ".edges", counted, header, "Time(s)", "Edges/s");
+      }
+    }
   }
 
   return 0;
@@ -67,10 +67,7 @@ static void tc_relabel(edge_list<directedness::undirected>& A, Vector&& degrees,
 template <std::size_t id = 0>
 static void clean(edge_list<directedness::undirected>& A, const std::string& succession) {
   life_timer _(__func__);
-  swap_to_triangular<id>(A, succession);
-  lexical_sort_by<id>(A);
-  uniq(A);
-  remove_self_loops(A);
+  simplify_triangular<id>(A, succession);
 }
 
 template <adjacency_list_graph Graph>
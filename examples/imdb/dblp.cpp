@@ -28,6 +28,7 @@ using json = nlohmann::json;
 
 #include "nwgraph/adaptors/bfs_edge_range.hpp"
 #include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/projection.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/util/timer.hpp"
@@ -111,32 +112,14 @@ int main() {
   t4.stop();
   std::cout << t4 << std::endl;
 
-  nw::util::timer t5("build s_overlap");
+  nw::util::timer t5("build s_overlap adjacency");
 
-  nw::graph::edge_list<nw::graph::directedness::undirected, size_t> s_overlap;
-  s_overlap.open_for_push_back();
-
-  for (size_t i = 0; i < H.size(); ++i) {
-    for (auto&& [k] : H[i]) {
-      for (auto&& [j] : G[k]) {
-        s_overlap.push_back(i, j, k);
-      }
-    }
-  }
-
-  // NB: may be clobbering values
-  s_overlap.close_for_push_back();
+  // Actors i -- j, with a title k they appeared in together.
+  auto L = nw::graph::bipartite_projection<nw::graph::projection_value::witness>(H, G);
 
   t5.stop();
   std::cout << t5 << std::endl;
 
-  nw::util::timer t6("build s_overlap adjacency");
-
-  auto L = nw::graph::adjacency<0, size_t>(s_overlap);
-
-  t6.stop();
-  std::cout << t6 << std::endl;
-
   //  size_t kevin_bacon = names_map["Donald E. Knuth"];
   size_t kevin_bacon = names_map["Paul Erd\u00f6s"];
 
@@ -27,6 +27,7 @@
 
 #include "nwgraph/adaptors/bfs_edge_range.hpp"
 #include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/projection.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/util/timer.hpp"
@@ -113,38 +114,14 @@ int main() {
   t4.stop();
   std::cout << t4 << std::endl;
 
-  nw::util::timer t5("build s_overlap");
+  nw::util::timer t5("build s_overlap adjacency");
 
-  nw::graph::edge_list<nw::graph::directedness::undirected, size_t> s_overlap;
-  s_overlap.open_for_push_back();
-
-  for (size_t i = 0; i < H.size(); ++i) {
-
-    if ((i % 8192) == 0) {
-      std::cout << i << std::endl;
-    }
-
-    for (auto&& [k] : H[i]) {
-      for (auto&& [j] : G[k]) {
-        if (j > i) {
-          s_overlap.push_back(i, j, k);
-        }
-      }
-    }
-  }
-
-  s_overlap.close_for_push_back();
+  // Actors i -- j, with a title k they appeared in together.
+  auto L = nw::graph::bipartite_projection<nw::graph::projection_value::witness>(H, G);
 
   t5.stop();
   std::cout << t5 << std::endl;
 
-  nw::util::timer t6("build s_overlap adjacency");
-
-  auto L = nw::graph::adjacency<0, size_t>(s_overlap);
-
-  t6.stop();
-  std::cout << t6 << std::endl;
-
   // Kevin Bacon is nm0000102
   // David Suchet is nm0837064
   // Kyra Sedgwick is nm0001718
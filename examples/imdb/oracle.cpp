@@ -31,6 +31,7 @@ using json = nlohmann::json;
 #include "nwgraph/algorithms/betweenness_centrality.hpp"
 #include "nwgraph/algorithms/page_rank.hpp"
 #include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/projection.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/util/proxysort.hpp"
@@ -153,33 +154,14 @@ int main() {
   t4.stop();
   std::cout << t4 << std::endl;
 
-  nw::util::timer t5("build s_overlap");
+  nw::util::timer t5("build s_overlap adjacency");
 
-  nw::graph::edge_list<nw::graph::directedness::undirected, size_t> s_overlap;
-  s_overlap.open_for_push_back();
-
-  for (size_t i = 0; i < H.size(); ++i) {    // foreach name
-    for (auto&& [k] : H[i]) {                //   foreach title
-      for (auto&& [j] : G[k]) {              //     foreach name
-        if (j > i) {
-          s_overlap.push_back(i, j, k);    //       edge from i -- j with value k
-        }
-      }
-    }
-  }
-
-  s_overlap.close_for_push_back();
+  // Actors i -- j, with a title k they appeared in together.
+  auto L = nw::graph::bipartite_projection<nw::graph::projection_value::witness>(H, G);
 
   t5.stop();
   std::cout << t5 << std::endl;
 
-  nw::util::timer t6("build s_overlap adjacency");
-
-  auto L = nw::graph::adjacency<0, size_t>(s_overlap);
-
-  t6.stop();
-  std::cout << t6 << std::endl;
-
   size_t kevin_bacon = names_map["Kevin Bacon"];
 
   std::vector<size_t> distance(L.size());
@@ -240,7 +222,7 @@ int main() {
 
 
   if constexpr (false) {
-    auto                L_t = nw::graph::adjacency<1, size_t>(s_overlap);
+    auto&               L_t = L;
     std::vector<double> page_rank(L.size());
 
     page_rank_v8(L_t, L.degrees(), page_rank, 0.85, 1.e-4, 20);
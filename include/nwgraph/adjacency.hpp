@@ -126,29 +126,29 @@ public:
     fill<idx>(A, *this, sort_adjacency, policy);
   }
   // customized move constructor
-  index_adjacency(std::vector<vertex_id>&& indices,
+  index_adjacency(std::vector<index_type>&& indices,
                   std::vector<vertex_id>&& first_to_be,
                   std::vector<Attributes>&&... rest_to_be)
       requires(std::is_same<unipartite_graph_base, unipartite_graph_base>::value) 
       : unipartite_graph_base(indices.size() - 1), base(std::move(indices), std::move(first_to_be), std::move(rest_to_be)...) {}
-  index_adjacency(std::vector<vertex_id>&& indices,
+  index_adjacency(std::vector<index_type>&& indices,
                   std::tuple<std::vector<vertex_id>,
                              std::vector<Attributes>...>&& to_be_indexed)
       requires(std::is_same<unipartite_graph_base, unipartite_graph_base>::value) 
       : unipartite_graph_base(indices.size() - 1), base(std::move(indices), std::move(to_be_indexed)) {}
   // customized copy constructor
-  index_adjacency(const std::vector<vertex_id>& indices,
+  index_adjacency(const std::vector<index_type>& indices,
                   const std::vector<vertex_id>& first_to_be,
                   const std::vector<Attributes>&... rest_to_be)
       requires(std::is_same<unipartite_graph_base, unipartite_graph_base>::value) 
       : unipartite_graph_base(indices.size() - 1), base(indices, first_to_be, rest_to_be...) {}
-  index_adjacency(const std::vector<vertex_id>& indices,
+  index_adjacency(const std::vector<index_type>& indices,
                   const std::tuple<std::vector<vertex_id>,
                                    std::vector<Attributes>...>& to_be_indexed)
       requires(std::is_same<unipartite_graph_base, unipartite_graph_base>::value) 
       : unipartite_graph_base(indices.size() - 1), base(indices, to_be_indexed) {}
 
-  num_vertices_type num_vertices() const { return {base::size()}; };
+  num_vertices_type num_vertices() const { return {static_cast<vertex_id_type>(base::size())}; };
   num_edges_type    num_edges() const { return base::to_be_indexed_.size(); };
   /**
    * @brief Serialize the index_adjacency into binary file.
@@ -157,6 +157,15 @@ public:
    */
   void serialize(const std::string& outfile_name) const {
     std::ofstream out_file(outfile_name, std::ofstream::binary);
+    serialize(out_file);
+  }
+
+  /**
+   * @brief Serialize the index_adjacency into a binary stream, e.g., to follow it with data derived from it.
+   * 
+   * @param out_file The output ostream object.
+   */
+  void serialize(std::ostream& out_file) const {
     unipartite_graph_base::serialize(out_file);
     base::serialize(out_file);
   }
@@ -168,6 +177,15 @@ public:
    */
   void deserialize(const std::string& infile_name) {
     std::ifstream infile(infile_name, std::ifstream::binary);
+    deserialize(infile);
+  }
+
+  /**
+   * @brief Deserialize the binary stream into index_adjacency.
+   * 
+   * @param infile The input istream object.
+   */
+  void deserialize(std::istream& infile) {
     unipartite_graph_base::deserialize(infile);
     base::deserialize(infile);
   }
@@ -250,22 +268,22 @@ public:
     fill_biadjacency<idx>(A, *this, sort_biadjacency, policy);
   }
   // customized move constructor
-  index_biadjacency(size_t N1, std::vector<vertex_id>&& indices,
+  index_biadjacency(size_t N1, std::vector<index_type>&& indices,
                   std::vector<vertex_id>&& first_to_be,
                   std::vector<Attributes>&&... rest_to_be)
       requires(std::is_same<bipartite_graph_base, bipartite_graph_base>::value)
       : bipartite_graph_base(indices.size() - 1, N1), base(std::move(indices), std::move(first_to_be), std::move(rest_to_be)...) {}
-  index_biadjacency(size_t N1, std::vector<vertex_id>&& indices,
+  index_biadjacency(size_t N1, std::vector<index_type>&& indices,
                   std::tuple<std::vector<vertex_id>,
                              std::vector<Attributes>...>&& to_be_indexed)
       : bipartite_graph_base(indices.size() - 1, N1), base(std::move(indices), std::move(to_be_indexed)) {}
   // customized copy constructor
-  index_biadjacency(size_t N1, const std::vector<vertex_id>& indices,
+  index_biadjacency(size_t N1, const std::vector<index_type>& indices,
                   const std::vector<vertex_id>& first_to_be,
                   const std::vector<Attributes>&... rest_to_be)
       requires(std::is_same<bipartite_graph_base, bipartite_graph_base>::value)
       : bipartite_graph_base(indices.size() - 1, N1), base(indices, first_to_be, rest_to_be...) {}
-  index_biadjacency(size_t N1, const std::vector<vertex_id>& indices,
+  index_biadjacency(size_t N1, const std::vector<index_type>& indices,
                   const std::tuple<std::vector<vertex_id>,
                                    std::vector<Attributes>...>& to_be_indexed)
       requires(std::is_same<bipartite_graph_base, bipartite_graph_base>::value)
@@ -0,0 +1,452 @@
+/**
+ * @file alt.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_ALT_HPP
+#define NW_GRAPH_ALT_HPP
+
+#include "nwgraph/algorithms/delta_stepping.hpp"
+#include "nwgraph/algorithms/dijkstra.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/defaults.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace nw {
+namespace graph {
+
+/// How select_landmarks places the landmarks.
+enum class landmark_selection {
+  farthest,    //!< each landmark is the vertex farthest from the ones already chosen
+  avoid        //!< each landmark is a leaf of a shortest-path tree in a region the others bound badly (Goldberg and Werneck)
+};
+
+/**
+ * @brief Landmark distance tables for ALT (A*, landmarks, triangle inequality).
+ *
+ * Stores the distances from every landmark to every vertex and, for directed
+ * graphs, from every vertex to every landmark.  The distances of a vertex to
+ * all landmarks are contiguous, so a lower bound reads one cache line per
+ * vertex.  By the triangle inequality, d(v, t) >= d(L, t) - d(L, v) and
+ * d(v, t) >= d(v, L) - d(t, L) for every landmark L, and the maximum of these
+ * bounds is a feasible potential for A*.  If L reaches v but not t, or t
+ * reaches L but v does not, v cannot reach t at all.
+ *
+ * @tparam Distance Type of the distances.
+ * @tparam Id Type of the vertex ids.
+ */
+template <class Distance, std::unsigned_integral Id = default_vertex_id_type>
+class landmark_table {
+  std::size_t           num_vertices_ = 0;
+  bool                  symmetric_    = true;
+  std::vector<Id>       landmarks_;
+  std::vector<Distance> from_;    // from_[v * k + i] = d(landmark i, v)
+  std::vector<Distance> to_;      // to_[v * k + i] = d(v, landmark i), empty if symmetric
+
+  template <class T>
+  static void write(std::ostream& out, const std::vector<T>& vs) {
+    std::size_t st_size = vs.size(), el_size = sizeof(T);
+    out.write(reinterpret_cast<const char*>(&st_size), sizeof(std::size_t));
+    out.write(reinterpret_cast<const char*>(&el_size), sizeof(std::size_t));
+    out.write(reinterpret_cast<const char*>(vs.data()), st_size * el_size);
+  }
+
+  template <class T>
+  static void read(std::istream& in, std::vector<T>& vs) {
+    std::size_t st_size = 0, el_size = 0;
+    in.read(reinterpret_cast<char*>(&st_size), sizeof(std::size_t));
+    in.read(reinterpret_cast<char*>(&el_size), sizeof(std::size_t));
+    if (el_size != sizeof(T)) {
+      throw std::runtime_error("landmark_table: file has " + std::to_string(el_size) + " byte entries but " + std::to_string(sizeof(T)) +
+                               " were expected");
+    }
+    vs.resize(st_size);
+    in.read(reinterpret_cast<char*>(vs.data()), st_size * el_size);
+  }
+
+  // Interleave one table per landmark into one row per vertex.
+  static std::vector<Distance> interleave(const std::vector<std::vector<Distance>>& tables, std::size_t n) {
+    const std::size_t     k = tables.size();
+    std::vector<Distance> rows(n * k);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        for (std::size_t i = 0; i < k; ++i) {
+          rows[v * k + i] = tables[i][v];
+        }
+      }
+    });
+    return rows;
+  }
+
+public:
+  static constexpr Distance infinity = std::numeric_limits<Distance>::max();
+
+  landmark_table() = default;
+
+  /// @param landmarks The landmarks.
+  /// @param from The distances from each landmark to every vertex.
+  /// @param to The distances from every vertex to each landmark, or nothing for a symmetric graph.
+  landmark_table(std::vector<Id> landmarks, const std::vector<std::vector<Distance>>& from, const std::vector<std::vector<Distance>>& to = {})
+      : num_vertices_(from.empty() ? 0 : from[0].size())
+      , symmetric_(to.empty())
+      , landmarks_(std::move(landmarks))
+      , from_(interleave(from, num_vertices_))
+      , to_(interleave(to, num_vertices_)) {}
+
+  std::size_t            size() const { return landmarks_.size(); }
+  std::size_t            num_vertices() const { return num_vertices_; }
+  bool                   symmetric() const { return symmetric_; }
+  const std::vector<Id>& landmarks() const { return landmarks_; }
+
+  /// The distance from landmark i to v.
+  Distance from(Id v, std::size_t i) const { return from_[v * size() + i]; }
+
+  /// The distance from v to landmark i.
+  Distance to(Id v, std::size_t i) const { return symmetric_ ? from(v, i) : to_[v * size() + i]; }
+
+  /// A lower bound on the distance from u to v given by landmark i, which is
+  /// infinity if the landmark proves that v cannot be reached from u.
+  Distance lower_bound(Id u, Id v, std::size_t i) const {
+    Distance bound = 0;
+    if (Distance fu = from(u, i), fv = from(v, i); fu != infinity) {
+      bound = (fv == infinity) ? infinity : (fu < fv ? fv - fu : 0);
+    }
+    if (Distance tu = to(u, i), tv = to(v, i); tv != infinity) {
+      bound = std::max(bound, (tu == infinity) ? infinity : (tv < tu ? Distance(tu - tv) : Distance(0)));
+    }
+    return bound;
+  }
+
+  /// A lower bound on the distance from u to v given by all landmarks.
+  Distance lower_bound(Id u, Id v) const {
+    Distance bound = 0;
+    for (std::size_t i = 0; i < size(); ++i) {
+      bound = std::max(bound, lower_bound(u, v, i));
+    }
+    return bound;
+  }
+
+  /**
+   * @brief Serialize the table into a binary stream, e.g., right after the graph it belongs to.
+   *
+   * @param out The output ostream object.
+   */
+  void serialize(std::ostream& out) const {
+    std::size_t header[2] = {num_vertices_, symmetric_};
+    out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    write(out, landmarks_);
+    write(out, from_);
+    write(out, to_);
+  }
+
+  void serialize(const std::string& outfile_name) const {
+    std::ofstream out(outfile_name, std::ofstream::binary);
+    serialize(out);
+  }
+
+  /**
+   * @brief Deserialize the table from a binary stream.
+   *
+   * @param in The input istream object.
+   */
+  void deserialize(std::istream& in) {
+    std::size_t header[2] = {0, 0};
+    in.read(reinterpret_cast<char*>(header), sizeof(header));
+    num_vertices_ = header[0];
+    symmetric_    = header[1];
+    read(in, landmarks_);
+    read(in, from_);
+    read(in, to_);
+  }
+
+  void deserialize(const std::string& infile_name) {
+    std::ifstream in(infile_name, std::ifstream::binary);
+    deserialize(in);
+  }
+};
+
+/**
+ * @brief Select landmarks and compute their distance tables.
+ *
+ * The distances from (and to) every landmark are computed with
+ * parallel_delta_stepping.  With landmark_selection::farthest, every new
+ * landmark is the vertex whose distance from the closest landmark chosen so
+ * far is largest, starting from the vertex farthest from a random one.  With
+ * landmark_selection::avoid, a shortest-path tree is grown from a random
+ * root, every vertex is weighted by how much the current landmarks
+ * underestimate its distance from the root, and the new landmark is the leaf
+ * reached by descending from the heaviest subtree without a landmark.
+ *
+ * @tparam Distance Type of the distances.
+ * @param graph The input graph.
+ * @param reverse Its transpose, e.g., adjacency<1> of the same edges, or the graph itself if it is symmetric.
+ * @param k The number of landmarks.
+ * @param selection How to place the landmarks.
+ * @param weight Function to compute edge weights, which must not be negative.
+ * @param seed The seed for the random roots.
+ * @return The landmark_table.
+ */
+template <class Distance, adjacency_list_graph Graph, class Reverse, class Weight = detail::first_attribute_weight>
+requires(!std::is_arithmetic_v<Reverse>) && adjacency_list_graph<Reverse>
+auto select_landmarks(const Graph& graph, const Reverse& reverse, std::size_t k, landmark_selection selection = landmark_selection::avoid,
+                      Weight weight = {}, unsigned seed = 0) {
+  using Id = vertex_id_t<Graph>;
+
+  constexpr Distance infinity  = std::numeric_limits<Distance>::max();
+  constexpr Id       none      = null_vertex_v<Id>();
+  const std::size_t  n         = num_vertices(graph);
+  const bool         symmetric = static_cast<const void*>(&graph) == static_cast<const void*>(&reverse);
+  const Distance     delta     = choose_delta<Distance>(graph, weight);
+
+  std::vector<Id>                    landmarks;
+  std::vector<std::vector<Distance>> from, to;
+  std::vector<char>                  is_landmark(n, false);
+  std::mt19937                       gen(seed);
+  std::uniform_int_distribution<Id>  random_vertex(0, n - 1);
+
+  auto add = [&](Id landmark) {
+    landmarks.push_back(landmark);
+    is_landmark[landmark] = true;
+    from.push_back(parallel_delta_stepping<Distance>(graph, landmark, delta, weight));
+    if (!symmetric) {
+      to.push_back(parallel_delta_stepping<Distance>(reverse, landmark, delta, weight));
+    }
+  };
+
+  // The vertex maximizing key among the ones that are not landmarks yet, where infinity is largest.
+  auto argmax = [&](auto&& key) {
+    Id       best       = none;
+    Distance best_value = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+      if (!is_landmark[v] && (best == none || best_value < key(v))) {
+        best       = v;
+        best_value = key(v);
+      }
+    }
+    return best;
+  };
+
+  if (selection == landmark_selection::farthest) {
+    auto              root = random_vertex(gen);
+    auto              dist = parallel_delta_stepping<Distance>(graph, root, delta, weight);
+    std::vector<Distance> closest(n, infinity);
+    for (Id next = argmax([&](Id v) { return dist[v]; }); landmarks.size() < std::min(k, n); next = argmax([&](Id v) { return closest[v]; })) {
+      add(next);
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+        for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+          closest[v] = std::min(closest[v], from.back()[v]);
+        }
+      });
+    }
+  } else {
+    detail::dijkstra_search<Distance, Id> search(n);
+    std::vector<Id>                       order, children_indices(n + 1), children(n);
+    std::vector<Distance>                 subtree(n);
+    std::vector<char>                     covered(n);
+
+    while (landmarks.size() < std::min(k, n)) {
+      // A shortest-path tree from a random root, with the vertices in the order they were settled.
+      Id root = random_vertex(gen);
+      order.clear();
+      search.start(root);
+      while (search.pending()) {
+        Id u = search.settle();
+        order.push_back(u);
+        search.scan(graph, u, weight);
+      }
+
+      std::fill(children_indices.begin(), children_indices.end(), 0);
+      for (auto v : order) {
+        if (v != root) {
+          ++children_indices[search.parent(v) + 1];
+        }
+      }
+      std::inclusive_scan(children_indices.begin(), children_indices.end(), children_indices.begin());
+      std::vector<Id> cursor(children_indices.begin(), children_indices.end() - 1);
+      for (auto v : order) {
+        if (v != root) {
+          children[cursor[search.parent(v)]++] = v;
+        }
+      }
+
+      // The size of a subtree is the sum of how badly the landmarks bound the distance of its vertices from the root, or zero if it
+      // holds a landmark.  Children are settled after their parents, so visit the vertices backward.
+      for (auto v = order.rbegin(); v != order.rend(); ++v) {
+        Distance bound = 0;
+        for (std::size_t i = 0; i < landmarks.size(); ++i) {
+          if (Distance fr = from[i][root], fv = from[i][*v]; fr != infinity && fv != infinity && fr < fv) {
+            bound = std::max(bound, Distance(fv - fr));
+          }
+          if (!symmetric) {
+            if (Distance tr = to[i][root], tv = to[i][*v]; tr != infinity && tv != infinity && tv < tr) {
+              bound = std::max(bound, Distance(tr - tv));
+            }
+          }
+        }
+        subtree[*v] = search.distance(*v) - std::min(bound, search.distance(*v));
+        covered[*v] = is_landmark[*v];
+        for (auto j = children_indices[*v]; j != children_indices[*v + 1]; ++j) {
+          subtree[*v] += subtree[children[j]];
+          covered[*v] |= covered[children[j]];
+        }
+        if (covered[*v]) {
+          subtree[*v] = 0;
+        }
+      }
+
+      Id next = *std::max_element(order.begin(), order.end(), [&](Id a, Id b) { return subtree[a] < subtree[b]; });
+      if (subtree[next] == 0) {
+        next = argmax([&](Id) { return Distance(0); });    // everything reachable is covered, so take any other vertex
+      } else {
+        for (Id u = none; u != next;) {
+          u = next;
+          for (auto j = children_indices[u]; j != children_indices[u + 1]; ++j) {
+            if (Id c = children[j]; subtree[c] > 0 && (next == u || subtree[next] < subtree[c])) {
+              next = c;
+            }
+          }
+        }
+      }
+      add(next);
+    }
+  }
+
+  return landmark_table<Distance, Id>(std::move(landmarks), from, to);
+}
+
+/**
+ * @brief Select landmarks of a symmetric graph and compute their distance tables.
+ *
+ * @tparam Distance Type of the distances.
+ * @param graph The input graph, which must be symmetric.
+ * @param k The number of landmarks.
+ * @param selection How to place the landmarks.
+ * @param weight Function to compute edge weights, which must not be negative.
+ * @param seed The seed for the random roots.
+ * @return The landmark_table.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+auto select_landmarks(const Graph& graph, std::size_t k, landmark_selection selection = landmark_selection::avoid, Weight weight = {},
+                      unsigned seed = 0) {
+  return select_landmarks<Distance>(graph, graph, k, selection, weight, seed);
+}
+
+/**
+ * @brief A reusable A* point-to-point query with landmark lower bounds (ALT).
+ *
+ * Each query keeps the few landmarks that give the best bound between its
+ * source and target, and settles vertices in the order of their distance
+ * plus the largest lower bound on their distance to the target, which is a
+ * feasible potential, so the first time the target is settled its distance
+ * is exact.  Like dijkstra_query, the arrays are allocated once and each
+ * query only resets what the previous one touched.
+ *
+ * @tparam Distance Type of the distances.
+ * @tparam Graph Type of the input graph.  Must meet the requirements of the adjacency_list_graph concept.
+ * @tparam Weight Type of function used to compute edge weights, the same as for the landmark table.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+class alt_query {
+  using vertex_id_type = vertex_id_t<Graph>;
+  using search_type    = detail::dijkstra_search<Distance, vertex_id_type>;
+  using table_type     = landmark_table<Distance, vertex_id_type>;
+
+  const Graph&             graph_;
+  const table_type&        table_;
+  Weight                   weight_;
+  std::size_t              max_active_;
+  std::vector<std::size_t> active_;
+  search_type              search_;
+
+public:
+  static constexpr Distance       infinity = search_type::infinity;
+  static constexpr vertex_id_type none     = search_type::none;
+
+  /// @param graph The graph.
+  /// @param table Its landmark table, which must outlive the query.
+  /// @param weight Function to compute the weight of an edge.
+  /// @param max_active The number of landmarks used by a query.
+  alt_query(const Graph& graph, const table_type& table, Weight weight = {}, std::size_t max_active = 4)
+      : graph_(graph), table_(table), weight_(weight), max_active_(max_active), search_(num_vertices(graph)) {}
+
+  /// The length of a shortest path from source to target, or infinity if there is none.
+  Distance query(vertex_id_type source, vertex_id_type target) {
+    active_.resize(table_.size());
+    std::iota(active_.begin(), active_.end(), 0);
+    auto count = std::min(max_active_, active_.size());
+    std::partial_sort(active_.begin(), active_.begin() + count, active_.end(), [&](std::size_t i, std::size_t j) {
+      return table_.lower_bound(source, target, j) < table_.lower_bound(source, target, i);
+    });
+    active_.resize(count);
+
+    auto potential = [&](vertex_id_type v) {
+      Distance bound = 0;
+      for (auto i : active_) {
+        bound = std::max(bound, table_.lower_bound(v, target, i));
+      }
+      return bound;
+    };
+
+    search_.start(source, potential);
+    while (search_.pending()) {
+      auto u = search_.settle();
+      if (u == target) {
+        break;
+      }
+      search_.scan(graph_, u, weight_, potential, [](vertex_id_type, Distance) {});
+    }
+    return search_.distance(target);
+  }
+
+  /// A shortest path from the last source to its target, or an empty path if the target was not reached.
+  std::vector<vertex_id_type> path(vertex_id_type v) const { return search_.path_to(v); }
+
+  /// The number of vertices settled by the last query.
+  std::size_t settled() const { return search_.settled(); }
+};
+
+/**
+ * @brief Create a reusable ALT query.
+ *
+ * @tparam Distance Type of the distances.
+ * @param graph The input graph, which must outlive the query.
+ * @param table The landmark table of the graph, e.g., from select_landmarks, which must outlive the query.
+ * @param weight Function to compute edge weights [default: the first attribute of the edge].
+ * @param max_active The number of landmarks used by a query.
+ * @return An alt_query.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+auto make_alt_query(const Graph& graph, const landmark_table<Distance, vertex_id_t<Graph>>& table, Weight weight = {},
+                    std::size_t max_active = 4) {
+  return alt_query<Distance, Graph, Weight>(graph, table, weight, max_active);
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_ALT_HPP
@@ -21,11 +21,14 @@
 #include "nwgraph/adaptors/worklist.hpp"
 #include "nwgraph/util/AtomicBitVector.hpp"
 #include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/frontier.hpp"
 #include "nwgraph/util/parallel_for.hpp"
 #include "nwgraph/util/util.hpp"
 #include "nwgraph/adaptors/vertex_range.hpp"
 
 #include <algorithm>
+#include <bit>
+#include <cstdint>
 
 #if defined(CL_SYCL_LANGUAGE_VERSION)
 #include <dpstd/algorithm>
@@ -50,8 +53,10 @@
 #include <utility>
 
 #include <tbb/concurrent_queue.h>
-#include <tbb/concurrent_vector.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 #include <tbb/parallel_for_each.h>
+#include <tbb/task_arena.h>
 
 namespace nw {
 namespace graph {
@@ -196,127 +201,186 @@ std::vector<score_t> brandes_bc(const Graph& G, bool normalize = true) {
   return centrality;
 }
 
+namespace detail {
+
+/// The largest number of sources that brandes_bc searches from at once, one
+/// bit each, and its default batch width.
+inline constexpr std::size_t bc_batch_width = 64;
+
+/// Scratch space for one batch of brandes_bc sources.
+///
+/// Per-source state is stored in rows of `width` entries per vertex, so the
+/// space is proportional to the batch width, not to the number of sources.  A
+/// batch only touches the rows of the vertices in its queue, so those are the
+/// only ones reset afterwards.
+template <class vertex_id_type, class score_t, class accum_t>
+struct bc_batch {
+  bc_batch(std::size_t N, std::size_t width)
+      : seen(N), frontier(N), next(N), levels(N * width, null_vertex_v<vertex_id_type>()), path_counts(N * width),
+        deltas(N * width), queue(N * width) {}
+
+  std::vector<std::uint64_t>    seen;        //!< the sources that reached each vertex
+  std::vector<std::uint64_t>    frontier;    //!< the sources that reached each vertex in the current level
+  std::vector<std::uint64_t>    next;        //!< the sources that reach each vertex in the next level
+  std::vector<vertex_id_type>   levels;
+  std::vector<accum_t>          path_counts;
+  std::vector<score_t>          deltas;
+  sliding_queue<vertex_id_type> queue;       //!< one window per level, a vertex appears once per level it is reached at
+};
+
+}    // namespace detail
+
 /**
  * Parallel approximate betweenness centrality using Brandes algorithm @verbatim embed:rst:inline :cite:`brandes_bc`.@endverbatim
  * Rather than using all vertices in the graph to compute paths, the algorithm uses a
- * specified set of root nodes.  Parallelization is effected through C++ standard library
- * execution policies.
+ * specified set of root nodes.
+ *
+ * The sources are searched in batches of up to batch_width (at most 64), with
+ * one bit per source in the frontier of each vertex, so every level of a batch
+ * scans the edges of its frontier once for all of its sources.  The levels are
+ * built with the frontier engine of util/frontier.hpp, and the vertices of
+ * every level are processed in parallel in both the forward and the backward
+ * phase.  Memory use is proportional to the batch width times the number of
+ * vertices, no matter how many sources there are, and no edge-sized state is
+ * kept; a narrower batch trades edge scans for memory.  Every worker adds its
+ * dependencies to its own centrality vector, and these are summed at the end.
  *
  * @tparam Graph Type of the graph.  Must meet requirements of adjacency_list_graph concept.
  * @tparam score_t Type of the centrality scores computed for each vertex.
  * @tparam accum_t Type of path counts.
- * @tparam OuterExecutionPolicy Parallel execution policy type for outer loop of algorithm.  Default: std::execution::parallel_unsequenced_policy
- * @tparam InnerExecutionPolicy Parallel execution policy type for inner loop of algorithm.  Default: std::execution::parallel_unsequenced_policy
+ * @tparam OuterExecutionPolicy Parallel execution policy type for the final normalization.  Default: std::execution::parallel_unsequenced_policy
+ * @tparam InnerExecutionPolicy Parallel execution policy type for the loops over the vertices of a level.  Default: std::execution::parallel_unsequenced_policy
  * @param G Input graph.
  * @param normalize Flag indicating whether to normalize centrality scores relative to largest score.
  * @param sources Vector of starting sources.
- * @param outer_policy Outer loop parallel execution policy.
- * @param inner_policy Inner loop parallel execution policy.
- * @param threads Number of threads being used in computation.  Used to compute number of bins in computation.
+ * @param outer_policy Parallel execution policy for the final normalization.
+ * @param inner_policy Parallel execution policy for the loops over the vertices of a level.
+ * @param threads Number of threads, or 0 for the TBB default.
+ * @param batch_width Number of sources searched at once, clamped to [1, 64].
  * @return Vector of centrality for each vertex.
  */
 template <class score_t, class accum_t, adjacency_list_graph Graph, class OuterExecutionPolicy = std::execution::parallel_unsequenced_policy,
           class InnerExecutionPolicy = std::execution::parallel_unsequenced_policy>
 auto brandes_bc(const Graph& graph, const std::vector<typename Graph::vertex_id_type>& sources, int threads,
-                OuterExecutionPolicy&& outer_policy = {}, InnerExecutionPolicy&& inner_policy = {}, bool normalize = true) {
+                OuterExecutionPolicy&& outer_policy = {}, InnerExecutionPolicy&& inner_policy = {}, bool normalize = true,
+                std::size_t batch_width = detail::bc_batch_width) {
   using vertex_id_type = typename Graph::vertex_id_type;
 
-  vertex_id_type       N     = num_vertices(graph);
-  size_t               M     = graph.to_be_indexed_.size();
-  auto&&               edges = std::get<0>(*(graph[0]).begin());
+  constexpr const auto infinity = null_vertex_v<vertex_id_type>();
+
+  const std::size_t    N = num_vertices(graph);
+  const std::size_t    W = std::clamp(std::min(batch_width, sources.size()), std::size_t(1), detail::bc_batch_width);
   std::vector<score_t> bc(N);
 
-  const vertex_id_type num_bins = nw::graph::pow2(nw::graph::ceil_log2(threads));
-  const vertex_id_type bin_mask = num_bins - 1;
-
-  std::vector<std::future<void>> futures(sources.size());
-  for (size_t s_idx = 0; s_idx < sources.size(); ++s_idx) {
-    futures[s_idx] = std::async(
-        std::launch::async,
-        [&](vertex_id_type root) {
-          std::vector<vertex_id_type> levels(N);
-          nw::graph::AtomicBitVector  succ(M);
-
-          // Initialize the levels to infinity.
-          std::fill(outer_policy, levels.begin(), levels.end(), std::numeric_limits<vertex_id_type>::max());
-
-          std::vector<accum_t>                                             path_counts(N);
-          std::vector<tbb::concurrent_vector<vertex_id_type>>              q1(num_bins);
-          std::vector<tbb::concurrent_vector<vertex_id_type>>              q2(num_bins);
-          std::vector<std::vector<tbb::concurrent_vector<vertex_id_type>>> retired;
-
-          vertex_id_type lvl = 0;
-
-          path_counts[root] = 1;
-          q1[0].push_back(root);
-          levels[root] = lvl++;
-
-          bool done = false;
-          while (!done) {
-            std::for_each(outer_policy, q1.begin(), q1.end(), [&](auto&& q) {
-              std::for_each(inner_policy, q.begin(), q.end(), [&](auto&& u) {
-                for (auto&& elt : graph[u]) {
-                  auto&&   v        = target(graph, elt);
-                  auto&& infinity = std::numeric_limits<vertex_id_type>::max();
-                  auto&& lvl_v    = nw::graph::acquire(levels[v]);
-
-                  // If this is our first encounter with this node, or
-                  // it's on the right level, then propagate the counts
-                  // from u to v, and mark the edge from u to v as used.
-                  if (lvl_v == infinity || lvl_v == lvl) {
-                    nw::graph::fetch_add(path_counts[v], nw::graph::acquire(path_counts[u]));
-                    succ.atomic_set(&v - &edges);    // edge(w,v) : P[w][v]
-                  }
-
-                  // We need to add v to the frontier exactly once the
-                  // first time we encounter it, so we race to set its
-                  // level and if we win that race we can be the one to
-                  // add it.
-                  if (lvl_v == infinity && nw::graph::cas(levels[v], infinity, lvl)) {
-                    q2[u & bin_mask].push_back(v);
-                  }
-                }
-              });
-            });
+  tbb::enumerable_thread_specific<std::vector<score_t>> local_bc([N] { return std::vector<score_t>(N); });
 
-            done = true;
-            for (size_t i = 0; i < num_bins; ++i) {
-              if (q2[i].size() != 0) {
-                done = false;
-                break;
-              }
-            }
+  detail::bc_batch<vertex_id_type, score_t, accum_t> batch(N, W);
+  auto&& [seen, frontier, next, levels, path_counts, deltas, queue] = batch;
+  auto buffers = make_frontier_buffers(batch.queue);
 
-            retired.emplace_back(num_bins);
-            std::swap(q1, retired.back());
-            std::swap(q1, q2);
+  // Call f on the bits of a mask, i.e., on the sources it holds.
+  auto for_each_bit = [](std::uint64_t mask, auto&& f) {
+    for (; mask; mask &= mask - 1) {
+      f(std::countr_zero(mask));
+    }
+  };
+
+  tbb::task_arena pool(threads > 0 ? threads : tbb::task_arena::automatic);
+  pool.execute([&] {
+    for (std::size_t first = 0; first < sources.size(); first += W) {
+      const std::size_t n = std::min(W, sources.size() - first);
+
+      queue.reset();
+      for (std::size_t b = 0; b < n; ++b) {
+        vertex_id_type root = sources[first + b];
+        if (frontier[root] == 0) {
+          queue.push_back(root);
+        }
+        frontier[root] |= std::uint64_t(1) << b;
+        seen[root] |= std::uint64_t(1) << b;
+        levels[root * W + b]      = 0;
+        path_counts[root * W + b] = 1;
+      }
+      queue.slide_window();
+
+      // Count the shortest paths from all of the sources, one level per
+      // window.  The sources that first reach v through u are the ones in the
+      // frontier of u that have not seen v, and seen only changes between
+      // levels.
+      for (vertex_id_type lvl = 1; !queue.empty(); ++lvl) {
+        std::for_each(inner_policy, queue.begin(), queue.end(), [&](auto&& u) {
+          auto&& local = buffers.local();
+          for (auto&& elt : graph[u]) {
+            auto          v     = target(graph, elt);
+            std::uint64_t reached = frontier[u] & ~seen[v];
+            if (reached == 0) {
+              continue;
+            }
+            if (nw::graph::fetch_or(next[v], reached) == 0) {
+              local.push_back(v);
+            }
+            for_each_bit(reached, [&](int b) { nw::graph::fetch_add(path_counts[v * W + b], path_counts[u * W + b]); });
+          }
+        });
+        queue.flush(buffers);
+        queue.slide_window();
+
+        std::for_each(inner_policy, queue.begin(), queue.end(), [&](auto&& v) {
+          frontier[v] = std::exchange(next[v], 0);
+          seen[v] |= frontier[v];
+          for_each_bit(frontier[v], [&](int b) { levels[v * W + b] = lvl; });
+        });
+      }
 
-            ++lvl;
+      // Accumulate the dependencies, deepest level first.  A vertex appears
+      // once per window, so every update of its delta and score in a window
+      // comes from the same task.
+      for (std::size_t i = queue.num_windows(); i-- != 0;) {
+        auto&& window = queue.window(i);
+        std::for_each(inner_policy, window.begin(), window.end(), [&](auto&& u) {
+          auto&&        local = local_bc.local();
+          std::uint64_t mask  = 0;
+          for (std::size_t b = 0; b < n; ++b) {
+            mask |= std::uint64_t(levels[u * W + b] == i) << b;
           }
 
-          std::vector<score_t> deltas(N);
-
-          std::for_each(retired.rbegin(), retired.rend(), [&](auto&& vvv) {
-            std::for_each(outer_policy, vvv.begin(), vvv.end(), [&](auto&& vv) {
-              std::for_each(inner_policy, vv.begin(), vv.end(), [&](auto&& u) {
-                score_t delta = 0;
-                for (auto&& elt : graph[u]) {
-                  auto&& v = target(graph, elt);
-                  if (succ.get(&v - &edges)) {
-                    delta += path_counts[u] / path_counts[v] * (1.0f + deltas[v]);
-                  }
-                }
-                nw::graph::fetch_add(bc[u], deltas[u] = delta);
-              });
+          score_t delta[detail::bc_batch_width] = {};
+          for (auto&& elt : graph[u]) {
+            auto v = target(graph, elt);
+            for_each_bit(mask, [&](int b) {
+              if (levels[v * W + b] == i + 1) {
+                delta[b] += static_cast<score_t>(path_counts[u * W + b]) / static_cast<score_t>(path_counts[v * W + b]) * (1 + deltas[v * W + b]);
+              }
             });
+          }
+          for_each_bit(mask, [&](int b) {
+            deltas[u * W + b] = delta[b];
+            local[u] += delta[b];
           });
-        },
-        sources[s_idx]);
-  }
+        });
+      }
 
-  for (auto&& f : futures) {
-    f.wait();
-  }
+      for (std::size_t i = 0; i < queue.num_windows(); ++i) {
+        auto&& window = queue.window(i);
+        std::for_each(inner_policy, window.begin(), window.end(), [&](auto&& u) {
+          seen[u] = frontier[u] = 0;
+          for (std::size_t b = 0; b < W; ++b) {
+            levels[u * W + b]      = infinity;
+            path_counts[u * W + b] = 0;
+            deltas[u * W + b]      = 0;
+          }
+        });
+      }
+    }
+
+    tbb::parallel_for(tbb::blocked_range(std::size_t(0), N), [&](auto&& r) {
+      for (auto&& local : local_bc) {
+        for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+          bc[u] += local[u];
+        }
+      }
+    });
+  });
 
   if (normalize) {
     auto max = std::reduce(outer_policy, bc.begin(), bc.end(), 0.0f, nw::graph::max{});
@@ -340,13 +404,15 @@ auto brandes_bc(const Graph& graph, const std::vector<typename Graph::vertex_id_
  * @param normalize Flag indicating whether to normalize centrality scores relative to largest score.
  * @param outer_policy Outer loop parallel execution policy.
  * @param inner_policy Inner loop parallel execution policy.
- * @param threads Number of threads being used in computation.  Used to compute number of bins in computation.
+ * @param threads Number of workers, or 0 for the TBB default.
+ * @param batch_width Number of sources searched at once, clamped to [1, 64].
  * @return Vector of centrality for each vertex.
  */
 template <class score_t, class accum_t, adjacency_list_graph Graph, class OuterExecutionPolicy = std::execution::parallel_unsequenced_policy,
           class InnerExecutionPolicy = std::execution::parallel_unsequenced_policy>
 auto exact_brandes_bc(const Graph& graph, int threads,
-                OuterExecutionPolicy&& outer_policy = {}, InnerExecutionPolicy&& inner_policy = {}, bool normalize = true) {
+                OuterExecutionPolicy&& outer_policy = {}, InnerExecutionPolicy&& inner_policy = {}, bool normalize = true,
+                std::size_t batch_width = detail::bc_batch_width) {
   using vertex_id_type = typename Graph::vertex_id_type;
   vertex_id_type       N     = num_vertices(graph);
   std::vector<vertex_id_type> sources(N);
@@ -358,7 +424,7 @@ auto exact_brandes_bc(const Graph& graph, int threads,
   accum_t, 
   Graph, 
   OuterExecutionPolicy, 
-  InnerExecutionPolicy>(graph, sources, threads, std::forward<OuterExecutionPolicy>(outer_policy), std::forward<InnerExecutionPolicy>(inner_policy), normalize);
+  InnerExecutionPolicy>(graph, sources, threads, std::forward<OuterExecutionPolicy>(outer_policy), std::forward<InnerExecutionPolicy>(inner_policy), normalize, batch_width);
 }
 
 }    // namespace graph
@@ -21,14 +21,17 @@
 #include "nwgraph/graph_traits.hpp"
 #include "nwgraph/util/AtomicBitVector.hpp"
 #include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/frontier.hpp"
 #include "nwgraph/util/parallel_for.hpp"
 #include "nwgraph/adaptors/neighbor_range.hpp"
 #include "nwgraph/adaptors/cyclic_range_adaptor.hpp"
 #include "nwgraph/adaptors/vertex_range.hpp"
+#include <bit>
+#include <concepts>
 #include <queue>
+#include <span>
 
 #include <tbb/concurrent_queue.h>
-#include <tbb/concurrent_vector.h>
 #include <tbb/parallel_for_each.h>
 
 /**
@@ -147,30 +150,34 @@ auto bfs(const Graph& graph, vertex_id_t<Graph> root) {
  * access the out edges of each vertex as well as the in edges of each vertex.  These are passed into the graph 
  * as two adajacency lists.
  *
+ * Top-down steps append the next frontier to a preallocated sliding_queue through
+ * thread-local buffers, bottom-up steps work on dense bitmaps of the frontier.
+ *
  * @tparam OutGraph Type of graph containing out edges.  Must meet the requirements of adjacency_list_graph concept.
  * @tparam InGraph Type of graph containing in edges.  Must meet the requirements of adjacency_list_graph concept.
  * @param out_graph The graph to be searched, representing out edges.
  * @param in_graph The transpose of the graph to be searched, representing in edges.
  * @param root The starting vertex.
- * @param num_bins Number of bins.
+ * @param num_bins Deprecated and ignored, since the frontier has no bins; kept so positional calls keep their meaning.
  * @param alpha Algorithm parameter.
  * @param beta Algorithm parameter.
+ * @param trace If not null, receives a frontier_level record for each step.
  * @return The parent list.
  */
 template <adjacency_list_graph OutGraph, adjacency_list_graph InGraph>
-[[gnu::noinline]] auto bfs(const OutGraph& out_graph, const InGraph& in_graph, vertex_id_t<OutGraph> root, int num_bins = 32, int alpha = 15,
-                           int beta = 18) {
+[[gnu::noinline]] auto bfs(const OutGraph& out_graph, const InGraph& in_graph, vertex_id_t<OutGraph> root, int /* num_bins */ = 32,
+                           int alpha = 15, int beta = 18, std::vector<frontier_level>* trace = nullptr) {
 
   using vertex_id_type = vertex_id_t<OutGraph>;
 
-  const std::size_t                                   n = nw::graph::pow2(nw::graph::ceil_log2(num_bins));
-  const std::size_t                                   N = num_vertices(out_graph);
-  const std::size_t                                   M = out_graph.to_be_indexed_.size();
-  std::vector<tbb::concurrent_vector<vertex_id_type>> q1(n), q2(n);
+  const std::size_t N = num_vertices(out_graph);
+  const std::size_t M = out_graph.num_edges();
 
-  std::vector<vertex_id_type> parents(N);
-  nw::graph::AtomicBitVector  front(N, false);
-  nw::graph::AtomicBitVector  curr(N);
+  std::vector<vertex_id_type>   parents(N);
+  nw::graph::AtomicBitVector    front(N, false);
+  nw::graph::AtomicBitVector    curr(N);
+  sliding_queue<vertex_id_type> queue(N);
+  auto                          buffers = make_frontier_buffers(queue);
 
   constexpr const auto null_vertex = null_vertex_v<vertex_id_type>();
   std::fill(std::execution::par_unseq, parents.begin(), parents.end(), null_vertex);
@@ -179,30 +186,18 @@ template <adjacency_list_graph OutGraph, adjacency_list_graph InGraph>
   std::uint64_t scout_count    = out_graph[root].size();
 
   parents[root] = root;
-  q1[root % n].push_back(root);
+  queue.push_back(root);
+  queue.slide_window();
 
-  bool done = false;
-  while (!done) {
+  while (!queue.empty()) {
     if (scout_count > edges_to_check / alpha) {
-      std::size_t awake_count = 0;
-      // Initialize the frontier bitmap from the frontier queues, and count the
-      // number of non-zeros.
-      /*
-      std::size_t awake_count = nw::graph::parallel_for(
-          tbb::blocked_range(0ul, q1.size()),
-          [&](auto&& i) {
-            auto&& q = q1[i];
-            std::for_each(q.begin(), q.end(), [&](auto&& u) { curr.atomic_set(u); });
-            return q.size();
-          }, std::plus{}, 0ul);
-      */
-      std::for_each(std::execution::par_unseq, q1.begin(), q1.end(), [&](auto&& q) {
-        nw::graph::fetch_add(awake_count, q.size());
-        std::for_each(std::execution::par_unseq, q.begin(), q.end(), [&](auto&& u) { curr.atomic_set(u); });
-      });
+      curr.clear();
+      queue_to_bitmap(queue, curr);
 
+      std::size_t awake_count     = queue.size();
       std::size_t old_awake_count = 0;
       do {
+        frontier_level_timer _(trace, awake_count, true);
         old_awake_count = awake_count;
         std::swap(front, curr);
         curr.clear();
@@ -228,86 +223,136 @@ template <adjacency_list_graph OutGraph, adjacency_list_graph InGraph>
             std::plus{});
       } while ((awake_count >= old_awake_count) || (awake_count > N / beta));
 
-      if (awake_count == 0) {
-        return parents;
-      }
-
-      tbb::parallel_for(curr.non_zeros(nw::graph::pow2(15)), [&](auto&& range) {
-        for (auto &&i = range.begin(), e = range.end(); i != e; ++i) {
-          q2[*i % n].push_back(*i);
-        }
-      });
-
+      bitmap_to_queue(curr, queue);
+      queue.slide_window();
       scout_count = 1;
     } else {
+      frontier_level_timer _(trace, queue.size(), false);
       edges_to_check -= scout_count;
-      /*
-      scout_count = nw::graph::parallel_for(
-          tbb::blocked_range(0ul, q1.size()),
-          [&](auto&& i) {
-            auto&& q = q1[i];
-            return nw::graph::parallel_for(
-                tbb::blocked_range(0ul, q.size()),
-                [&](auto&& i) {
-                  auto&& u = q[i];
-                  return nw::graph::parallel_for(
-                      out_graph[u],
-                      [&](auto&& v) {
-                        auto curr_val = parents[v];
-                        if (null_vertex == curr_val) {
-                          if (nw::graph::cas(parents[v], curr_val, u)) {
-                            q2[u % n].push_back(v);
-                            return out_graph[v].size();
-                          }
-                        }
-                        return 0ul;
-                      },
-                      std::plus{}, 0ul);
-                },
-                std::plus{}, 0ul);
-          },
-          std::plus{}, 0ul);
-          */
-      scout_count = nw::graph::parallel_reduce(
-          tbb::blocked_range(0ul, q1.size()),
-          [&](auto&& i) {
-            auto&& q = q1[i];
-            return nw::graph::parallel_reduce(
-                tbb::blocked_range(0ul, q.size()),
-                [&](auto&& i) {
-                  size_t count = 0;
-                  auto&& u     = q[i];
-                  for (auto&& elt : out_graph[u]) {
-                    auto v        = target(out_graph, elt);
-                    auto curr_val = parents[v];
-                    if (null_vertex == curr_val) {
-                      if (nw::graph::cas(parents[v], curr_val, u)) {
-                        q2[u % n].push_back(v);
-                        count += out_graph[v].size();
-                      }
-                    }
+
+      scout_count = tbb::parallel_reduce(
+          tbb::blocked_range(queue.begin(), queue.end()), 0ul,
+          [&](auto&& range, auto count) {
+            auto&& local = buffers.local();
+            for (auto&& u : range) {
+              for (auto&& elt : out_graph[u]) {
+                auto v        = target(out_graph, elt);
+                auto curr_val = parents[v];
+                if (null_vertex == curr_val) {
+                  if (nw::graph::cas(parents[v], curr_val, u)) {
+                    local.push_back(v);
+                    count += out_graph[v].size();
                   }
-                  return count;
-                },
-                std::plus{}, 0ul);
+                }
+              }
+            }
+            return count;
           },
-          std::plus{}, 0ul);
+          std::plus{});
+
+      queue.flush(buffers);
+      queue.slide_window();
     }
+  }
+
+  return parents;
+}
 
-    done = true;
-    for (auto&& q : q2) {
-      if (q.size() != 0) {
-        done = false;
+/**
+ * @brief Multi-source Breadth-First Search.
+ *
+ * Perform a batch of breadth-first searches of a graph, one from each of the given roots,
+ * sharing the edge scans between searches as in MS-BFS @verbatim embed:rst:inline :cite:`Then-MSBFS`.@endverbatim
+ * Each vertex keeps one bit per search in a Word for the searches that have seen it, that have it
+ * in their current frontier, and that reach it in the next level, so a single pass over the edges
+ * advances all of the searches of a batch at once.  Roots are processed in batches of as many
+ * searches as Word has bits.
+ *
+ * @tparam Word Unsigned integer type holding the bits of a batch.
+ * @tparam Graph Type of the input graph. Must meet the requirements of the adjacency_list_graph concept.
+ * @param graph The graph to be searched.
+ * @param roots The starting vertices, one per search.
+ * @return The levels and the parents of the searches, indexed by search and then by vertex.
+ *         Vertices not reached by a search have level and parent null_vertex_v.
+ */
+template <std::unsigned_integral Word = std::uint64_t, adjacency_list_graph Graph>
+auto multi_source_bfs(const Graph& graph, std::span<const vertex_id_t<Graph>> roots) {
+  using vertex_id_type = vertex_id_t<Graph>;
+
+  constexpr const std::size_t batch       = std::numeric_limits<Word>::digits;
+  constexpr const auto        null_vertex = null_vertex_v<vertex_id_type>();
+
+  const std::size_t N = num_vertices(graph);
+
+  std::vector<std::vector<vertex_id_type>> levels(roots.size()), parents(roots.size());
+  std::vector<Word>                        seen(N), visit(N), next(N);
+
+  for (std::size_t first = 0; first < roots.size(); first += batch) {
+    const std::size_t k = std::min(batch, roots.size() - first);
+
+    std::fill(std::execution::par_unseq, seen.begin(), seen.end(), Word(0));
+    std::fill(std::execution::par_unseq, visit.begin(), visit.end(), Word(0));
+    std::fill(std::execution::par_unseq, next.begin(), next.end(), Word(0));
+
+    for (std::size_t i = 0; i < k; ++i) {
+      auto root = roots[first + i];
+      levels[first + i].assign(N, null_vertex);
+      parents[first + i].assign(N, null_vertex);
+      levels[first + i][root]  = 0;
+      parents[first + i][root] = root;
+      seen[root] |= Word(1) << i;
+      visit[root] |= Word(1) << i;
+    }
+
+    // Calls f(i) for each search i whose bit is set in w.
+    auto for_each_bit = [](Word w, auto&& f) {
+      for (; w; w &= w - 1) {
+        f(std::countr_zero(w));
+      }
+    };
+
+    for (vertex_id_type lvl = 1;; ++lvl) {
+      // Expand every frontier.  The search that sets a bit of next first is
+      // the one that found the vertex, and records the parent.
+      tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& range) {
+        for (auto &&u = range.begin(), e = range.end(); u != e; ++u) {
+          if (Word w = visit[u]) {
+            for (auto&& elt : graph[u]) {
+              auto v = target(graph, elt);
+              if (Word d = w & ~seen[v]; d && (nw::graph::relaxed(next[v]) & d) != d) {
+                Word won = d & ~nw::graph::fetch_or(next[v], d);
+                for_each_bit(won, [&](auto i) { parents[first + i][v] = u; });
+              }
+            }
+          }
+        }
+      });
+
+      // Make the next frontiers current.
+      Word active = tbb::parallel_reduce(
+          tbb::blocked_range(0ul, N), Word(0),
+          [&](auto&& range, Word any) {
+            for (auto &&v = range.begin(), e = range.end(); v != e; ++v) {
+              Word w   = next[v];
+              visit[v] = w;
+              if (w) {
+                next[v] = 0;
+                seen[v] |= w;
+                for_each_bit(w, [&](auto i) { levels[first + i][v] = lvl; });
+                any |= w;
+              }
+            }
+            return any;
+          },
+          std::bit_or{});
+
+      if (!active) {
         break;
       }
     }
-    std::swap(q1, q2);
-    for (auto&& q : q2) {
-      q.clear();
-    }
   }
 
-  return parents;
+  return std::tuple(std::move(levels), std::move(parents));
 }
 
 }    // namespace graph
@@ -20,6 +20,7 @@
 #include "nwgraph/adaptors/edge_range.hpp"
 #include "nwgraph/adaptors/vertex_range.hpp"
 #include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/disjoint_set.hpp"
 #include <iostream>
 #include <random>
 #include <unordered_map>
@@ -231,6 +232,30 @@ static auto afforest(Execution& exec, const Graph1& graph, const Graph2& t_graph
   return comp;
 }
 
+/**
+ * @brief Connected components with a concurrent union-find.  Every edge
+ * unites the sets of its endpoints in one pass over the graph, with no
+ * rounds and no transpose, so it also suits graphs given as a stream of
+ * edges (see disjoint_set::batch_union).
+ *
+ * @tparam Execution execution policy type.
+ * @tparam Graph Type of input graph.  Must meet requirements of adjacency_list_graph concept.
+ * @param exec Parallel execution policy.
+ * @param graph Input graph, directed or symmetric.
+ * @return Vector of component labelings, the smallest vertex of every component.
+ */
+template <typename Execution, adjacency_list_graph Graph>
+auto union_find_components(Execution& exec, const Graph& graph) {
+  using vertex_id_type = vertex_id_t<Graph>;
+  disjoint_set<vertex_id_type> sets(num_vertices(graph));
+  std::for_each(exec, counting_iterator(0ul), counting_iterator(sets.size()), [&](vertex_id_type u) {
+    for (auto&& elt : graph[u]) {
+      sets.unite(u, target(graph, elt));
+    }
+  });
+  return sets.batch_find();
+}
+
 }    // namespace graph
 }    // namespace nw
 #endif    // CONNECTED_COMPONENT_HPP
@@ -0,0 +1,526 @@
+/**
+ * @file contraction_hierarchies.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_CONTRACTION_HIERARCHIES_HPP
+#define NW_GRAPH_CONTRACTION_HIERARCHIES_HPP
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/dijkstra.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/defaults.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+
+namespace nw {
+namespace graph {
+
+/**
+ * @brief A contraction hierarchy: the upward and downward graphs of a vertex order.
+ *
+ * Every vertex has a rank, and contracting the vertices in rank order adds
+ * shortcuts that preserve the distances among the ones left.  The upward
+ * graph holds, for every vertex, its edges (and shortcuts) to vertices of
+ * higher rank; the downward graph holds the edges from vertices of higher
+ * rank into it, reversed.  A shortest path has a highest vertex, so it is
+ * found by a search in the upward graph from the source and one in the
+ * downward graph from the target, which both only climb.
+ *
+ * @tparam Distance Type of the distances.
+ * @tparam Id Type of the vertex ids.
+ */
+template <class Distance, std::unsigned_integral Id = default_vertex_id_type>
+class contraction_hierarchy {
+public:
+  using graph_type = index_adjacency<0, default_index_t, Id, Distance>;
+
+private:
+  std::size_t     num_shortcuts_ = 0;
+  std::vector<Id> rank_;
+  graph_type      upward_;
+  graph_type      downward_;
+
+  template <class T>
+  static void write(std::ostream& out, const std::vector<T>& vs) {
+    std::size_t st_size = vs.size(), el_size = sizeof(T);
+    out.write(reinterpret_cast<const char*>(&st_size), sizeof(std::size_t));
+    out.write(reinterpret_cast<const char*>(&el_size), sizeof(std::size_t));
+    out.write(reinterpret_cast<const char*>(vs.data()), st_size * el_size);
+  }
+
+  template <class T>
+  static void read(std::istream& in, std::vector<T>& vs) {
+    std::size_t st_size = 0, el_size = 0;
+    in.read(reinterpret_cast<char*>(&st_size), sizeof(std::size_t));
+    in.read(reinterpret_cast<char*>(&el_size), sizeof(std::size_t));
+    if (el_size != sizeof(T)) {
+      throw std::runtime_error("contraction_hierarchy: file has " + std::to_string(el_size) + " byte entries but " +
+                               std::to_string(sizeof(T)) + " were expected");
+    }
+    vs.resize(st_size);
+    in.read(reinterpret_cast<char*>(vs.data()), st_size * el_size);
+  }
+
+public:
+  contraction_hierarchy() = default;
+
+  /// @param rank The rank of every vertex, a permutation of [0, n).
+  /// @param upward The edges of every vertex to vertices of higher rank.
+  /// @param downward The edges into every vertex from vertices of higher rank, reversed.
+  /// @param num_shortcuts The number of those edges that are shortcuts.
+  contraction_hierarchy(std::vector<Id> rank, graph_type upward, graph_type downward, std::size_t num_shortcuts)
+      : num_shortcuts_(num_shortcuts), rank_(std::move(rank)), upward_(std::move(upward)), downward_(std::move(downward)) {}
+
+  std::size_t       num_vertices() const { return rank_.size(); }
+  std::size_t       num_shortcuts() const { return num_shortcuts_; }
+  Id                rank(Id v) const { return rank_[v]; }
+  const graph_type& upward() const { return upward_; }
+  const graph_type& downward() const { return downward_; }
+
+  /**
+   * @brief Serialize the hierarchy into a binary stream, with the same layout as the graphs it holds.
+   *
+   * @param out The output ostream object.
+   */
+  void serialize(std::ostream& out) const {
+    out.write(reinterpret_cast<const char*>(&num_shortcuts_), sizeof(std::size_t));
+    write(out, rank_);
+    upward_.serialize(out);
+    downward_.serialize(out);
+  }
+
+  void serialize(const std::string& outfile_name) const {
+    std::ofstream out(outfile_name, std::ofstream::binary);
+    serialize(out);
+  }
+
+  /**
+   * @brief Deserialize the hierarchy from a binary stream.
+   *
+   * @param in The input istream object.
+   */
+  void deserialize(std::istream& in) {
+    in.read(reinterpret_cast<char*>(&num_shortcuts_), sizeof(std::size_t));
+    read(in, rank_);
+    upward_.deserialize(in);
+    downward_.deserialize(in);
+  }
+
+  void deserialize(const std::string& infile_name) {
+    std::ifstream in(infile_name, std::ifstream::binary);
+    deserialize(in);
+  }
+};
+
+namespace detail {
+
+/// Contracts the vertices of a graph, an independent set of them per round.
+///
+/// The graph left to contract is kept as lists of in and out arcs.  Every
+/// round picks the vertices whose priority is a strict local minimum, so no
+/// two of them are adjacent, and contracts all of them at once: for every
+/// in-arc (u, v) and out-arc (v, w) of a vertex v, a local search from u that
+/// avoids the vertices of the round looks for a witness path no longer than
+/// u -> v -> w, and the arc u -> w becomes a shortcut if there is none.  The
+/// arcs of v at that point are its edges in the hierarchy.  The priority of a
+/// vertex is its edge difference, the number of shortcuts its contraction
+/// adds minus the number of arcs it removes, plus the number of its
+/// neighbors already contracted, which spreads the contraction evenly.  Only
+/// the neighbors of a round need new priorities.
+template <class Distance, class Id>
+class hierarchy_builder {
+  using arc         = std::tuple<Id, Distance>;
+  using arcs        = std::vector<arc>;
+  using shortcut    = std::tuple<Id, Id, Distance>;
+  using search_type = dijkstra_search<Distance, Id>;
+
+  const std::size_t           n_;
+  const std::size_t           settle_limit_;
+  std::vector<arcs>           out_, in_;             // the arcs of the vertices left
+  std::vector<arcs>           upward_, downward_;    // the arcs of the contracted vertices
+  std::vector<char>           contracted_, in_round_;
+  std::vector<std::ptrdiff_t> priority_;
+  std::vector<Id>             deleted_;    // the number of neighbors contracted
+  std::vector<Id>             rank_;
+  std::size_t                 num_shortcuts_ = 0;
+
+  tbb::enumerable_thread_specific<search_type> searches_;
+
+  // Priorities are only estimates, so their witness searches stop sooner.
+  static constexpr std::size_t estimate_limit = 20;
+
+  // Add an arc to a list, or shorten the one already there.
+  static void add(arcs& list, Id v, Distance d) {
+    for (auto&& [w, x] : list) {
+      if (w == v) {
+        x = std::min(x, d);
+        return;
+      }
+    }
+    list.emplace_back(v, d);
+  }
+
+  // A strict total order on the vertices by priority, with ties broken by a scrambled id.
+  bool before(Id a, Id b) const {
+    auto scramble = [](Id v) { return Id(v * Id(2654435761u)); };
+    return priority_[a] < priority_[b] || (priority_[a] == priority_[b] && scramble(a) < scramble(b));
+  }
+
+  // Call f(u, w, d) for every shortcut u -> w of length d needed to contract v.
+  template <class F>
+  void simulate(Id v, search_type& search, std::size_t settle_limit, F&& f) {
+    for (auto&& [u, duv] : in_[v]) {
+      Distance    limit   = 0;
+      std::size_t targets = 0;
+      for (auto&& [w, dvw] : out_[v]) {
+        if (w != u) {
+          limit = std::max(limit, Distance(duv + dvw));
+          ++targets;
+        }
+      }
+      if (targets == 0) {
+        continue;
+      }
+
+      // The witness search, which is done once it settles every target and
+      // gives up once it settles settle_limit vertices.
+      search.start(u);
+      while (targets != 0 && search.pending() && search.settled() < settle_limit && !(limit < search.min_key())) {
+        Id x = search.settle();
+        if (x != u && std::any_of(out_[v].begin(), out_[v].end(), [x](auto&& a) { return std::get<0>(a) == x; })) {
+          --targets;
+        }
+        for (auto&& [y, dxy] : out_[x]) {
+          if (y != v && !in_round_[y]) {
+            search.label(y, search.distance(x) + dxy, x);
+          }
+        }
+      }
+
+      for (auto&& [w, dvw] : out_[v]) {
+        if (w != u && Distance(duv + dvw) < search.distance(w)) {
+          f(u, w, Distance(duv + dvw));
+        }
+      }
+    }
+  }
+
+  void update_priority(Id v, search_type& search) {
+    std::ptrdiff_t shortcuts = 0;
+    simulate(v, search, std::min(settle_limit_, estimate_limit), [&](Id, Id, Distance) { ++shortcuts; });
+    priority_[v] = shortcuts - std::ptrdiff_t(in_[v].size() + out_[v].size()) + std::ptrdiff_t(deleted_[v]);
+  }
+
+  // The arcs of every vertex as a graph.
+  static auto to_graph(const std::vector<arcs>& lists) {
+    using graph_type = typename contraction_hierarchy<Distance, Id>::graph_type;
+    using index_t    = typename graph_type::index_t;
+
+    std::vector<index_t> indices(lists.size() + 1, 0);
+    for (std::size_t v = 0; v < lists.size(); ++v) {
+      indices[v + 1] = indices[v] + lists[v].size();
+    }
+    std::vector<Id>       targets(indices.back());
+    std::vector<Distance> weights(indices.back());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, lists.size()), [&](auto&& r) {
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        auto i = indices[v];
+        for (auto&& [w, d] : lists[v]) {
+          targets[i]   = w;
+          weights[i++] = d;
+        }
+      }
+    });
+    return graph_type(std::move(indices), std::make_tuple(std::move(targets), std::move(weights)));
+  }
+
+  // Apply every shortcut to the list of its endpoint at position I, one list per task.
+  template <std::size_t I>
+  void apply(std::vector<shortcut>& shortcuts, std::vector<arcs>& lists) {
+    constexpr std::size_t J = 1 - I;
+    tbb::parallel_sort(shortcuts.begin(), shortcuts.end(), [](auto&& a, auto&& b) {
+      return std::tie(std::get<I>(a), std::get<J>(a), std::get<2>(a)) < std::tie(std::get<I>(b), std::get<J>(b), std::get<2>(b));
+    });
+    std::vector<std::size_t> starts;
+    for (std::size_t i = 0; i < shortcuts.size(); ++i) {
+      if (i == 0 || std::get<I>(shortcuts[i]) != std::get<I>(shortcuts[i - 1])) {
+        starts.push_back(i);
+      }
+    }
+    starts.push_back(shortcuts.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, starts.size() - 1), [&](auto&& r) {
+      for (auto g = r.begin(), e = r.end(); g != e; ++g) {
+        for (auto i = starts[g]; i < starts[g + 1]; ++i) {
+          add(lists[std::get<I>(shortcuts[i])], std::get<J>(shortcuts[i]), std::get<2>(shortcuts[i]));
+        }
+      }
+    });
+  }
+
+public:
+  template <class Graph, class Weight>
+  hierarchy_builder(const Graph& graph, Weight& weight, std::size_t settle_limit)
+      : n_(num_vertices(graph))
+      , settle_limit_(settle_limit)
+      , out_(n_)
+      , in_(n_)
+      , upward_(n_)
+      , downward_(n_)
+      , contracted_(n_, false)
+      , in_round_(n_, false)
+      , priority_(n_, 0)
+      , deleted_(n_, 0)
+      , rank_(n_)
+      , searches_([n = n_] { return search_type(n); }) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n_), [&](auto&& r) {
+      for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+        for (auto&& edge : graph[u]) {
+          if (Id v = target(graph, edge); v != u) {
+            add(out_[u], v, Distance(weight(edge)));
+          }
+        }
+      }
+    });
+    for (std::size_t u = 0; u < n_; ++u) {
+      for (auto&& [v, d] : out_[u]) {
+        in_[v].emplace_back(u, d);
+      }
+    }
+  }
+
+  contraction_hierarchy<Distance, Id> build() && {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n_), [&](auto&& r) {
+      auto& search = searches_.local();
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        update_priority(v, search);
+      }
+    });
+
+    std::vector<Id> remaining(n_), round, neighbors;
+    std::iota(remaining.begin(), remaining.end(), 0);
+    std::vector<char> selected(n_, false);
+
+    tbb::enumerable_thread_specific<std::vector<shortcut>> local_shortcuts;
+    tbb::enumerable_thread_specific<std::vector<Id>>       local_neighbors;
+
+    for (std::size_t next_rank = 0; !remaining.empty(); next_rank += round.size()) {
+      // The local minima of the priority form an independent set.
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, remaining.size()), [&](auto&& r) {
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          Id   v       = remaining[i];
+          auto minimum = [&](auto&& a) { return before(v, std::get<0>(a)); };
+          selected[v]  = std::all_of(out_[v].begin(), out_[v].end(), minimum) && std::all_of(in_[v].begin(), in_[v].end(), minimum);
+        }
+      });
+      round.clear();
+      std::copy_if(remaining.begin(), remaining.end(), std::back_inserter(round), [&](Id v) { return selected[v]; });
+      for (auto v : round) {
+        in_round_[v] = true;
+      }
+
+      // Contract the round, keeping the arcs of its vertices as their edges in the hierarchy.
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, round.size()), [&](auto&& r) {
+        auto& search    = searches_.local();
+        auto& shortcuts = local_shortcuts.local();
+        auto& touched   = local_neighbors.local();
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          Id v = round[i];
+          simulate(v, search, settle_limit_, [&](Id u, Id w, Distance d) { shortcuts.emplace_back(u, w, d); });
+          for (auto&& [u, d] : in_[v]) {
+            touched.push_back(u);
+          }
+          for (auto&& [w, d] : out_[v]) {
+            touched.push_back(w);
+          }
+          upward_[v]   = std::move(out_[v]);
+          downward_[v] = std::move(in_[v]);
+          out_[v]      = {};
+          in_[v]       = {};
+          rank_[v]     = next_rank + i;
+        }
+      });
+
+      std::vector<shortcut> shortcuts;
+      neighbors.clear();
+      for (auto&& s : local_shortcuts) {
+        shortcuts.insert(shortcuts.end(), s.begin(), s.end());
+        s.clear();
+      }
+      for (auto&& t : local_neighbors) {
+        neighbors.insert(neighbors.end(), t.begin(), t.end());
+        t.clear();
+      }
+      tbb::parallel_sort(neighbors.begin(), neighbors.end());
+      neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+      num_shortcuts_ += shortcuts.size();
+
+      for (auto v : round) {
+        in_round_[v]   = false;
+        contracted_[v] = true;
+      }
+
+      // Remove the round from the arcs of its neighbors, and add the shortcuts.
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, neighbors.size()), [&](auto&& r) {
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          Id   x    = neighbors[i];
+          auto gone = [&](auto&& a) { return contracted_[std::get<0>(a)]; };
+          deleted_[x] += std::erase_if(out_[x], gone) + std::erase_if(in_[x], gone);
+        }
+      });
+      apply<0>(shortcuts, out_);
+      apply<1>(shortcuts, in_);
+
+      std::erase_if(remaining, [&](Id v) { return contracted_[v]; });
+
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, neighbors.size()), [&](auto&& r) {
+        auto& search = searches_.local();
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          update_priority(neighbors[i], search);
+        }
+      });
+    }
+
+    return contraction_hierarchy<Distance, Id>(std::move(rank_), to_graph(upward_), to_graph(downward_), num_shortcuts_);
+  }
+};
+
+}    // namespace detail
+
+/**
+ * @brief Build a contraction hierarchy of a weighted graph.
+ *
+ * The vertices are ordered by edge difference and contracted in parallel
+ * rounds, each of which contracts the vertices whose priority is smaller
+ * than that of all their neighbors, and then recomputes the priorities of
+ * the neighbors.  The witness searches that decide which shortcuts are
+ * needed run in parallel, one thread-local search per thread, and stop after
+ * settle_limit vertices, which can only add unneeded shortcuts.  The ones
+ * that estimate priorities stop much sooner.
+ *
+ * @tparam Distance Type of the distances.
+ * @param graph The input graph, directed or symmetric.
+ * @param weight Function to compute edge weights, which must not be negative.
+ * @param settle_limit The number of vertices a witness search may settle.
+ * @return The contraction_hierarchy.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+auto build_contraction_hierarchy(const Graph& graph, Weight weight = {}, std::size_t settle_limit = 500) {
+  return detail::hierarchy_builder<Distance, vertex_id_t<Graph>>(graph, weight, settle_limit).build();
+}
+
+/**
+ * @brief A reusable point-to-point query on a contraction hierarchy.
+ *
+ * Searches upward from the source and downward from the target, always
+ * advancing the one with the smaller key, and stops a direction once its key
+ * reaches the shortest path found so far.  A vertex that is reached more
+ * cheaply through a higher vertex than its label says is stalled: its label
+ * cannot be exact, so its edges are not relaxed (stall-on-demand).
+ *
+ * @tparam Distance Type of the distances.
+ * @tparam Id Type of the vertex ids.
+ */
+template <class Distance, std::unsigned_integral Id = default_vertex_id_type>
+class contraction_hierarchy_query {
+  using hierarchy_type = contraction_hierarchy<Distance, Id>;
+  using graph_type     = typename hierarchy_type::graph_type;
+  using search_type    = detail::dijkstra_search<Distance, Id>;
+
+  const hierarchy_type&          hierarchy_;
+  detail::first_attribute_weight weight_;
+  search_type                    forward_;
+  search_type                    backward_;
+  Id                             meet_ = search_type::none;
+
+public:
+  static constexpr Distance infinity = search_type::infinity;
+  static constexpr Id       none     = search_type::none;
+
+  /// @param hierarchy The hierarchy, which must outlive the query.
+  explicit contraction_hierarchy_query(const hierarchy_type& hierarchy)
+      : hierarchy_(hierarchy), forward_(hierarchy.num_vertices()), backward_(hierarchy.num_vertices()) {}
+
+  /// The length of a shortest path from source to target, or infinity if there is none.
+  Distance query(Id source, Id target) {
+    forward_.start(source);
+    backward_.start(target);
+    Distance best = infinity;
+    meet_         = none;
+
+    auto step = [&](search_type& self, const graph_type& up, const graph_type& down, search_type& other) {
+      Id       u  = self.settle();
+      Distance du = self.distance(u);
+      if (Distance o = other.distance(u); o != infinity && du + o < best) {
+        best  = du + o;
+        meet_ = u;
+      }
+      for (auto&& [x, d] : down[u]) {
+        if (Distance dx = self.distance(x); dx != infinity && dx + d < du) {
+          return;
+        }
+      }
+      self.scan(up, u, weight_);
+    };
+
+    while (true) {
+      bool f = forward_.pending() && forward_.min_key() < best;
+      bool b = backward_.pending() && backward_.min_key() < best;
+      if (f && (!b || forward_.min_key() <= backward_.min_key())) {
+        step(forward_, hierarchy_.upward(), hierarchy_.downward(), backward_);
+      } else if (b) {
+        step(backward_, hierarchy_.downward(), hierarchy_.upward(), forward_);
+      } else {
+        break;
+      }
+    }
+    return best;
+  }
+
+  /// The highest vertex of the shortest path found by the last query, or none.
+  Id meeting_vertex() const { return meet_; }
+
+  /// The number of vertices settled by the last query, in both directions.
+  std::size_t settled() const { return forward_.settled() + backward_.settled(); }
+};
+
+/**
+ * @brief Create a reusable point-to-point query on a contraction hierarchy.
+ *
+ * @param hierarchy The hierarchy, e.g., from build_contraction_hierarchy, which must outlive the query.
+ * @return A contraction_hierarchy_query.
+ */
+template <class Distance, std::unsigned_integral Id>
+auto make_contraction_hierarchy_query(const contraction_hierarchy<Distance, Id>& hierarchy) {
+  return contraction_hierarchy_query<Distance, Id>(hierarchy);
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_CONTRACTION_HIERARCHIES_HPP
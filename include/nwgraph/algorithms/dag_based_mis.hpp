@@ -16,18 +16,35 @@
 #ifndef DAG_BASED_MIS_HPP
 #define DAG_BASED_MIS_HPP
 
-#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <numeric>
+#include <ranges>
+#include <span>
 #include <vector>
 
-#include "nwgraph/adaptors/dag_range.hpp"
-#include "nwgraph/adaptors/edge_range.hpp"
-#include "nwgraph/adaptors/plain_range.hpp"
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+#include "nwgraph/algorithms/maximal_independent_set.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/atomic.hpp"
 
 namespace nw {
 namespace graph {
 
 /**
- * Compute maximal independent set, using DAG adaptor.
+ * Compute maximal independent set, using a DAG of the vertices.
+ *
+ * The vertices are ordered by decreasing degree, ties by increasing id, and
+ * every edge of A is oriented from its earlier to its later endpoint.  The
+ * result is the maximal independent set that a greedy sweep in that order
+ * would find, i.e., the roots of the DAG and every vertex none of whose
+ * predecessors is in the set.  The DAG is built from the rows of A in
+ * parallel, as flat predecessor and successor arrays without the duplicates a
+ * symmetric A would give, and the set is computed by the same kernel as
+ * luby_mis().
  *
  * @tparam Graph Type of the input graph.  Must meet requirements of adjacency_list_graph concept.
  * @param A The input graph.
@@ -35,64 +52,70 @@ namespace graph {
  */
 template <adjacency_list_graph Graph>
 void dag_based_mis(Graph& A, std::vector<bool>& mis) {
-  size_t N = A.size();
-#ifdef PRINT_DEBUG
-  std::cout << "size: " << N << std::endl;
-#endif
+  const std::size_t N = A.size();
 
-  std::vector<size_t> degrees(N, 0);
-  // std::vector<size_t> colors(N, std::numeric_limits<std::uint32_t>::max());
+  std::vector<std::size_t> degrees(N);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, N), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      degrees[u] = std::ranges::distance(A[u]);
+    }
+  });
+  auto before = [&](std::size_t u, std::size_t v) { return degrees[u] > degrees[v] || (degrees[u] == degrees[v] && u < v); };
 
-  std::vector<std::vector<size_t>> predecessor_list(N);
-  std::vector<std::vector<size_t>> successor_list(N);
-  std::vector<size_t>              degree_list(N, 0);
-  /*Need a "Degree range"*/
-  for (auto&& [v, deg] : plain_degree_range(A)) {
-#ifdef PRINT_DEBUG
-    std::cout << "v: " << v + 1 << " deg: " << deg << std::endl;
-#endif
-    degrees[v] = deg;
-  }
+  // Visit every arc u -> v of the DAG, once per edge of A that gives it.
+  auto for_each_arc = [&](auto&& f) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, N), [&](auto&& r) {
+      for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+        for (auto&& edge : A[u]) {
+          if (std::size_t v = target(A, edge); v != u) {
+            if (before(u, v)) {
+              f(u, v);
+            } else {
+              f(v, u);
+            }
+          }
+        }
+      }
+    });
+  };
 
-  /*plain edge range will be used to calculate predecessor/successors*/
-  /*edge_range returns a tuple every time iterated through*/
+  std::vector<std::size_t> pred_offsets(N + 1), succ_offsets(N + 1);
+  for_each_arc([&](std::size_t u, std::size_t v) {
+    nw::graph::fetch_add(succ_offsets[u + 1], std::size_t(1));
+    nw::graph::fetch_add(pred_offsets[v + 1], std::size_t(1));
+  });
+  std::inclusive_scan(std::execution::par_unseq, pred_offsets.begin(), pred_offsets.end(), pred_offsets.begin());
+  std::inclusive_scan(std::execution::par_unseq, succ_offsets.begin(), succ_offsets.end(), succ_offsets.begin());
 
-  for (auto&& [v, u] : edge_range(A)) {
-    if (degrees[v] > degrees[u]) {
-      successor_list[v].push_back(u);
-      predecessor_list[u].push_back(v);
-    } else if (degrees[v] < degrees[u]) {
-      predecessor_list[v].push_back(u);
-      successor_list[u].push_back(v);
-    } else {
-      if (v > u) {
-        predecessor_list[v].push_back(u);
-        successor_list[u].push_back(v);
-      } else {
-        successor_list[v].push_back(u);
-        predecessor_list[u].push_back(v);
-      }
-    }
-  }
+  std::vector<std::size_t> pred_targets(pred_offsets.back()), succ_targets(succ_offsets.back());
+  std::vector<std::size_t> pred_cursor(pred_offsets.begin(), pred_offsets.end() - 1);
+  std::vector<std::size_t> succ_cursor(succ_offsets.begin(), succ_offsets.end() - 1);
+  for_each_arc([&](std::size_t u, std::size_t v) {
+    succ_targets[nw::graph::fetch_add(succ_cursor[u], std::size_t(1))] = v;
+    pred_targets[nw::graph::fetch_add(pred_cursor[v], std::size_t(1))] = u;
+  });
 
-  for (uint64_t vtx = 0; vtx < N; vtx++) {
-    /*Set the color of the roots to be zero.*/
-    if (predecessor_list[vtx].size() == 0) {
-      mis[vtx] = true;
-#ifdef PRINT_DEBUG
-      std::cout << vtx + 1 << " is in mis: " << mis[vtx] << std::endl;
-#endif
+  // Sort every row and drop its duplicates, which a symmetric A gives.
+  std::vector<std::span<const std::size_t>> preds(N), succs(N);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, N), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      auto dedup = [u](auto& targets, auto& offsets, auto& rows) {
+        auto first = targets.data() + offsets[u], last = targets.data() + offsets[u + 1];
+        std::sort(first, last);
+        rows[u] = std::span<const std::size_t>(first, std::unique(first, last));
+      };
+      dedup(pred_targets, pred_offsets, preds);
+      dedup(succ_targets, succ_offsets, succs);
     }
-  }
+  });
 
-  for (auto&& [v, u, ready_to_process] : dag_range(A, predecessor_list, successor_list)) {
-#ifdef PRINT_DEBUG
-    std::cout << "V: " << v + 1 << " U:" << u + 1 << std::endl;
-#endif
-    if (mis[v] == true) mis[u] = false;
-  }
+  // The predecessor rows hold only earlier vertices, so every one of them counts.
+  auto state = detail::ordered_mis(preds, succs, [](std::size_t, std::size_t) { return true; });
 
-  return;
+  mis.resize(N);
+  for (std::size_t v = 0; v < N; ++v) {
+    mis[v] = state[v] == 1;
+  }
 }
 
 }    // namespace graph
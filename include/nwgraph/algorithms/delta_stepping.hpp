@@ -17,8 +17,13 @@
 #define DELTA_STEPPING_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <queue>
+#include <ranges>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -33,9 +38,10 @@
 #include "nwgraph/util/timer.hpp"
 #include "nwgraph/util/util.hpp"
 
-#include "tbb/concurrent_vector.h"
-#include "tbb/parallel_for_each.h"
-#include "tbb/queuing_mutex.h"
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
 namespace nw {
 namespace graph {
@@ -155,72 +161,293 @@ auto delta_stepping(
   return tdist;
 }
 
+namespace detail {
+
+/// A compressed copy of a weighted graph in which the light edges of every
+/// vertex, those no heavier than delta, come before its heavy edges, so that
+/// either kind can be relaxed without looking at the other.
+template <class Id, class distance_t>
+struct light_heavy_graph {
+  std::vector<std::size_t> indices;    //!< the start of the row of every vertex, and the end of the last one
+  std::vector<std::size_t> split;      //!< the end of the light edges of every vertex
+  std::vector<Id>          targets;
+  std::vector<distance_t>  weights;
+};
+
+template <class distance_t, adjacency_list_graph Graph, class T, class Weight>
+auto split_light_heavy(const Graph& graph, T delta, Weight&& weight) {
+  using Id            = vertex_id_t<Graph>;
+  const std::size_t n = num_vertices(graph);
+
+  light_heavy_graph<Id, distance_t> g{std::vector<std::size_t>(n + 1), std::vector<std::size_t>(n), {}, {}};
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      g.indices[u + 1] = std::ranges::distance(graph[u]);
+    }
+  });
+  std::inclusive_scan(g.indices.begin(), g.indices.end(), g.indices.begin());
+
+  g.targets.resize(g.indices.back());
+  g.weights.resize(g.indices.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      std::size_t light = g.indices[u], heavy = g.indices[u + 1];
+      for (auto&& elt : graph[u]) {
+        distance_t  w = weight(elt);
+        std::size_t j = (w <= delta) ? light++ : --heavy;
+        g.targets[j]  = target(graph, elt);
+        g.weights[j]  = w;
+      }
+      g.split[u] = light;
+    }
+  });
+  return g;
+}
+
+}    // namespace detail
+
+/**
+ * Choose delta for delta-stepping from the edge weights.
+ *
+ * Uses the largest weight divided by the average degree, as suggested by
+ * Meyer and Sanders for random weights, but never less than the smallest
+ * positive weight, so that a bucket is not too small to hold any edge.
+ *
+ * @tparam distance_t Type of distance measure.
+ * @tparam Graph Type of input graph.  Must meet the requirements of adjacency_list_graph.
+ * @tparam Weight Type of function used to compute edge weights.
+ * @param graph The input graph.
+ * @param weight Function to compute weight of an edge.
+ * @return A positive delta.
+ */
+template <class distance_t, adjacency_list_graph Graph,
+          class Weight = std::function<std::tuple_element_t<1, inner_value_t<Graph>>(const inner_value_t<Graph>&)>>
+distance_t choose_delta(
+    const Graph& graph, Weight weight = [](auto& e) { return std::get<1>(e); }) {
+  using stats = std::tuple<distance_t, distance_t, std::size_t>;    // largest weight, smallest positive weight, edges
+
+  const std::size_t n                   = num_vertices(graph);
+  auto [largest, smallest, num_edges] = tbb::parallel_reduce(
+      tbb::blocked_range<std::size_t>(0, n), stats(0, std::numeric_limits<distance_t>::max(), 0),
+      [&](auto&& r, stats s) {
+        for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+          for (auto&& elt : graph[u]) {
+            distance_t w   = weight(elt);
+            std::get<0>(s) = std::max(std::get<0>(s), w);
+            std::get<1>(s) = w > 0 ? std::min(std::get<1>(s), w) : std::get<1>(s);
+            ++std::get<2>(s);
+          }
+        }
+        return s;
+      },
+      [](const stats& a, const stats& b) {
+        return stats(std::max(std::get<0>(a), std::get<0>(b)), std::min(std::get<1>(a), std::get<1>(b)), std::get<2>(a) + std::get<2>(b));
+      });
+
+  if (largest <= 0) {
+    return 1;
+  }
+  // In double, since largest * n can overflow an integral distance_t.
+  double     ratio = double(largest) * double(n) / double(num_edges);
+  distance_t delta = ratio < double(std::numeric_limits<distance_t>::max()) ? distance_t(ratio) : std::numeric_limits<distance_t>::max();
+  return std::max(delta, smallest);
+}
+
 /**
  * Delta-stepping single-source shortest-paths.
  *
- * Parallel implementation of delta-stepping single-source shortest-paths 
- * @verbatim embed:rst:inline :cite:`MEYER2003114`.@endverbatim  Uses Intel TBB
- * for parallelization.
+ * Parallel implementation of delta-stepping single-source shortest-paths
+ * @verbatim embed:rst:inline :cite:`MEYER2003114`.@endverbatim, following the
+ * GAP benchmark suite.  Uses Intel TBB for parallelization.
+ *
+ * Every thread keeps its own array of buckets, so relaxation never takes a
+ * lock: a distance is lowered with compare-and-swap, and the winner puts the
+ * vertex in its bucket.  At the end of an epoch the lowest non-empty bucket
+ * of all threads is merged into the next frontier, each thread copying to its
+ * offset in a prefix sum of the sizes.  A thread that puts only a few
+ * vertices back in the current bucket processes them right away, instead of
+ * waiting for another epoch (bucket fusion).
+ *
+ * The edges of each vertex are first partitioned into light (weight at most
+ * delta) and heavy ones.  Light edges are relaxed every time a vertex is
+ * visited in its bucket, and heavy edges, which cannot reach the same bucket,
+ * only once, when the bucket is done and the distance of the vertex is final.
  *
  * @tparam distance_t Type of distance measure.
  * @tparam Graph Type of input graph.  Must meet the requirements of adjacency_list_graph.
  * @tparam T Type of delta parameter.
+ * @tparam Weight Type of function used to compute edge weights.
  * @param graph The input graph.
  * @param source The starting vertex.
- * @param delta The delta parameter for the algorithm.
+ * @param delta The delta parameter for the algorithm, or 0 to pick it with choose_delta.
+ * @param weight Function to compute weight of an edge.
+ * @param relaxed If not null, receives the number of edges relaxed.
+ * @return The distance of every vertex from the source, or std::numeric_limits<distance_t>::max() if it is unreachable.
  */
-template <class distance_t, adjacency_list_graph Graph, class T>
-auto delta_stepping(const Graph& graph, vertex_id_t<Graph> source, T delta) {
+template <class distance_t, adjacency_list_graph Graph, class T,
+          class Weight = std::function<std::tuple_element_t<1, inner_value_t<Graph>>(const inner_value_t<Graph>&)>>
+auto parallel_delta_stepping(
+    const Graph& graph, vertex_id_t<Graph> source, T delta, Weight weight = [](auto& e) { return std::get<1>(e); },
+    std::size_t* relaxed = nullptr) {
   using Id = vertex_id_t<Graph>;
-  tbb::queuing_mutex                                 lock;
-  std::atomic<std::size_t>                           size = 1;
-  tbb::concurrent_vector<tbb::concurrent_vector<Id>> bins(size);
-  std::size_t                                        top_bin = 0;
 
-  std::vector<std::atomic<distance_t>> tdist(num_vertices(graph));
-  tbb::parallel_for_each(tdist, [](auto&& d) { d = std::numeric_limits<distance_t>::max(); });
+  constexpr std::size_t fusion_threshold = 1000;
+  constexpr std::size_t none             = std::numeric_limits<std::size_t>::max();
 
-  bins[top_bin].push_back(source);
-  tdist[source] = 0;
+  if (delta == T(0)) {
+    delta = T(choose_delta<distance_t>(graph, weight));
+  }
 
-  auto relax = [&](Id i, Id j, auto wt) {
-    distance_t next = nw::graph::acquire(tdist[i]) + wt;
-    distance_t prev = nw::graph::acquire(tdist[j]);
-    bool       success;
-    while (next < prev && !(success = nw::graph::cas(tdist[j], prev, next))) {
+  const std::size_t n = num_vertices(graph);
+  auto              g = detail::split_light_heavy<distance_t>(graph, delta, weight);
+
+  std::vector<distance_t> dist(n, std::numeric_limits<distance_t>::max());
+  std::vector<char>       settled(n, false);
+
+  struct local_state {
+    std::vector<std::vector<Id>> bins;
+    std::vector<Id>              settled;    // vertices of the current bucket whose heavy edges are pending
+    std::vector<Id>              scratch;
+    std::size_t                  relaxed = 0;
+  };
+  tbb::enumerable_thread_specific<local_state> locals;
+
+  auto bin_of = [&](distance_t d) { return static_cast<std::size_t>(d / delta); };
+
+  auto relax = [&](Id u, std::size_t begin, std::size_t end, local_state& local) {
+    distance_t du = nw::graph::acquire(dist[u]);
+    for (std::size_t j = begin; j != end; ++j) {
+      Id         v    = g.targets[j];
+      distance_t next = du + g.weights[j];
+      distance_t prev = nw::graph::acquire(dist[v]);
+      while (next < prev) {
+        if (nw::graph::cas(dist[v], prev, next)) {
+          std::size_t bin = bin_of(next);
+          if (bin >= local.bins.size()) {
+            local.bins.resize(bin + 1);
+          }
+          local.bins[bin].push_back(v);
+          break;
+        }
+      }
     }
-    if (!success) return;
-
-    // inject this into the right bin (double-checked locking to serialize
-    // resizing because tbb::concurrent_vector resizing is not thread safe
-    // https://www.threadingbuildingblocks.org/docs/help/hh_goto.htm?index.htm#tbb_userguide/Advanced_Idiom_Waiting_on_an_Element.html)
-    std::size_t bin = next / delta;
-    if (nw::graph::acquire(size) < bin + 1) {
-      tbb::queuing_mutex::scoped_lock _(lock);
-      if (nw::graph::acquire(size) < bin + 1) {
-        bins.grow_to_at_least(bin + 1);
-        nw::graph::release(size, bin + 1);
+    local.relaxed += end - begin;
+  };
+
+  // Relax the light edges of u, unless it has moved to a lower bucket since it was put in this one.
+  auto visit = [&](Id u, std::size_t bin, local_state& local) {
+    if (bin_of(nw::graph::acquire(dist[u])) != bin) {
+      return;
+    }
+    relax(u, g.indices[u], g.split[u], local);
+    char expected = false;
+    if (!nw::graph::relaxed(settled[u]) && nw::graph::cas(settled[u], expected, char(true))) {
+      local.settled.push_back(u);
+    }
+  };
+
+  // The lowest non-empty bucket of any thread, starting at bin.
+  auto next_bin = [&](std::size_t bin) {
+    std::size_t next = none;
+    for (auto&& local : locals) {
+      for (std::size_t i = bin, e = std::min(next, local.bins.size()); i < e; ++i) {
+        if (!local.bins[i].empty()) {
+          next = i;
+          break;
+        }
       }
     }
-    bins[bin].push_back(j);
+    return next;
   };
 
-  tbb::concurrent_vector<Id> frontier;
+  // Move a list of every thread into out, each at its offset in a prefix sum of their sizes.
+  auto merge = [&](auto&& list, std::vector<Id>& out) {
+    std::vector<std::vector<Id>*> lists;
+    for (auto&& local : locals) {
+      lists.push_back(list(local));
+    }
+    std::vector<std::size_t> offsets(lists.size() + 1);
+    for (std::size_t i = 0; i < lists.size(); ++i) {
+      offsets[i + 1] = offsets[i] + (lists[i] ? lists[i]->size() : 0);
+    }
+    out.resize(offsets.back());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, lists.size(), 1), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        if (lists[i]) {
+          std::copy(lists[i]->begin(), lists[i]->end(), out.begin() + offsets[i]);
+          lists[i]->clear();
+        }
+      }
+    });
+  };
 
-  while (top_bin < bins.size()) {
-    frontier.resize(0);
-    std::swap(frontier, bins[top_bin]);
-    tbb::parallel_for_each(frontier, [&](auto&& u) {
-      if (tdist[u] >= delta * top_bin) {
-        nw::graph::parallel_for(graph[u], [&](auto&& v, auto&& wt) { relax(u, v, wt); });
+  dist[source] = 0;
+  std::vector<Id> frontier{source};
+  std::size_t     bin = 0;
+
+  while (true) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()), [&](auto&& r) {
+      auto&& local = locals.local();
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        visit(frontier[i], bin, local);
+      }
+      while (bin < local.bins.size() && !local.bins[bin].empty() && local.bins[bin].size() < fusion_threshold) {
+        std::swap(local.scratch, local.bins[bin]);
+        for (auto u : local.scratch) {
+          visit(u, bin, local);
+        }
+        local.scratch.clear();
       }
     });
 
-    while (top_bin < bins.size() && bins[top_bin].size() == 0) {
-      bins[top_bin++].shrink_to_fit();
+    std::size_t next = next_bin(bin);
+    if (next != bin) {
+      // The bucket is done, so relax the heavy edges of its vertices, which all land in later buckets.
+      merge([](local_state& local) { return &local.settled; }, frontier);
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()), [&](auto&& r) {
+        auto&& local = locals.local();
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          Id u       = frontier[i];
+          settled[u] = false;
+          relax(u, g.split[u], g.indices[u + 1], local);
+        }
+      });
+      next = next_bin(bin);
+    }
+
+    if (next == none) {
+      break;
     }
+    bin = next;
+    merge([bin](local_state& local) { return bin < local.bins.size() ? &local.bins[bin] : nullptr; }, frontier);
   }
-  return tdist;
+
+  if (relaxed) {
+    *relaxed = 0;
+    for (auto&& local : locals) {
+      *relaxed += local.relaxed;
+    }
+  }
+  return dist;
+}
+
+/**
+ * Delta-stepping single-source shortest-paths.
+ *
+ * Parallel implementation of delta-stepping single-source shortest-paths, for
+ * graphs whose second edge attribute is the weight.  See
+ * parallel_delta_stepping.
+ *
+ * @tparam distance_t Type of distance measure.
+ * @tparam Graph Type of input graph.  Must meet the requirements of adjacency_list_graph.
+ * @tparam T Type of delta parameter.
+ * @param graph The input graph.
+ * @param source The starting vertex.
+ * @param delta The delta parameter for the algorithm, or 0 to pick it from the weights.
+ */
+template <class distance_t, adjacency_list_graph Graph, class T>
+auto delta_stepping(const Graph& graph, vertex_id_t<Graph> source, T delta) {
+  return parallel_delta_stepping<distance_t>(graph, source, delta);
 }
 
 }    // namespace graph
@@ -19,20 +19,174 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <functional>
 #include <limits>
 #include <queue>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "nwgraph/adaptors/bfs_edge_range.hpp"
 #include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/d_ary_heap.hpp"
+#include "nwgraph/util/radix_heap.hpp"
+#include "nwgraph/util/util.hpp"
 
 namespace nw {
 namespace graph {
 
+namespace detail {
+
+/// The weight of an edge whose first attribute is its weight.
+struct first_attribute_weight {
+  template <class Edge>
+  constexpr auto operator()(const Edge& e) const {
+    return std::get<1>(e);
+  }
+};
+
+/// The priority queue of a Dijkstra search: a radix heap for integer
+/// distances, and an indexed 4-ary heap with decrease-key otherwise.
+template <class Distance, class Id, bool = std::is_integral_v<Distance>>
+struct dijkstra_heap {
+  using type = indexed_d_ary_heap<Distance, Id, 4>;
+  static type make(std::size_t n) { return type(n); }
+};
+
+template <class Distance, class Id>
+struct dijkstra_heap<Distance, Id, true> {
+  using type = radix_heap<std::make_unsigned_t<Distance>, Id>;
+  static type make(std::size_t) { return type(); }
+};
+
+/// One direction of a Dijkstra search.
+///
+/// The arrays are sized for the whole graph once, and every search starts by
+/// undoing only the entries the previous one touched, so a query costs time
+/// proportional to the part of the graph it explores rather than O(N).
+///
+/// Vertices are keyed by their distance plus a potential, which is zero for
+/// Dijkstra's algorithm and a feasible lower bound on the distance to the
+/// target for A*, so that the keys popped never decrease.
+template <class Distance, class Id>
+class dijkstra_search {
+  using heap = dijkstra_heap<Distance, Id>;
+
+  std::vector<Distance> dist_;
+  std::vector<Id>       parent_;
+  std::vector<char>     done_;
+  std::vector<Id>       touched_;
+  typename heap::type   heap_;
+  std::size_t           settled_ = 0;
+
+public:
+  static constexpr Distance infinity = std::numeric_limits<Distance>::max();
+  static constexpr Id       none     = null_vertex_v<Id>();
+
+  /// The potential of Dijkstra's algorithm.
+  static constexpr auto zero = [](Id) { return Distance(0); };
+
+  explicit dijkstra_search(std::size_t n) : dist_(n, infinity), parent_(n, none), done_(n, false), heap_(heap::make(n)) {}
+
+  /// Forget the previous search and start a new one from source.
+  template <class Potential = decltype(zero)>
+  void start(Id source, const Potential& potential = zero) {
+    for (auto v : touched_) {
+      dist_[v]   = infinity;
+      parent_[v] = none;
+      done_[v]   = false;
+    }
+    touched_.clear();
+    heap_.clear();
+    settled_ = 0;
+    label(source, 0, source, potential);
+  }
+
+  /// Lower the distance of v to d, through p, if that is shorter.  A vertex
+  /// with an infinite potential cannot reach the target and is ignored.
+  template <class Potential = decltype(zero)>
+  bool label(Id v, Distance d, Id p, const Potential& potential = zero) {
+    if (!(d < dist_[v])) {
+      return false;
+    }
+    Distance h = potential(v);
+    if (h == infinity) {
+      return false;
+    }
+    if (dist_[v] == infinity) {
+      touched_.push_back(v);
+    }
+    dist_[v]   = d;
+    parent_[v] = p;
+    heap_.push(d + h, v);
+    return true;
+  }
+
+  /// Whether a vertex is left to settle, after dropping stale heap entries.
+  bool pending() {
+    while (!heap_.empty() && done_[heap_.top().second]) {
+      heap_.pop();
+    }
+    return !heap_.empty();
+  }
+
+  /// The key of the next vertex to settle, its distance plus its potential.  Requires pending().
+  Distance min_key() { return heap_.top().first; }
+
+  /// Settle the vertex with the smallest key.  Requires pending().
+  Id settle() {
+    Id u = heap_.top().second;
+    heap_.pop();
+    done_[u] = true;
+    ++settled_;
+    return u;
+  }
+
+  /// Relax the edges of u, calling f(v, d) with the length d of the path through u to every neighbor v.
+  template <class Graph, class Weight, class Potential, class F>
+  void scan(const Graph& graph, Id u, Weight& weight, const Potential& potential, F&& f) {
+    Distance du = dist_[u];
+    for (auto&& e : graph[u]) {
+      Id       v = target(graph, e);
+      Distance d = du + Distance(weight(e));
+      label(v, d, u, potential);
+      f(v, d);
+    }
+  }
+
+  template <class Graph, class Weight>
+  void scan(const Graph& graph, Id u, Weight& weight) {
+    scan(graph, u, weight, zero, [](Id, Distance) {});
+  }
+
+  Distance    distance(Id v) const { return dist_[v]; }
+  Id          parent(Id v) const { return parent_[v]; }
+  std::size_t settled() const { return settled_; }
+
+  /// The vertices from the source to v, following the parents.
+  std::vector<Id> path_to(Id v) const {
+    std::vector<Id> path;
+    if (dist_[v] != infinity) {
+      for (path.push_back(v); parent_[v] != v; path.push_back(v)) {
+        v = parent_[v];
+      }
+      std::reverse(path.begin(), path.end());
+    }
+    return path;
+  }
+
+  std::vector<Distance> take_distances() && { return std::move(dist_); }
+};
+
+}    // namespace detail
+
 /**
- * Basic Dijkstra's single-source shortest-paths algorithm, based on bfs_edge_range adaptor.
+ * Basic Dijkstra's single-source shortest-paths algorithm, with a binary heap
+ * of (distance, vertex) entries.  A vertex is pushed again whenever its
+ * distance improves, and an entry popped with a larger distance than the
+ * vertex has by then is stale and skipped.
  *
  * @tparam Type of the edge weights (distances).
  * @tparam Graph Type of the input graph.  Must meet the requirements of the adjacency_list_graph concept.
@@ -47,18 +201,27 @@ std::vector<Distance> dijkstra_er(const Graph& graph, vertex_id_t<Graph> source)
   size_t N(graph.end() - graph.begin());
   assert(source < N);
 
-  std::vector<Distance> distance(N, 0xDEADBEEF);
+  std::vector<Distance> distance(N, std::numeric_limits<Distance>::max());
   distance[source] = 0;
 
-  using weight_t        = Distance;
-  using weighted_vertex = std::tuple<vertex_id_type, weight_t>;
+  using weighted_vertex = std::tuple<Distance, vertex_id_type>;
 
   std::priority_queue<weighted_vertex, std::vector<weighted_vertex>, std::greater<weighted_vertex>> Q;
+  Q.push({distance[source], source});
 
-  for (auto&& [u, v, w] : bfs_edge_range2(graph, Q)) {
-    if (distance[u] + w < distance[v]) {
-      distance[v] = distance[u] + w;
-      Q.push({ v, distance[v] });
+  while (!Q.empty()) {
+    auto [d, u] = Q.top();
+    Q.pop();
+    if (d > distance[u]) {
+      continue;
+    }
+    for (auto&& elt : graph[u]) {
+      auto v = target(graph, elt);
+      auto w = std::get<1>(elt);
+      if (d + w < distance[v]) {
+        distance[v] = d + w;
+        Q.push({distance[v], v});
+      }
     }
   }
 
@@ -69,50 +232,206 @@ std::vector<Distance> dijkstra_er(const Graph& graph, vertex_id_t<Graph> source)
  * Dijkstra's single-source shortest-paths algorithm, lifted per 
  * @verbatim embed:rst:inline :ref:`Lifting Edge Weight`.@endverbatim  
  *
+ * Uses a radix heap for integral distances and an indexed 4-ary heap with
+ * decrease-key otherwise.
+ *
  * @tparam Type of the edge weights (distances).
  * @tparam Graph Type of the input graph.  Must meet the requirements of the adjacency_list_graph concept.
  * @tparam Weight Type of function used to compute edge weights.
  * @param graph The input graph.
  * @param source The starting vertex.
  * @param weight Function for computing edge weight.
- * @return Vector of distances from the starting node for each vertex in the graph.
+ * @return Vector of distances from the starting node for each vertex in the graph, std::numeric_limits<Distance>::max() if it is unreachable.
  */
 template <
     typename Distance, adjacency_list_graph Graph,
     std::invocable<inner_value_t<Graph>> Weight = std::function<std::tuple_element_t<1, inner_value_t<Graph>>(const inner_value_t<Graph>&)>>
 auto dijkstra(
     const Graph& graph, vertex_id_t<Graph> source, Weight weight = [](auto& e) { return std::get<1>(e); }) {
-  using vertex_id_type = vertex_id_t<Graph>;
-
   size_t N(graph.end() - graph.begin());
   assert(source < N);
 
-  std::vector<Distance> distance(N, std::numeric_limits<vertex_id_type>::max());
-  distance[source] = 0;
+  detail::dijkstra_search<Distance, vertex_id_t<Graph>> search(N);
+  search.start(source);
+  while (search.pending()) {
+    search.scan(graph, search.settle(), weight);
+  }
+  return std::move(search).take_distances();
+}
 
-  auto g                = graph.begin();
-  using weight_t        = Distance;
-  using weighted_vertex = std::tuple<vertex_id_type, weight_t>;
+/**
+ * A reusable point-to-point shortest-path query.
+ *
+ * Answers any number of queries on one graph.  The distance and parent arrays
+ * are allocated once, and each query only resets the entries the previous one
+ * touched.  A query stops as soon as the target is settled.
+ *
+ * @tparam Distance Type of the distances.  Integral distances use a radix heap,
+ *         others an indexed 4-ary heap with decrease-key.
+ * @tparam Graph Type of the input graph.  Must meet the requirements of the adjacency_list_graph concept.
+ * @tparam Weight Type of function used to compute edge weights, which must not be negative.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+class dijkstra_query {
+  using vertex_id_type = vertex_id_t<Graph>;
+  using search_type    = detail::dijkstra_search<Distance, vertex_id_type>;
 
-  std::priority_queue<weighted_vertex, std::vector<weighted_vertex>, std::greater<weighted_vertex>> Q;
+  const Graph& graph_;
+  Weight       weight_;
+  search_type  search_;
 
-  Q.push({ source, distance[source] });
+public:
+  static constexpr Distance       infinity = search_type::infinity;
+  static constexpr vertex_id_type none     = search_type::none;
 
-  while (!Q.empty()) {
+  explicit dijkstra_query(const Graph& graph, Weight weight = {}) : graph_(graph), weight_(weight), search_(num_vertices(graph)) {}
 
-    auto u = std::get<0>(Q.top());
-    Q.pop();
+  /// The length of a shortest path from source to target, or infinity if there is none.
+  Distance query(vertex_id_type source, vertex_id_type target) {
+    search_.start(source);
+    while (search_.pending()) {
+      auto u = search_.settle();
+      if (u == target) {
+        break;
+      }
+      search_.scan(graph_, u, weight_);
+    }
+    return search_.distance(target);
+  }
+
+  /// The distances from source to every vertex, available through distance().
+  void search(vertex_id_type source) {
+    search_.start(source);
+    while (search_.pending()) {
+      search_.scan(graph_, search_.settle(), weight_);
+    }
+  }
+
+  /// The distance to v found by the last query, exact for the vertices it settled.
+  Distance distance(vertex_id_type v) const { return search_.distance(v); }
+
+  /// A shortest path from the last source to v, or an empty path if v was not reached.
+  std::vector<vertex_id_type> path(vertex_id_type v) const { return search_.path_to(v); }
+
+  /// The number of vertices settled by the last query.
+  std::size_t settled() const { return search_.settled(); }
+};
+
+/**
+ * A reusable bidirectional point-to-point shortest-path query.
+ *
+ * Searches forward from the source and backward from the target at the same
+ * time, always advancing the side whose next vertex is closer, and stops
+ * once the two next distances add up to at least the shortest path seen,
+ * which on road networks settles far fewer vertices than one search.
+ *
+ * @tparam Distance Type of the distances.
+ * @tparam Graph Type of the input graph.  Must meet the requirements of the adjacency_list_graph concept.
+ * @tparam Reverse Type of the reverse graph.
+ * @tparam Weight Type of function used to compute edge weights, which must not be negative.
+ */
+template <class Distance, adjacency_list_graph Graph, adjacency_list_graph Reverse = Graph, class Weight = detail::first_attribute_weight>
+class bidirectional_dijkstra_query {
+  using vertex_id_type = vertex_id_t<Graph>;
+  using search_type    = detail::dijkstra_search<Distance, vertex_id_type>;
 
-    std::for_each(g[u].begin(), g[u].end(), [&](auto&& e) {
-      auto v = target(graph, e);
-      auto w = weight(e);
-      if (distance[u] + w < distance[v]) {
-        distance[v] = distance[u] + w;
-        Q.push({ v, distance[v] });
+  const Graph&   forward_graph_;
+  const Reverse& backward_graph_;
+  Weight         weight_;
+  search_type    forward_;
+  search_type    backward_;
+  vertex_id_type meet_ = search_type::none;
+
+public:
+  static constexpr Distance       infinity = search_type::infinity;
+  static constexpr vertex_id_type none     = search_type::none;
+
+  /// @param forward The graph.
+  /// @param backward Its transpose, e.g., adjacency<1> of the same edges, or the graph itself if it is symmetric.
+  /// @param weight Function to compute the weight of an edge of either graph.
+  bidirectional_dijkstra_query(const Graph& forward, const Reverse& backward, Weight weight = {})
+      : forward_graph_(forward)
+      , backward_graph_(backward)
+      , weight_(weight)
+      , forward_(num_vertices(forward))
+      , backward_(num_vertices(forward)) {}
+
+  /// The length of a shortest path from source to target, or infinity if there is none.
+  Distance query(vertex_id_type source, vertex_id_type target) {
+    forward_.start(source);
+    backward_.start(target);
+    Distance best = infinity;
+    meet_         = none;
+    if (source == target) {
+      meet_ = source;
+      return 0;
+    }
+
+    auto step = [&](search_type& self, const auto& graph, search_type& other) {
+      self.scan(graph, self.settle(), weight_, search_type::zero, [&](vertex_id_type v, Distance d) {
+        if (Distance o = other.distance(v); o != infinity && d + o < best) {
+          best  = d + o;
+          meet_ = v;
+        }
+      });
+    };
+
+    while (forward_.pending() && backward_.pending()) {
+      Distance f = forward_.min_key(), b = backward_.min_key();
+      if (best != infinity && f + b >= best) {
+        break;
       }
-    });
+      if (f <= b) {
+        step(forward_, forward_graph_, backward_);
+      } else {
+        step(backward_, backward_graph_, forward_);
+      }
+    }
+    return best;
   }
-  return distance;
+
+  /// A shortest path found by the last query, from its source to its target, or an empty path.
+  std::vector<vertex_id_type> path() const {
+    if (meet_ == none) {
+      return {};
+    }
+    auto path = forward_.path_to(meet_);
+    for (auto v = meet_; backward_.parent(v) != v;) {
+      v = backward_.parent(v);
+      path.push_back(v);
+    }
+    return path;
+  }
+
+  /// The number of vertices settled by the last query, in both directions.
+  std::size_t settled() const { return forward_.settled() + backward_.settled(); }
+};
+
+/**
+ * Create a reusable point-to-point shortest-path query.
+ *
+ * @tparam Distance Type of the distances.
+ * @param graph The input graph, which must outlive the query.
+ * @param weight Function to compute edge weights [default: the first attribute of the edge].
+ * @return A dijkstra_query.
+ */
+template <class Distance, adjacency_list_graph Graph, class Weight = detail::first_attribute_weight>
+auto make_dijkstra_query(const Graph& graph, Weight weight = {}) {
+  return dijkstra_query<Distance, Graph, Weight>(graph, weight);
+}
+
+/**
+ * Create a reusable bidirectional point-to-point shortest-path query.
+ *
+ * @tparam Distance Type of the distances.
+ * @param forward The input graph, which must outlive the query.
+ * @param backward Its transpose, or the graph itself if it is symmetric.
+ * @param weight Function to compute edge weights [default: the first attribute of the edge].
+ * @return A bidirectional_dijkstra_query.
+ */
+template <class Distance, adjacency_list_graph Graph, adjacency_list_graph Reverse, class Weight = detail::first_attribute_weight>
+auto make_bidirectional_dijkstra_query(const Graph& forward, const Reverse& backward, Weight weight = {}) {
+  return bidirectional_dijkstra_query<Distance, Graph, Reverse, Weight>(forward, backward, weight);
 }
 
 }    // namespace graph
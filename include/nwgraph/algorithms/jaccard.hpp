@@ -25,6 +25,7 @@
 
 #include "nwgraph/adaptors/cyclic_range_adaptor.hpp"
 #include "nwgraph/adaptors/edge_range.hpp"
+#include "nwgraph/algorithms/similarity.hpp"
 #include "nwgraph/util/intersection_size.hpp"
 #include "nwgraph/util/parallel_for.hpp"
 #include "nwgraph/util/timer.hpp"
@@ -34,32 +35,30 @@ namespace nw {
 namespace graph {
 
 /**
- * @brief A sequential jaccard similarity algorithm using set intersection.
+ * @brief A parallel jaccard similarity algorithm using set intersection.
+ *
+ * Scores the edges (u, v) with u < v, using for_each_similarity(), which
+ * skips the other half of the edges without intersecting their end points.
  * 
  * @tparam GraphT Type of graph.  Must meet the requirements of adjacency_list_graph concept.
  * @tparam Weight Type of the edge weight function.
  * @param G Input graph.
  * @param weight Weight function on how to access the edge weight.
- * @return size_t Jaccard similarity score.
+ * @return size_t The number of edges scored.
  */
 template <adjacency_list_graph GraphT, typename Weight>
 size_t jaccard_similarity(GraphT& G, Weight weight) {
-  size_t ctr = 0;
+  tbb::enumerable_thread_specific<size_t> ctr(0);
 
-  for (size_t u = 0; u < num_vertices(G); ++u) {
-    for (auto&& e : G[u]) {
-      auto v = target(G, e);
-      if (u < v) {
-        auto numer = nw::graph::intersection_size(G[u], G[v]);
-        auto denom = degree(G[u]) + degree(G[v]) - numer;
-        double rat = ((double)numer) / ((double)denom);
+  for_each_similarity<similarity_measure::jaccard>(
+      G,
+      [&](size_t, auto&& e, double rat) {
         weight(e) = rat;
-        ++ctr;
-      }
-    }
-  }
+        ++ctr.local();
+      },
+      [](size_t u, size_t v) { return u < v; });
 
-  return ctr;
+  return ctr.combine(std::plus<size_t>());
 }
 
 }    // namespace graph
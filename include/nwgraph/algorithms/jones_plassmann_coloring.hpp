@@ -17,68 +17,279 @@
 #ifndef JONES_PLASSMANN_COLORING_HPP
 #define JONES_PLASSMANN_COLORING_HPP
 
-#include "nwgraph/adaptors/dag_range.hpp"
-#include "nwgraph/adaptors/edge_range.hpp"
-#include "nwgraph/adaptors/plain_range.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/algorithms/k_core.hpp"
+#include "nwgraph/util/atomic.hpp"
 
-#include "nwgraph/algorithms/maximal_independent_set.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
 
 namespace nw {
 namespace graph {
 
+/// The order in which a greedy coloring visits the vertices.
+enum class coloring_order {
+  random,           //!< a random order, the classic Jones-Plassmann
+  largest_first,    //!< by decreasing degree, ties at random
+  smallest_last     //!< by decreasing core number (the parallel approximation of smallest-last), ties at random
+};
+
+namespace detail {
+
+/// A set of colors, as a bitset that grows with the largest color forbidden.
+class forbidden_colors {
+  std::vector<std::uint64_t> words_;
+
+public:
+  void set(std::size_t c) {
+    if (c / 64 >= words_.size()) {
+      words_.resize(c / 64 + 1);
+    }
+    words_[c / 64] |= std::uint64_t(1) << (c % 64);
+  }
+
+  /// Clear the word of color c, which is how a whole set is cleared after use.
+  void clear(std::size_t c) {
+    if (c / 64 < words_.size()) {
+      words_[c / 64] = 0;
+    }
+  }
+
+  /// The smallest color that is not forbidden.
+  std::size_t first_free() const {
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+      if (~words_[w]) {
+        return w * 64 + std::countr_one(words_[w]);
+      }
+    }
+    return words_.size() * 64;
+  }
+};
+
+/// A random 32 bit key of a vertex.
+inline std::uint64_t coloring_hash(std::uint64_t u, std::uint64_t seed) {
+  std::uint64_t h = (u + seed) * 0x9e3779b97f4a7c15ull;
+  h               = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+  h               = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+  return (h ^ (h >> 31)) >> 32;
+}
+
+/// The priority of every vertex, higher first, with random low bits to break ties.
+template <adjacency_list_graph Graph>
+std::vector<std::uint64_t> coloring_priorities(const Graph& A, coloring_order order, std::uint64_t seed) {
+  const std::size_t          n = A.size();
+  std::vector<std::uint64_t> priority(n);
+  if (order == coloring_order::smallest_last) {
+    auto core = core_numbers(A);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+      for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+        priority[u] = (std::uint64_t(core[u]) << 32) | coloring_hash(u, seed);
+      }
+    });
+    return priority;
+  }
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      std::uint64_t high = order == coloring_order::largest_first ? std::ranges::distance(A[u]) : 0;
+      priority[u]        = (high << 32) | coloring_hash(u, seed);
+    }
+  });
+  return priority;
+}
+
+/// Color u with the smallest color not used by the neighbors selected by pred.
+template <class Graph, class Colors, class Pred>
+std::size_t first_fit(const Graph& A, std::size_t u, const Colors& colors, forbidden_colors& forbidden, Pred&& pred) {
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+  for (auto&& e : A[u]) {
+    if (std::size_t v = target(A, e); v != u && pred(v)) {
+      if (std::size_t c = nw::graph::load<std::memory_order_relaxed>(const_cast<std::size_t&>(colors[v])); c != none) {
+        forbidden.set(c);
+      }
+    }
+  }
+  std::size_t color = forbidden.first_free();
+  for (auto&& e : A[u]) {
+    if (std::size_t v = target(A, e); v != u && pred(v)) {
+      if (std::size_t c = nw::graph::load<std::memory_order_relaxed>(const_cast<std::size_t&>(colors[v])); c != none) {
+        forbidden.clear(c);
+      }
+    }
+  }
+  return color;
+}
+
+inline std::size_t count_colors(const std::vector<std::size_t>& colors) {
+  return tbb::parallel_reduce(
+      tbb::blocked_range<std::size_t>(0, colors.size()), std::size_t(0),
+      [&](auto&& r, std::size_t m) {
+        for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+          m = std::max(m, colors[u] + 1);
+        }
+        return m;
+      },
+      [](std::size_t a, std::size_t b) { return std::max(a, b); });
+}
+
+}    // namespace detail
+
 /**
- * @brief Graph greedy coloring using maximal independent set.
- * 
+ * @brief Parallel Jones-Plassmann greedy coloring.
+ *
+ * Every vertex gets the smallest color that none of its neighbors of higher
+ * priority has, as in a sequential greedy coloring in priority order.  The
+ * vertices are colored in parallel rounds: a vertex is ready once all of its
+ * higher priority neighbors are colored, which is tracked with an atomic
+ * count of uncolored predecessors, so every round colors the vertices that are
+ * local maxima among the uncolored ones.  Colors are chosen with a per-thread
+ * bitset of forbidden colors.
+ *
  * @tparam Graph Type of graph.  Must meet the requirements of adjacency_list_graph concept.
- * @param A The input graph.
- * @param colors The array of colors of each vertex.
+ * @param A The input graph, which must be symmetric.
+ * @param colors The array of colors of each vertex, starting at 0.
+ * @param order The priority of the vertices.
+ * @param seed The seed of the random tie breaking.
+ * @return The number of colors used.
  */
 template <adjacency_list_graph Graph>
-void jones_plassmann_coloring(Graph& A, std::vector<size_t>& colors) {
-  size_t N = num_vertices(A);
-  //init every nodes' color to 0
-  std::fill(colors.begin(), colors.end(), 0);
-
-  //find the maximal independent set
-  std::vector<size_t> independentSet;
-  maximal_independent_set(A, independentSet);
-
-  // Function for finding the first
-  // missing positive number in an (unsorted) array
-  auto firstMissingPositive = []<typename T>(std::vector<T> arr) -> T {
-    size_t n = arr.size();
-    // Loop to traverse the whole array
-    for (size_t i = 0; i < n; ++i) {
-      // Loop to check boundary
-      // condition and for swapping
-      while (1 <= arr[i] && arr[i] <= n && arr[i] != arr[arr[i] - 1]) {
-        std::swap(arr[i], arr[arr[i] - 1]);
+std::size_t jones_plassmann_coloring(const Graph& A, std::vector<size_t>& colors, coloring_order order = coloring_order::random,
+                                     std::uint64_t seed = 0) {
+  const std::size_t N = A.size();
+  colors.assign(N, std::numeric_limits<std::size_t>::max());
+
+  auto priority = detail::coloring_priorities(A, order, seed);
+  auto before   = [&](std::size_t u, std::size_t v) { return priority[u] > priority[v] || (priority[u] == priority[v] && u < v); };
+
+  tbb::enumerable_thread_specific<std::vector<std::size_t>> next;
+  tbb::enumerable_thread_specific<detail::forbidden_colors> forbidden;
+
+  std::vector<std::uint32_t> waiting(N);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, N), [&](auto&& r) {
+    auto&& ready = next.local();
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      for (auto&& edge : A[u]) {
+        if (std::size_t v = target(A, edge); v != u && before(v, u)) {
+          ++waiting[u];
+        }
+      }
+      if (waiting[u] == 0) {
+        ready.push_back(u);
       }
     }
+  });
 
-    // Checking any element which
-    // is not equal to i+1
-    for (size_t i = 0; i < n; ++i) {
-      if (arr[i] != i + 1) {
-        return i + 1;
-      }
+  std::vector<std::size_t> frontier;
+  for (;;) {
+    frontier.clear();
+    for (auto&& ready : next) {
+      frontier.insert(frontier.end(), ready.begin(), ready.end());
+      ready.clear();
     }
+    if (frontier.empty()) {
+      break;
+    }
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()), [&](auto&& r) {
+      auto&& ready = next.local();
+      auto&& f     = forbidden.local();
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::size_t u = frontier[i];
+        colors[u]     = detail::first_fit(A, u, colors, f, [&](std::size_t v) { return before(v, u); });
+        for (auto&& edge : A[u]) {
+          if (std::size_t v = target(A, edge); v != u && before(u, v)) {
+            if (nw::graph::fetch_add(waiting[v], std::uint32_t(-1)) == 1) {
+              ready.push_back(v);
+            }
+          }
+        }
+      }
+    });
+  }
 
-    // Nothing is present return last index
-    return n + 1;
-  };
-
-  //calculate colors based on the maximal independent set
-  std::vector<std::vector<size_t>> neighbor_colors(N);
-  for (auto& u : independentSet) {
-    //memorize colors of every independent vertex's neighbors
-    for (auto it = A[u].begin(); it != A[u].end(); ++it) {
-      auto v = std::get<0>(*it);
-      neighbor_colors[u].push_back(colors[v]);
+  return detail::count_colors(colors);
+}
+
+/**
+ * @brief Parallel speculative greedy coloring (Gebremedhin-Manne iterate and fix).
+ *
+ * All the uncolored vertices are tentatively colored in parallel with the
+ * smallest color not used by any neighbor at that moment, without any
+ * synchronization.  Then the conflicts, neighbors that got the same color,
+ * are detected in parallel, and the vertex of lower priority in each conflict
+ * is recolored in the next round, until no conflicts remain.  Usually only a
+ * few rounds are needed, with few vertices after the first.
+ *
+ * @tparam Graph Type of graph.  Must meet the requirements of adjacency_list_graph concept.
+ * @param A The input graph, which must be symmetric.
+ * @param colors The array of colors of each vertex, starting at 0.
+ * @param order The order in which the vertices are first colored, and their priority in conflicts.
+ * @param seed The seed of the random tie breaking.
+ * @return The number of colors used.
+ */
+template <adjacency_list_graph Graph>
+std::size_t speculative_coloring(const Graph& A, std::vector<size_t>& colors, coloring_order order = coloring_order::largest_first,
+                                 std::uint64_t seed = 0) {
+  constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+  const std::size_t N = A.size();
+  colors.assign(N, none);
+
+  auto priority = detail::coloring_priorities(A, order, seed);
+  auto before   = [&](std::size_t u, std::size_t v) { return priority[u] > priority[v] || (priority[u] == priority[v] && u < v); };
+
+  std::vector<std::size_t> worklist(N);
+  std::iota(worklist.begin(), worklist.end(), 0);
+  std::sort(worklist.begin(), worklist.end(), before);
+
+  tbb::enumerable_thread_specific<std::vector<std::size_t>> next;
+  tbb::enumerable_thread_specific<detail::forbidden_colors> forbidden;
+
+  while (!worklist.empty()) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, worklist.size()), [&](auto&& r) {
+      auto&& f = forbidden.local();
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::size_t u = worklist[i];
+        nw::graph::store<std::memory_order_relaxed>(colors[u], detail::first_fit(A, u, colors, f, [](std::size_t) { return true; }));
+      }
+    });
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, worklist.size()), [&](auto&& r) {
+      auto&& conflicts = next.local();
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::size_t u = worklist[i];
+        for (auto&& edge : A[u]) {
+          if (std::size_t v = target(A, edge); v != u && colors[v] == colors[u] && before(v, u)) {
+            conflicts.push_back(u);
+            break;
+          }
+        }
+      }
+    });
+
+    worklist.clear();
+    for (auto&& conflicts : next) {
+      worklist.insert(worklist.end(), conflicts.begin(), conflicts.end());
+      conflicts.clear();
+    }
+    std::sort(worklist.begin(), worklist.end(), before);
+    for (auto u : worklist) {
+      colors[u] = none;
     }
-    //find the first unused color within every independent vertex's neighbors
-    colors[u] = firstMissingPositive(neighbor_colors[u]);
   }
+
+  return detail::count_colors(colors);
 }
 
 }    // namespace graph
@@ -15,13 +15,24 @@
 #define NW_GRAPH_K_CORE_HPP
 
 #include "nwgraph/adaptors/edge_range.hpp"
-#include "nwgraph/adaptors/new_dfs_range.hpp"
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/atomic.hpp"
 #include "nwgraph/util/defaults.hpp"
 #include "nwgraph/util/util.hpp"
 #include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <ranges>
 #include <tuple>
 #include <unordered_map>
 #include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 namespace nw {
 namespace graph {
@@ -32,11 +43,9 @@ namespace graph {
  */
 struct pair_hash {
   std::size_t operator()(const std::pair<size_t, size_t>& p) const {
-
-    auto h1 = std::hash<default_vertex_id_type>{}(p.first);
-    auto h2 = std::hash<default_vertex_id_type>{}(p.second);
-
-    return h1 ^ h2;
+    // Mix the two endpoints so that (u, v) and (v, u), or (u, u) and (v, v), do not collide.
+    std::size_t h = std::hash<size_t>{}(p.first) * 0x9e3779b97f4a7c15ull;
+    return h ^ (std::hash<size_t>{}(p.second) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2));
   }
 };
 using Neighbors     = std::pair<size_t, size_t>;
@@ -50,72 +59,212 @@ using Unordered_map = std::unordered_map<Neighbors, bool, pair_hash>;
  * @param y The other endpoint of an edge.
  * @return Neighbors of an edge such that 0th element in the pair is smaller than 1th element.
  */
-Neighbors make_my_pair(default_vertex_id_type x, default_vertex_id_type y) {
+inline Neighbors make_my_pair(default_vertex_id_type x, default_vertex_id_type y) {
   if (x < y) return std::make_pair(x, y);
   return std::make_pair(y, x);
 }
 
 /**
- * @brief A sequential k core algorithm to find the k cores in a graph.
- * 
+ * @brief Parallel k-core decomposition by bucketed peeling.
+ *
+ * Computes the core number of every vertex, i.e., the largest k such that
+ * the vertex belongs to the k-core, in one pass.  Vertices are peeled in
+ * order of their current degree, and the vertices of one degree are peeled
+ * in parallel rounds: every round removes a frontier and decrements the
+ * degrees of its neighbors with atomic compare-and-swap, never below the
+ * current k, and the neighbors that reach k form the next frontier.
+ *
+ * Vertices wait for their turn in a Julienne-style bucket structure.  Only a
+ * window of `open` buckets above k is materialized, as per-thread lists that
+ * a vertex is appended to whenever its degree drops into the window (stale
+ * entries are skipped when a bucket is opened); the vertices above the window
+ * stay in an overflow list that is redistributed when the window moves.
+ *
  * @tparam Graph Type of the graph.  Must meet requirements of adjacency_list_graph concept.
- * @param A Input graph.
- * @param k The value of k in the k core.
- * @return std::tuple<Unordered_map, size_t> of an Unordered_map (k core), and the number of vertices in k core.
+ * @param A Input graph, which must be symmetric and have no self loops.
+ * @return std::vector<vertex_id_t<Graph>> of the core number of every vertex.
  */
 template <adjacency_list_graph Graph>
-std::tuple<Unordered_map, size_t> k_core(const Graph& A, int k) {
-  Unordered_map filter;
+auto core_numbers(const Graph& A) {
+  using vertex_id_type = vertex_id_t<Graph>;
 
-  size_t                          n_vtx     = A.size();
-  size_t                          old_n_vtx = n_vtx;
-  std::vector<int>                degree(n_vtx, 0);
-  std::vector<vertex_id_t<Graph>> relabel(n_vtx);
+  constexpr std::size_t open = 64;
+  const std::size_t     n    = A.size();
 
-  for (auto&& [u, v] : edge_range(A)) {
-    ++degree[v];
-  }
+  std::vector<vertex_id_type> degree(n), core(n);
+  std::vector<char>           removed(n, false);
+
+  using buckets = std::vector<std::vector<vertex_id_type>>;
+  tbb::enumerable_thread_specific<buckets>                     window([] { return buckets(open); });
+  tbb::enumerable_thread_specific<std::vector<vertex_id_type>> overflow, next;
 
-  dfs_edge_range ranges(A, 0);
-  auto           ite = ranges.begin();
-  for (; ite != ranges.end(); ++ite) {
-    auto v = std::get<1>(*ite);
-    auto w = std::get<2>(*ite);
+  std::size_t base = 0;    // the degree of window bucket 0
 
-    Neighbors edge = make_my_pair(v, w);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    auto&& w = window.local();
+    auto&& o = overflow.local();
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      degree[u] = std::ranges::distance(A[u]);
+      (degree[u] < open ? w[degree[u]] : o).push_back(u);
+    }
+  });
 
-    if (filter.find(edge) == filter.end() && degree[v] < k) {
-      if (--degree[w] == 0) n_vtx--;
-      if (--degree[v] == 0) n_vtx--;
+  std::vector<vertex_id_type> frontier, rest;
+  std::size_t                 peeled = 0;
+  for (std::size_t k = 0; peeled < n; ++k) {
+    if (k == base + open) {
+      // Slide the window and redistribute the overflow.
+      base += open;
+      for (auto&& w : window) {
+        for (auto&& b : w) {
+          b.clear();
+        }
+      }
+      rest.clear();
+      for (auto&& o : overflow) {
+        rest.insert(rest.end(), o.begin(), o.end());
+        o.clear();
+      }
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, rest.size()), [&](auto&& r) {
+        auto&& w = window.local();
+        auto&& o = overflow.local();
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          if (auto u = rest[i]; !removed[u]) {
+            (degree[u] < base + open ? w[degree[u] - base] : o).push_back(u);
+          }
+        }
+      });
+    }
 
-      filter.insert({edge, true});
+    // Open bucket k, skipping vertices whose degree has since dropped further.
+    frontier.clear();
+    for (auto&& w : window) {
+      for (auto u : w[k - base]) {
+        if (!removed[u] && degree[u] == k) {
+          frontier.push_back(u);
+        }
+      }
+      w[k - base].clear();
+    }
+
+    while (!frontier.empty()) {
+      for (auto u : frontier) {
+        removed[u] = true;
+        core[u]    = k;
+      }
+      peeled += frontier.size();
+
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()), [&](auto&& r) {
+        auto&& w = window.local();
+        auto&& f = next.local();
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          for (auto&& edge : A[frontier[i]]) {
+            auto           v = target(A, edge);
+            vertex_id_type d = nw::graph::load<std::memory_order_relaxed>(degree[v]);
+            while (d > k && !nw::graph::cas(degree[v], d, vertex_id_type(d - 1))) {
+            }
+            if (d <= k) {
+              continue;
+            }
+            if (d - 1 == k) {
+              f.push_back(v);
+            } else if (d - 1 < base + open) {
+              w[d - 1 - base].push_back(v);
+            }
+          }
+        }
+      });
+
+      frontier.clear();
+      for (auto&& f : next) {
+        frontier.insert(frontier.end(), f.begin(), f.end());
+        f.clear();
+      }
     }
   }
 
-  /*vertex_id_type new_label = 0;
-  for(size_t i = 0; i < old_n_vtx; ++i) {
-    if(degree[i] != 0){
-      relabel[i] = new_label;
-      new_label++;
+  return core;
+}
+
+/**
+ * @brief Extract the k-core of a graph given its core numbers.
+ *
+ * Keeps the edges whose endpoints both have core number at least k, along
+ * with their attributes.  The vertices keep their ids, so the vertices
+ * outside the k-core are left without neighbors.  The rows are filtered in
+ * parallel.
+ *
+ * @param A The adjacency.
+ * @param core The core numbers, as computed by core_numbers(A).
+ * @param k The value of k in the k core.
+ * @return The k-core, as an adjacency of the same type.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, class... Attributes, class Core>
+auto k_core_subgraph(const index_adjacency<idx, index_type, vertex_id, Attributes...>& A, const Core& core, std::size_t k) {
+  const std::size_t n           = A.size();
+  auto&&            old_indices = A.indices_;
+  auto&&            old_columns = static_cast<const typename struct_of_arrays<vertex_id, Attributes...>::base&>(A.to_be_indexed_);
+  auto&&            targets     = std::get<0>(old_columns);
+
+  std::vector<index_type> indices(n + 1);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      if (core[u] >= k) {
+        indices[u + 1] = std::count_if(targets.begin() + old_indices[u], targets.begin() + old_indices[u + 1],
+                                       [&](auto v) { return core[v] >= k; });
+      }
     }
-    }*/
-
-  // edge_list<undirected> k_core_list(n_vtx);
-  // Graph k_core_graph(n_vtx);
-  // k_core_graph.open_for_pushback();
-  // first = A.begin();
-  // last = A.end();
-
-  /*for(auto G=first; first !=last; ++first) {
-    for (auto v = (*first).begin(); v != (*first).end(); ++v) {
-      Neighbors edge = make_my_pair(first-G,std::get<0>(*v));
-      if(filter.find(edge) != filter.end())
-    std::cout << "removed edge " << first-G << " " << std::get<0>(*v) << " " <<
-  std::endl; else k_core_graph.push_back(relabel[first-G],v);
+  });
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
+
+  std::tuple<std::vector<vertex_id>, std::vector<Attributes>...> columns(std::vector<vertex_id>(indices.back()),
+                                                                         std::vector<Attributes>(indices.back())...);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      if (core[u] < k) {
+        continue;
+      }
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        for (index_type j = old_indices[u], out = indices[u]; j != old_indices[u + 1]; ++j) {
+          if (core[targets[j]] >= k) {
+            std::get<0>(columns)[out] = targets[j];
+            ((std::get<Is + 1>(columns)[out] = std::get<Is + 1>(old_columns)[j]), ...);
+            ++out;
+          }
+        }
+      }(std::index_sequence_for<Attributes...>());
+    }
+  });
+
+  return index_adjacency<idx, index_type, vertex_id, Attributes...>(std::move(indices), std::move(columns));
+}
+
+/**
+ * @brief Find the k core of a graph.
+ *
+ * A convenience wrapper around core_numbers() that reports the edges removed
+ * from the graph to obtain the k core.
+ * 
+ * @tparam Graph Type of the graph.  Must meet requirements of adjacency_list_graph concept.
+ * @param A Input graph.
+ * @param k The value of k in the k core.
+ * @return std::tuple<Unordered_map, size_t> of an Unordered_map (the removed edges), and the number of vertices in k core.
+ */
+template <adjacency_list_graph Graph>
+std::tuple<Unordered_map, size_t> k_core(const Graph& A, int k) {
+  auto core = core_numbers(A);
+
+  Unordered_map filter;
+  for (std::size_t u = 0; u < A.size(); ++u) {
+    for (auto&& e : A[u]) {
+      auto v = target(A, e);
+      if (std::min<long>(core[u], core[v]) < k) {
+        filter.insert({make_my_pair(u, v), true});
+      }
     }
   }
-  */
 
+  size_t n_vtx = std::count_if(core.begin(), core.end(), [k](auto c) { return long(c) >= k; });
   return std::make_tuple(filter, n_vtx);
 }
 
@@ -14,22 +14,273 @@
 #ifndef NW_GRAPH_K_TRUSS_HPP
 #define NW_GRAPH_K_TRUSS_HPP
 
-#include "nwgraph/adaptors/cyclic_range_adapter.hpp"
-#include "nwgraph/util/parallel_for.hpp"
-#include <atomic>
-#include <future>
-#include <thread>
-
-#include "nwgraph/adaptors/edge_range.hpp"
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/util/atomic.hpp"
 #include "nwgraph/util/intersection_size.hpp"
-#include "util/timer.hpp"
 #include "nwgraph/util/util.hpp"
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numeric>
 #include <tuple>
 #include <vector>
 
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+
 namespace nw {
-namespace graph {}    // namespace graph
+namespace graph {
+
+namespace detail {
+
+/// The transpose of an upper triangular adjacency, where every entry also
+/// records the id of its edge, i.e., its position in the upper triangular
+/// adjacency.  The rows are sorted.
+template <std::unsigned_integral index_type, std::unsigned_integral vertex_id, class Upper>
+auto lower_with_edge_ids(const Upper& U) {
+  const std::size_t n       = U.size();
+  auto&&            indices = U.indices_;
+  auto&&            targets = std::get<0>(U.to_be_indexed_);
+
+  std::vector<index_type> counts(n + 1);
+  for (auto v : targets) {
+    ++counts[v + 1];
+  }
+  std::inclusive_scan(counts.begin(), counts.end(), counts.begin());
+
+  std::vector<index_type> lower_indices = counts;
+  std::vector<vertex_id>  sources(indices.back());
+  std::vector<index_type> ids(indices.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      for (index_type j = indices[u]; j != indices[u + 1]; ++j) {
+        index_type k = nw::graph::fetch_add(counts[targets[j]], index_type(1));
+        sources[k]   = u;
+        ids[k]       = j;
+      }
+    }
+  });
+
+  // Rows were filled concurrently, so put them back in order.
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    std::vector<std::tuple<vertex_id, index_type>> row;
+    for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+      row.clear();
+      for (index_type k = lower_indices[v]; k != lower_indices[v + 1]; ++k) {
+        row.emplace_back(sources[k], ids[k]);
+      }
+      std::sort(row.begin(), row.end());
+      for (index_type k = lower_indices[v], i = 0; k != lower_indices[v + 1]; ++k, ++i) {
+        std::tie(sources[k], ids[k]) = row[i];
+      }
+    }
+  });
+
+  return index_adjacency<0, index_type, vertex_id, index_type>(std::move(lower_indices), std::move(sources), std::move(ids));
+}
+
+}    // namespace detail
+
+/**
+ * @brief Parallel truss decomposition.
+ *
+ * Computes the trussness of every edge, i.e., the largest k such that the
+ * edge belongs to the k-truss, the largest subgraph in which every edge is in
+ * at least k - 2 triangles.
+ *
+ * The support of every edge (u, v) is the number of common neighbors of u and
+ * v, computed with intersection_size over the upper and lower triangular
+ * halves of their neighborhoods.  Edges are then peeled level by level, as in
+ * PKT: the edges whose support equals the current level are removed together
+ * in parallel rounds, and every triangle they close with two remaining edges
+ * decrements the support of those edges with an atomic compare-and-swap,
+ * never below the current level.  A triangle with two edges in the same round
+ * is only counted once, by the edge with the smaller id.
+ *
+ * @param U An upper triangular adjacency of a simple undirected graph, with sorted rows, e.g., built from an edge list after
+ *          simplify_triangular(el, succession::successor).
+ * @return The trussness of every edge, in the order of the edges of U.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, class... Attributes>
+auto truss_numbers(const index_adjacency<idx, index_type, vertex_id, Attributes...>& U) {
+  const std::size_t n       = U.size();
+  const std::size_t m       = U.indices_.back();
+  auto&&            indices = U.indices_;
+  auto&&            targets = std::get<0>(U.to_be_indexed_);
+  auto              L       = detail::lower_with_edge_ids<index_type, vertex_id>(U);
+  auto&&            sources = std::get<0>(L.to_be_indexed_);
+  auto&&            ids     = std::get<1>(L.to_be_indexed_);
+
+  std::vector<vertex_id> source(m);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      std::fill(source.begin() + indices[u], source.begin() + indices[u + 1], u);
+    }
+  });
+
+  // Support: for u < v, the common neighbors below u, between u and v, and above v.
+  std::vector<vertex_id> support(m);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, m), [&](auto&& r) {
+    for (auto e = r.begin(), ee = r.end(); e != ee; ++e) {
+      auto u = source[e], v = targets[e];
+      support[e] = intersection_size(L[u], L[v]) + intersection_size(U[u], L[v]) + intersection_size(U[u], U[v]);
+    }
+  });
+
+  // Visit the common neighbors w of u and v, with the ids of the edges (u, w)
+  // and (v, w).  The neighborhood of a vertex is its lower row followed by
+  // its upper row, which is sorted.
+  auto for_each_common = [&](vertex_id u, vertex_id v, auto&& f) {
+    auto neighbor = [&](vertex_id x, index_type i) -> std::tuple<vertex_id, index_type> {
+      index_type lower = L.indices_[x + 1] - L.indices_[x];
+      if (i < lower) {
+        return {sources[L.indices_[x] + i], ids[L.indices_[x] + i]};
+      }
+      index_type j = indices[x] + i - lower;
+      return {targets[j], j};
+    };
+    index_type nu = L.indices_[u + 1] - L.indices_[u] + indices[u + 1] - indices[u];
+    index_type nv = L.indices_[v + 1] - L.indices_[v] + indices[v + 1] - indices[v];
+    for (index_type i = 0, j = 0; i < nu && j < nv;) {
+      auto [x, ex] = neighbor(u, i);
+      auto [y, ey] = neighbor(v, j);
+      if (x < y) {
+        ++i;
+      } else if (y < x) {
+        ++j;
+      } else {
+        f(x, ex, ey);
+        ++i;
+        ++j;
+      }
+    }
+  };
+
+  constexpr char alive = 0, current = 1, removed = 2;
+
+  std::vector<vertex_id> truss(m);
+  std::vector<char>      state(m, alive);
+  std::vector<index_type> remaining(m), frontier;
+  std::iota(remaining.begin(), remaining.end(), 0);
+
+  tbb::enumerable_thread_specific<std::vector<index_type>> next;
+
+  while (!remaining.empty()) {
+    // The lowest support among the remaining edges is the next level.
+    vertex_id level = tbb::parallel_reduce(
+        tbb::blocked_range<std::size_t>(0, remaining.size()), std::numeric_limits<vertex_id>::max(),
+        [&](auto&& r, vertex_id s) {
+          for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+            s = std::min(s, support[remaining[i]]);
+          }
+          return s;
+        },
+        [](vertex_id a, vertex_id b) { return std::min(a, b); });
+
+    frontier.clear();
+    std::copy_if(remaining.begin(), remaining.end(), std::back_inserter(frontier), [&](auto e) { return support[e] == level; });
+
+    while (!frontier.empty()) {
+      for (auto e : frontier) {
+        state[e] = current;
+        truss[e] = level + 2;
+      }
+
+      auto decrement = [&](index_type e, auto&& f) {
+        vertex_id s = nw::graph::load<std::memory_order_relaxed>(support[e]);
+        while (s > level && !nw::graph::cas(support[e], s, vertex_id(s - 1))) {
+        }
+        if (s == level + 1) {
+          f.push_back(e);
+        }
+      };
+
+      tbb::parallel_for(tbb::blocked_range<std::size_t>(0, frontier.size()), [&](auto&& r) {
+        auto&& f = next.local();
+        for (auto i = r.begin(), ie = r.end(); i != ie; ++i) {
+          index_type e = frontier[i];
+          for_each_common(source[e], targets[e], [&](vertex_id, index_type e1, index_type e2) {
+            if (state[e1] == removed || state[e2] == removed) {
+              return;
+            }
+            if (state[e1] == alive && state[e2] == alive) {
+              decrement(e1, f);
+              decrement(e2, f);
+            } else if (state[e1] == alive) {
+              if (e < e2) {
+                decrement(e1, f);
+              }
+            } else if (state[e2] == alive) {
+              if (e < e1) {
+                decrement(e2, f);
+              }
+            }
+          });
+        }
+      });
+
+      for (auto e : frontier) {
+        state[e] = removed;
+      }
+      frontier.clear();
+      for (auto&& f : next) {
+        frontier.insert(frontier.end(), f.begin(), f.end());
+        f.clear();
+      }
+    }
+
+    std::erase_if(remaining, [&](auto e) { return state[e] == removed; });
+  }
+
+  return truss;
+}
+
+/**
+ * @brief Extract the k-truss of a graph given its edge trussness.
+ *
+ * @param U An upper triangular adjacency.
+ * @param truss The trussness of the edges of U, as computed by truss_numbers(U).
+ * @param k The value of k in the k truss.
+ * @return The edges of the k truss, as an upper triangular adjacency with the same vertex ids and the attributes of U.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, class... Attributes, class Truss>
+auto k_truss(const index_adjacency<idx, index_type, vertex_id, Attributes...>& U, const Truss& truss, std::size_t k) {
+  const std::size_t n           = U.size();
+  auto&&            old_indices = U.indices_;
+  auto&&            old_columns = static_cast<const typename struct_of_arrays<vertex_id, Attributes...>::base&>(U.to_be_indexed_);
+
+  std::vector<index_type> indices(n + 1);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      indices[u + 1] = std::count_if(truss.begin() + old_indices[u], truss.begin() + old_indices[u + 1], [&](auto t) { return t >= k; });
+    }
+  });
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
+
+  std::tuple<std::vector<vertex_id>, std::vector<Attributes>...> columns(std::vector<vertex_id>(indices.back()),
+                                                                         std::vector<Attributes>(indices.back())...);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        for (index_type j = old_indices[u], out = indices[u]; j != old_indices[u + 1]; ++j) {
+          if (truss[j] >= k) {
+            std::get<0>(columns)[out] = std::get<0>(old_columns)[j];
+            ((std::get<Is + 1>(columns)[out] = std::get<Is + 1>(old_columns)[j]), ...);
+            ++out;
+          }
+        }
+      }(std::index_sequence_for<Attributes...>());
+    }
+  });
+
+  return index_adjacency<idx, index_type, vertex_id, Attributes...>(std::move(indices), std::move(columns));
+}
+
+}    // namespace graph
 }    // namespace nw
 
 #endif    // NW_GRAPH_K_TRUSS_HPP
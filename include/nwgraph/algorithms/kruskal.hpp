@@ -15,7 +15,13 @@
 #define NW_GRAPH_KRUSKAL_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <execution>
 #include <tuple>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
 
 #include "nwgraph/graph_concepts.hpp"
 #include "nwgraph/util/disjoint_set.hpp"
@@ -50,23 +56,75 @@ EdgeListT kruskal(EdgeListT& E) {
  */
 template <edge_list_graph EdgeListT, typename Compare>
 EdgeListT kruskal(EdgeListT& E, Compare comp) {
-  size_t    n_vtx = E.size();
+  using vertex_id_type = vertex_id_t<EdgeListT>;
+
+  size_t    n_vtx = num_vertices(E);
   EdgeListT T(n_vtx);
   std::sort(E.begin(), E.end(), comp);
 
-  std::vector<std::pair<vertex_id_type, size_t>> subsets(n_vtx);
-  for (size_t i = 0; i < n_vtx; ++i) {
-    subsets[i].first  = i;
-    subsets[i].second = 0;
-  }
-
+  disjoint_set<vertex_id_type> sets(n_vtx);
   for (auto y : E) {
-    //    auto u = std::get<0>(y);
-    //    auto v = std::get<1>(y);
-
     auto u = source(E, y);
     auto v = target(E, y);
-    if (disjoint_union_find(subsets, u, v)) T.push_back(y);
+    if (sets.unite(u, v)) T.push_back(y);
+  }
+
+  return T;
+}
+
+/**
+ * @brief A wrapper function to avoid pass compare function as an arg.
+ *
+ * @tparam EdgeListT the edge_list_graph graph type
+ * @param E input edge list
+ * @return EdgeListT output edge list of the minimum spanning tree
+ */
+template <edge_list_graph EdgeListT>
+EdgeListT parallel_kruskal(EdgeListT& E) {
+  return parallel_kruskal(E, [](auto t1, auto t2) { return std::get<2>(t1) < std::get<2>(t2); });
+}
+
+/**
+ * @brief A parallel (filter) Kruskal's algorithm to find a minimum spanning forest of an undirected edge-weighted graph.
+ *
+ * The edges are sorted in parallel and visited in chunks of doubling size.
+ * The edges of a chunk whose endpoints the forest already connects are
+ * dropped in parallel with concurrent queries to the disjoint_set, and only
+ * the rest are united in order, so the sequential part shrinks as the forest
+ * grows.  It stops as soon as the forest spans the graph.
+ *
+ * @tparam EdgeListT the edge_list_graph graph type
+ * @tparam Compare the comparison function type
+ * @param E input edge list
+ * @param comp comparison function object for sorting the input edge list
+ * @return EdgeListT output edge list of the minimum spanning tree, of the same weight as that of kruskal
+ */
+template <edge_list_graph EdgeListT, typename Compare>
+EdgeListT parallel_kruskal(EdgeListT& E, Compare comp) {
+  using vertex_id_type = vertex_id_t<EdgeListT>;
+
+  size_t    n_vtx = num_vertices(E);
+  EdgeListT T(n_vtx);
+  std::sort(std::execution::par_unseq, E.begin(), E.end(), comp);
+
+  disjoint_set<vertex_id_type> sets(n_vtx);
+  std::vector<char>            candidate;
+  size_t                       merges = 0;
+  for (size_t begin = 0, chunk = 1024; begin < E.size() && merges + 1 < n_vtx; begin += chunk, chunk *= 2) {
+    size_t end = std::min(begin + chunk, E.size());
+    candidate.resize(end - begin);
+    tbb::parallel_for(tbb::blocked_range<size_t>(begin, end), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        auto&& y             = E.begin()[i];
+        candidate[i - begin] = !sets.same(source(E, y), target(E, y));
+      }
+    });
+    for (size_t i = begin; i < end; ++i) {
+      if (auto&& y = E.begin()[i]; candidate[i - begin] && sets.unite(source(E, y), target(E, y))) {
+        T.push_back(y);
+        ++merges;
+      }
+    }
   }
 
   return T;
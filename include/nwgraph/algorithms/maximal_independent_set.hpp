@@ -18,6 +18,21 @@
 
 #include "nwgraph/graph_concepts.hpp"
 #include "nwgraph/adaptors/bfs_range.hpp"
+#include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/radix_sort.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
 
 namespace nw {
 namespace graph {
@@ -45,6 +60,145 @@ void maximal_independent_set(const Graph& A, std::vector<size_t>& mis) {
     }
   }
 }
+namespace detail {
+
+/**
+ * @brief The lexicographically first maximal independent set for a vertex order, in parallel.
+ *
+ * This is the deterministic-reservation algorithm of Blelloch, Fineman and
+ * Shun: a vertex joins the set once every neighbor that precedes it has left,
+ * and leaves once a neighbor joins.  Every round scans the active (undecided)
+ * vertices in parallel, lets the ones with no undecided predecessor join,
+ * marks their neighbors out, and shrinks the active list.  A vertex resumes
+ * scanning its row where it last stopped, so each edge is passed over once.
+ * The states are atomic bytes.  For a random order this is Luby's algorithm,
+ * with O(log^2 n) rounds with high probability.
+ *
+ * The rows scanned for predecessors and the rows marked out may differ, e.g.,
+ * the two directions of a DAG that already encodes the order.
+ *
+ * @param P The graph whose rows hold (at least) the predecessors of each vertex, with random access rows.
+ * @param S The graph whose rows hold (at least) the successors of each vertex.
+ * @param before Whether vertex u precedes vertex v.
+ * @return The states of the vertices, where 1 means in the set.
+ */
+template <class Preds, class Succs, class Before>
+std::vector<std::uint8_t> ordered_mis(const Preds& P, const Succs& S, Before&& before) {
+  enum : std::uint8_t { undecided, in, out };
+
+  const std::size_t         N = P.size();
+  std::vector<std::uint8_t> state(N, undecided);
+  std::vector<std::size_t>  resume(N, 0);
+  std::vector<std::size_t>  active(N), joined;
+  std::iota(active.begin(), active.end(), 0);
+
+  tbb::enumerable_thread_specific<std::vector<std::size_t>> local;
+
+  while (!active.empty()) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, active.size()), [&](auto&& r) {
+      auto&& mine = local.local();
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::size_t u     = active[i];
+        auto&&      row   = P[u];
+        auto        first = std::ranges::begin(row);
+        auto        size  = std::ranges::distance(row);
+        auto&&      k     = resume[u];
+        for (; k < std::size_t(size); ++k) {
+          std::size_t v = target(P, *(first + k));
+          if (v != u && before(v, u) && nw::graph::load<std::memory_order_relaxed>(state[v]) != out) {
+            break;
+          }
+        }
+        if (k == std::size_t(size)) {
+          mine.push_back(u);
+        }
+      }
+    });
+
+    joined.clear();
+    for (auto&& mine : local) {
+      joined.insert(joined.end(), mine.begin(), mine.end());
+      mine.clear();
+    }
+
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, joined.size()), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        state[joined[i]] = in;
+      }
+    });
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, joined.size()), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::size_t u = joined[i];
+        for (auto&& edge : S[u]) {
+          if (std::size_t v = target(S, edge); v != u) {
+            nw::graph::store<std::memory_order_relaxed>(state[v], std::uint8_t(out));
+          }
+        }
+      }
+    });
+
+    std::erase_if(active, [&](auto u) { return state[u] != undecided; });
+  }
+
+  return state;
+}
+
+/// The lexicographically first maximal independent set of a symmetric graph A for a vertex order.
+template <class Graph, class Before>
+std::vector<std::uint8_t> ordered_mis(const Graph& A, Before&& before) {
+  return ordered_mis(A, A, std::forward<Before>(before));
+}
+
+/// The vertices whose state is in, in increasing order, packed in parallel.
+template <class Vertex>
+std::vector<Vertex> pack_mis(const std::vector<std::uint8_t>& state) {
+  radix_chunks             chunks(state.size());
+  std::vector<std::size_t> counts(chunks.size() + 1);
+  chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+    counts[c + 1] = std::count(state.begin() + i, state.begin() + e, 1);
+  });
+  std::inclusive_scan(counts.begin(), counts.end(), counts.begin());
+
+  std::vector<Vertex> mis(counts.back());
+  chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+    for (std::size_t k = counts[c]; i != e; ++i) {
+      if (state[i] == 1) {
+        mis[k++] = i;
+      }
+    }
+  });
+  return mis;
+}
+
+}    // namespace detail
+
+/**
+ * @brief A parallel maximal independent set with random priorities (Luby).
+ *
+ * Computes the lexicographically first maximal independent set for a random
+ * order of the vertices (given by a hash of the vertex ids and the seed), so
+ * the result is deterministic for a seed regardless of the number of threads.
+ *
+ * @tparam Graph input adjacency_list_graph type
+ * @param A input graph, which must be symmetric
+ * @param seed the seed of the random order
+ * @return the vertices of the maximal independent set, in increasing order
+ */
+template <adjacency_list_graph Graph>
+std::vector<vertex_id_t<Graph>> luby_mis(const Graph& A, std::uint64_t seed = 0) {
+  auto priority = [seed](std::uint64_t u) {
+    std::uint64_t h = (u + seed) * 0x9e3779b97f4a7c15ull;
+    h               = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h               = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+  };
+  auto state = detail::ordered_mis(A, [&](std::size_t u, std::size_t v) {
+    auto pu = priority(u), pv = priority(v);
+    return pu < pv || (pu == pv && u < v);
+  });
+  return detail::pack_mis<vertex_id_t<Graph>>(state);
+}
+
 }    // namespace graph
 }    // namespace nw
 #endif    // NW_GRAPH_MIS_HPP
@@ -17,17 +17,24 @@
 #define NW_GRAPH_PAGE_RANK_HPP
 
 #include <cmath>
+#include <concepts>
 #include <future>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
+#include <tbb/task_arena.h>
+
 #include "nwgraph/graph_concepts.hpp"
 #include "nwgraph/adaptors/edge_range.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/edge_list.hpp"
+#include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/frontier.hpp"
 #include "nwgraph/util/parallel_for.hpp"
 #include "nwgraph/adaptors/vertex_range.hpp"
 
@@ -73,6 +80,90 @@ auto time_op(Op&& op) {
 }
 }    // namespace pagerank
 
+namespace pagerank {
+namespace detail {
+
+/// The raw offset and neighbor arrays of a compressed or mapped adjacency.
+template <class Graph>
+auto csr(const Graph& graph) {
+  if constexpr (requires { graph.indices(); }) {
+    return std::tuple(graph.indices(), std::get<0>(graph.columns()));
+  } else {
+    return std::tuple(graph.indices_.data(), std::get<0>(graph.to_be_indexed_).data());
+  }
+}
+
+/// Call f with the teleport probability function, uniform when the teleport
+/// vector is empty, so that the kernels are instantiated without a branch.
+template <class Real, class F>
+decltype(auto) with_teleport(std::span<const Real> teleport, std::size_t N, F&& f) {
+  if (teleport.empty()) {
+    return f([uniform = Real(1) / N](std::size_t) { return uniform; });
+  } else {
+    return f([teleport](std::size_t v) { return teleport[v]; });
+  }
+}
+
+/// Jacobi iteration over the in-edges of each vertex.
+template <class Real, class Graph, class Degree>
+std::size_t pull(const Graph& in_graph, const Degree* degrees, std::span<Real> rank, Real damping, double tolerance, std::size_t max_iters,
+                 std::span<const Real> teleport) {
+  const std::size_t N                 = num_vertices(in_graph);
+  auto [offsets, sources]             = csr(in_graph);
+  std::unique_ptr<Real[]> contrib(new Real[N]);
+
+  return with_teleport(teleport, N, [&](auto&& t) {
+    tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        rank[v] = t(v);
+      }
+    });
+
+    for (std::size_t iter = 0; iter < max_iters; ++iter) {
+      // Spread the rank of each vertex over its out edges; the rank of
+      // dangling vertices is redistributed through the teleport vector.
+      Real dangling = tbb::parallel_reduce(
+          tbb::blocked_range(0ul, N), Real(0),
+          [&](auto&& r, Real sum) {
+            for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+              if (degrees[u]) {
+                contrib[u] = rank[u] / degrees[u];
+              } else {
+                contrib[u] = 0;
+                sum += rank[u];
+              }
+            }
+            return sum;
+          },
+          std::plus{});
+
+      double error = tbb::parallel_reduce(
+          tbb::blocked_range(0ul, N), 0.0,
+          [&](auto&& r, double sum) {
+            for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+              Real z = 0;
+              for (auto k = offsets[v], ke = offsets[v + 1]; k != ke; ++k) {
+                z += contrib[sources[k]];
+              }
+              Real next = (1 - damping) * t(v) + damping * (z + dangling * t(v));
+              sum += std::abs(next - rank[v]);
+              rank[v] = next;
+            }
+            return sum;
+          },
+          std::plus{});
+
+      if (error < tolerance) {
+        return iter + 1;
+      }
+    }
+    return max_iters;
+  });
+}
+
+}    // namespace detail
+}    // namespace pagerank
+
 /**
  * @brief Parallel page rank.
  * 
@@ -84,67 +175,227 @@ auto time_op(Op&& op) {
  * @param damping_factor the probability that an imaginary surfer stops clicking
  * @param threshold error threshold to control converge rate
  * @param max_iters maximum number of iterations to converge
- * @param num_threads number of threads
+ * @param num_threads number of threads, or 0 to use the current task arena
  */
 template <adjacency_list_graph Graph, typename Real>
 [[gnu::noinline]] void page_rank(const Graph& graph, const std::vector<typename Graph::vertex_id_type>& degrees,
                                      std::vector<Real>& page_rank, Real damping_factor, Real threshold, size_t max_iters, size_t num_threads) {
-  std::size_t N          = graph.size();
-  Real        init_score = 1.0 / N;
-  Real        base_score = (1.0 - damping_factor) / N;
+  // Run on num_threads threads, or on the current arena when it is 0.
+  auto run = [&] {
+    std::size_t N          = graph.size();
+    Real        init_score = 1.0 / N;
+    Real        base_score = (1.0 - damping_factor) / N;
 
-  {
-    nw::util::life_timer _("init page rank");
+    {
+      nw::util::life_timer _("init page rank");
 
-    // Initialize the page rank.
-    tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
-      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
-        page_rank[i] = init_score;
+      // Initialize the page rank.
+      tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          page_rank[i] = init_score;
+        }
+      });
+    }
+
+    std::unique_ptr<Real[]> outgoing_contrib(new Real[N]);
+
+    pagerank::trace("iter", "error", "time", "outgoing");
+
+    {
+      nw::util::life_timer _("init contrib");
+
+      tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          outgoing_contrib[i] = page_rank[i] / degrees[i];
+        }
+      });
+    }
+
+    for (size_t iter = 0; iter < max_iters; ++iter) {
+
+      auto&& [time, error] = pagerank::time_op([&] {
+        return tbb::parallel_reduce(
+            tbb::blocked_range(0ul, N), 0.0,
+            [&](auto&& r, auto partial_sum) {
+              for (size_t i = r.begin(), e = r.end(); i != e; ++i) {
+                Real z = 0.0;
+                for (auto&& j : graph[i]) {
+                  z += outgoing_contrib[std::get<0>(j)];
+                }
+                auto old_rank = page_rank[i];
+                page_rank[i]  = base_score + damping_factor * z;
+                partial_sum += fabs(page_rank[i] - old_rank);
+                outgoing_contrib[i] = page_rank[i] / (Real)degrees[i];
+              }
+              return partial_sum;
+            },
+            std::plus{});
+      });
+
+      pagerank::trace(iter, error, time, 0);
+
+      if (error < threshold) {
+        return;
       }
-    });
+    }
+  };
+
+  if (num_threads) {
+    tbb::task_arena(num_threads).execute(run);
+  } else {
+    run();
   }
+}
 
-  std::unique_ptr<Real[]> outgoing_contrib(new Real[N]);
+/**
+ * @brief Parallel pull-based page rank on the raw arrays of a compressed adjacency.
+ *
+ * Each iteration recomputes the rank of every vertex from the ranks of its in
+ * neighbors.  The rank of vertices without out edges is redistributed through
+ * the teleport vector.
+ *
+ * @tparam Real page rank score type, float or double
+ * @tparam Graph adjacency_list_graph graph type with raw CSR arrays, e.g., adjacency<1> or mapped_adjacency<1>
+ * @param in_graph the in edges of the graph
+ * @param rank output page rank scores, one per vertex
+ * @param damping the probability that an imaginary surfer keeps clicking
+ * @param tolerance stop when the L1 norm of the change of an iteration is smaller than this
+ * @param max_iters maximum number of iterations
+ * @param teleport personalization vector summing to 1, or empty for the uniform distribution
+ * @return the number of iterations performed
+ */
+template <std::floating_point Real = float, adjacency_list_graph Graph>
+std::size_t page_rank_pull(const Graph& in_graph, std::type_identity_t<std::span<Real>> rank, double damping = 0.85, double tolerance = 1e-4,
+                           std::size_t max_iters = 100, std::type_identity_t<std::span<const Real>> teleport = {}) {
+  const std::size_t N       = num_vertices(in_graph);
+  auto [offsets, sources]   = pagerank::detail::csr(in_graph);
+  using index_type          = std::remove_cvref_t<decltype(*offsets)>;
 
-  pagerank::trace("iter", "error", "time", "outgoing");
+  std::vector<index_type> degrees(N);
+  tbb::parallel_for(tbb::blocked_range<index_type>(0, offsets[N]), [&](auto&& r) {
+    for (auto k = r.begin(), e = r.end(); k != e; ++k) {
+      nw::graph::fetch_add<std::memory_order_relaxed>(degrees[sources[k]], 1);
+    }
+  });
 
-  {
-    nw::util::life_timer _("init contrib");
+  return pagerank::detail::pull(in_graph, degrees.data(), rank, Real(damping), tolerance, max_iters, teleport);
+}
 
+/**
+ * @brief Parallel residual-based page rank.
+ *
+ * Every vertex keeps the part of its rank that it has not propagated yet.  A
+ * round propagates the residual of the vertices whose residual exceeds
+ * tolerance / N, and leaves the others alone until they accumulate more.  Rounds
+ * with few active out edges push along the out edges of the active vertices,
+ * the others pull along the in edges of every vertex.  The remaining residuals
+ * are added to the ranks at the end.
+ *
+ * @tparam Real page rank score type, float or double
+ * @tparam OutGraph adjacency_list_graph graph type with raw CSR arrays, e.g., adjacency<0>
+ * @tparam InGraph adjacency_list_graph graph type with raw CSR arrays, e.g., adjacency<1>
+ * @param out_graph the out edges of the graph
+ * @param in_graph the in edges of the graph
+ * @param rank output page rank scores, one per vertex
+ * @param damping the probability that an imaginary surfer keeps clicking
+ * @param tolerance bound on the L1 norm of the residuals left unpropagated
+ * @param max_iters maximum number of rounds
+ * @param teleport personalization vector summing to 1, or empty for the uniform distribution
+ * @return the number of rounds performed
+ */
+template <std::floating_point Real = float, adjacency_list_graph OutGraph, adjacency_list_graph InGraph>
+std::size_t page_rank_delta(const OutGraph& out_graph, const InGraph& in_graph, std::type_identity_t<std::span<Real>> rank, double damping = 0.85,
+                            double tolerance = 1e-4, std::size_t max_iters = 100, std::type_identity_t<std::span<const Real>> teleport = {}) {
+  using vertex_id_type = vertex_id_t<OutGraph>;
+
+  const std::size_t N             = num_vertices(out_graph);
+  auto [out_offsets, targets]     = pagerank::detail::csr(out_graph);
+  auto [in_offsets, sources]      = pagerank::detail::csr(in_graph);
+  const std::size_t M             = out_offsets[N];
+  const Real        d             = damping;
+  const Real        threshold     = tolerance / N;
+  constexpr const std::size_t alpha = 20;
+
+  std::vector<Real>             residual(N), sent(N);
+  sliding_queue<vertex_id_type> frontier(N);
+  auto                          buffers = make_frontier_buffers(frontier);
+
+  return pagerank::detail::with_teleport(teleport, N, [&](auto&& t) {
     tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
-      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
-        outgoing_contrib[i] = page_rank[i] / degrees[i];
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        rank[v]     = 0;
+        residual[v] = (1 - d) * t(v);
       }
     });
-  }
 
-  for (size_t iter = 0; iter < max_iters; ++iter) {
-
-    auto&& [time, error] = pagerank::time_op([&] {
-      return tbb::parallel_reduce(
-          tbb::blocked_range(0ul, N), 0.0,
-          [&](auto&& r, auto partial_sum) {
-            for (size_t i = r.begin(), e = r.end(); i != e; ++i) {
-              Real z = 0.0;
-              for (auto&& j : graph[i]) {
-                z += outgoing_contrib[std::get<0>(j)];
+    std::size_t round = 0;
+    for (; round < max_iters; ++round) {
+      // Retire the residual of the active vertices into their rank, and
+      // compute what they send along each out edge.
+      frontier.reset();
+      auto [active_edges, dangling] = tbb::parallel_reduce(
+          tbb::blocked_range(0ul, N), std::pair<std::size_t, Real>(0, 0),
+          [&](auto&& r, auto sum) {
+            auto&& local = buffers.local();
+            for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+              sent[u] = 0;
+              if (Real x = residual[u]; x > threshold) {
+                rank[u] += x;
+                residual[u] = 0;
+                if (std::size_t degree = out_offsets[u + 1] - out_offsets[u]) {
+                  sent[u] = d * x / degree;
+                  sum.first += degree;
+                  local.push_back(u);
+                } else {
+                  sum.second += d * x;
+                }
               }
-              auto old_rank = page_rank[i];
-              page_rank[i]  = base_score + damping_factor * z;
-              partial_sum += fabs(page_rank[i] - old_rank);
-              outgoing_contrib[i] = page_rank[i] / (Real)degrees[i];
             }
-            return partial_sum;
+            return sum;
           },
-          std::plus{});
-    });
+          [](auto a, auto b) { return std::pair(a.first + b.first, a.second + b.second); });
+      frontier.flush(buffers);
+      frontier.slide_window();
 
-    pagerank::trace(iter, error, time, 0);
+      if (frontier.empty() && dangling == 0) {
+        break;
+      }
 
-    if (error < threshold) {
-      return;
+      if (active_edges > M / alpha) {
+        tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+          for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+            Real z = dangling * t(v);
+            for (auto k = in_offsets[v], ke = in_offsets[v + 1]; k != ke; ++k) {
+              z += sent[sources[k]];
+            }
+            residual[v] += z;
+          }
+        });
+      } else {
+        tbb::parallel_for(tbb::blocked_range(frontier.begin(), frontier.end()), [&](auto&& r) {
+          for (auto&& u : r) {
+            for (auto k = out_offsets[u], ke = out_offsets[u + 1]; k != ke; ++k) {
+              nw::graph::fetch_add<std::memory_order_relaxed>(residual[targets[k]], sent[u]);
+            }
+          }
+        });
+        if (dangling != 0) {
+          tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+            for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+              residual[v] += dangling * t(v);
+            }
+          });
+        }
+      }
     }
-  }
+
+    tbb::parallel_for(tbb::blocked_range(0ul, N), [&](auto&& r) {
+      for (auto v = r.begin(), e = r.end(); v != e; ++v) {
+        rank[v] += residual[v];
+      }
+    });
+    return round;
+  });
 }
 
 }    // namespace graph
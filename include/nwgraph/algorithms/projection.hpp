@@ -0,0 +1,171 @@
+/**
+ * @file projection.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_PROJECTION_HPP
+#define NW_GRAPH_PROJECTION_HPP
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/graph_traits.hpp"
+#include "nwgraph/util/defaults.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace nw {
+namespace graph {
+
+/// What a projected edge (u, w) carries.
+enum class projection_value {
+  none,       //!< nothing, just the structure
+  overlap,    //!< the number of shared neighbors of u and w
+  witness     //!< one shared neighbor of u and w (the first one in u's row)
+};
+
+/**
+ * @brief One-mode projection of a bipartite graph (s-overlap line graph).
+ *
+ * Connects two vertices u != w of one side of a bipartite graph when they share
+ * at least s neighbors on the other side.  With hyperedges as the projected
+ * side this is the s-line graph of a hypergraph, and with s = 1 it is the
+ * usual co-occurrence network (e.g., actors who appeared in a movie together).
+ *
+ * The rows are computed in parallel.  Every thread accumulates the two-hop
+ * counts of a row in its own dense array, remembering which entries it
+ * touched, so no pair is ever materialized more than once and the result is
+ * written straight into a CSR adjacency with sorted rows.
+ *
+ * @tparam Value What the projected edges carry.
+ * @param out The side being projected, with rows of neighbors on the other side, e.g., biadjacency<0>.
+ * @param back The other side, with rows of neighbors on the projected side, e.g., biadjacency<1>.
+ * @param s The minimum number of shared neighbors.
+ * @return adjacency<0> for projection_value::none, adjacency<0, std::size_t> otherwise.
+ */
+template <projection_value Value = projection_value::overlap, adjacency_list_graph Out, adjacency_list_graph Back>
+auto bipartite_projection(const Out& out, const Back& back, std::size_t s = 1) {
+  using vertex_id_type = default_vertex_id_type;
+  using index_type     = default_index_t;
+
+  const std::size_t n = out.size();
+  s                   = std::max<std::size_t>(s, 1);
+
+  struct accumulator {
+    std::vector<std::uint32_t>  count;
+    std::vector<vertex_id_type> witness;
+    std::vector<vertex_id_type> touched;
+  };
+  tbb::enumerable_thread_specific<accumulator> accumulators([n] {
+    accumulator a;
+    a.count.resize(n);
+    if constexpr (Value == projection_value::witness) {
+      a.witness.resize(n);
+    }
+    return a;
+  });
+
+  // Rows are processed in many more chunks than threads, since the work of a
+  // row grows with the square of its degree.  Each chunk buffers its rows.
+  struct part {
+    std::vector<vertex_id_type> targets;
+    std::vector<std::size_t>    values;
+  };
+  const std::size_t       num_parts = std::clamp<std::size_t>(n / 64, 1, 64 * tbb::this_task_arena::max_concurrency());
+  std::vector<part>       parts(num_parts);
+  std::vector<index_type> indices(n + 1);
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_parts, 1), [&](auto&& r) {
+    auto&& [count, witness, touched] = accumulators.local();
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto&& [targets, values] = parts[c];
+      for (std::size_t u = n * c / num_parts, ue = n * (c + 1) / num_parts; u != ue; ++u) {
+        for (auto&& e : out[u]) {
+          auto v = target(out, e);
+          for (auto&& f : back[v]) {
+            if (auto w = target(back, f); w != u && count[w]++ == 0) {
+              touched.push_back(w);
+              if constexpr (Value == projection_value::witness) {
+                witness[w] = v;
+              }
+            }
+          }
+        }
+
+        std::sort(touched.begin(), touched.end());
+        std::size_t degree = 0;
+        for (auto w : touched) {
+          if (count[w] >= s) {
+            targets.push_back(w);
+            if constexpr (Value == projection_value::overlap) {
+              values.push_back(count[w]);
+            } else if constexpr (Value == projection_value::witness) {
+              values.push_back(witness[w]);
+            }
+            ++degree;
+          }
+          count[w] = 0;
+        }
+        touched.clear();
+        indices[u + 1] = degree;
+      }
+    }
+  });
+
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
+
+  std::vector<vertex_id_type> targets(indices.back());
+  std::vector<std::size_t>    values(Value == projection_value::none ? 0 : indices.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_parts, 1), [&](auto&& r) {
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto offset = indices[n * c / num_parts];
+      std::copy(parts[c].targets.begin(), parts[c].targets.end(), targets.begin() + offset);
+      std::copy(parts[c].values.begin(), parts[c].values.end(), values.begin() + offset);
+      parts[c] = {};
+    }
+  });
+
+  if constexpr (Value == projection_value::none) {
+    return adjacency<0>(std::move(indices), std::move(targets));
+  } else {
+    return adjacency<0, std::size_t>(std::move(indices), std::move(targets), std::move(values));
+  }
+}
+
+/**
+ * @brief The s-line graph of a hypergraph.
+ *
+ * Connects two hyperedges that share at least s nodes, weighted by the number
+ * of shared nodes.
+ *
+ * @param edges The hyperedges, with rows of nodes, e.g., biadjacency<0>.
+ * @param nodes The nodes, with rows of hyperedges, e.g., biadjacency<1>.
+ * @param s The minimum number of shared nodes.
+ * @return adjacency<0, std::size_t> of the hyperedges, weighted by their overlap.
+ */
+template <adjacency_list_graph Edges, adjacency_list_graph Nodes>
+auto s_line_graph(const Edges& edges, const Nodes& nodes, std::size_t s = 1) {
+  return bipartite_projection<projection_value::overlap>(edges, nodes, s);
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_PROJECTION_HPP
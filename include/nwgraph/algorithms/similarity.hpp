@@ -0,0 +1,328 @@
+/**
+ * @file similarity.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_SIMILARITY_HPP
+#define NW_GRAPH_SIMILARITY_HPP
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/defaults.hpp"
+#include "nwgraph/util/intersection_size.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace nw {
+namespace graph {
+
+/// Neighborhood similarity measures, for vertices u and v with c common neighbors.
+enum class similarity_measure {
+  jaccard,       //!< c / |N(u) ∪ N(v)|
+  cosine,        //!< c / sqrt(|N(u)| |N(v)|)
+  overlap,       //!< c / min(|N(u)|, |N(v)|)
+  adamic_adar    //!< the sum of 1 / log |N(w)| over the common neighbors w
+};
+
+namespace detail {
+
+/// Split the vertices into contiguous parts of about equal total work, e.g.,
+/// degree, so that a few hubs do not end up in one task.
+inline std::vector<std::size_t> balanced_parts(const std::vector<std::size_t>& work) {
+  const std::size_t        n = work.size();
+  std::vector<std::size_t> prefix(n + 1);
+  std::inclusive_scan(work.begin(), work.end(), prefix.begin() + 1);
+
+  const std::size_t        num_parts = std::clamp<std::size_t>(n / 16, 1, 16 * tbb::this_task_arena::max_concurrency());
+  std::vector<std::size_t> parts(num_parts + 1, n);
+  parts[0] = 0;
+  for (std::size_t p = 1; p < num_parts; ++p) {
+    parts[p] = std::lower_bound(prefix.begin(), prefix.end(), prefix.back() * p / num_parts) - prefix.begin();
+    parts[p] = std::max(parts[p], parts[p - 1]);
+  }
+  return parts;
+}
+
+template <class Graph>
+std::vector<std::size_t> degrees_of(const Graph& G) {
+  std::vector<std::size_t> degrees(G.size());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, degrees.size()), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      degrees[u] = std::ranges::distance(G[u]);
+    }
+  });
+  return degrees;
+}
+
+/// The score of a pair of vertices from their common neighbors c (or, for
+/// Adamic-Adar, the sum of their weights) and their degrees.
+template <similarity_measure Measure>
+double similarity_score(double c, std::size_t du, std::size_t dv) {
+  if constexpr (Measure == similarity_measure::jaccard) {
+    return c / double(du + dv - c);
+  } else if constexpr (Measure == similarity_measure::cosine) {
+    return c / std::sqrt(double(du) * double(dv));
+  } else if constexpr (Measure == similarity_measure::overlap) {
+    return c / double(std::min(du, dv));
+  } else {
+    return c;
+  }
+}
+
+/// 1 / log |N(w)|, the Adamic-Adar weight of a common neighbor w, which has degree at least 2.
+inline std::vector<double> adamic_adar_weights(const std::vector<std::size_t>& degrees) {
+  std::vector<double> weights(degrees.size());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, degrees.size()), [&](auto&& r) {
+    for (auto w = r.begin(), e = r.end(); w != e; ++w) {
+      weights[w] = degrees[w] > 1 ? 1.0 / std::log(double(degrees[w])) : 0.0;
+    }
+  });
+  return weights;
+}
+
+/// The default edge selection of for_each_similarity, which scores every edge.
+struct all_edges {
+  constexpr bool operator()(std::size_t, std::size_t) const { return true; }
+};
+
+}    // namespace detail
+
+/**
+ * @brief Score every edge of a graph by the similarity of its end points.
+ *
+ * Calls f(u, e, score) for every edge e of every row u, in parallel.  The
+ * rows are split into tasks of about equal numbers of edges.  The common
+ * neighbors are counted with intersection_size (the vectorized kernels for
+ * compressed adjacencies), or merged and weighted for Adamic-Adar.
+ *
+ * @tparam Measure The similarity measure.
+ * @param G A symmetric graph with sorted rows.
+ * @param f The callback, which may modify the edge e.
+ * @param keep A predicate on (u, v) that selects the edges to score, e.g., to
+ *             score each undirected edge once; the others are skipped before
+ *             their end points are intersected.
+ */
+template <similarity_measure Measure, class Graph, class F, class Keep = detail::all_edges>
+requires adjacency_list_graph<std::remove_cvref_t<Graph>>
+void for_each_similarity(Graph&& G, F&& f, Keep&& keep = {}) {
+  auto degrees = detail::degrees_of(G);
+  auto parts   = detail::balanced_parts(degrees);
+
+  std::vector<double> weights;
+  if constexpr (Measure == similarity_measure::adamic_adar) {
+    weights = detail::adamic_adar_weights(degrees);
+  }
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, parts.size() - 1, 1), [&](auto&& r) {
+    for (auto p = r.begin(), pe = r.end(); p != pe; ++p) {
+      for (std::size_t u = parts[p]; u != parts[p + 1]; ++u) {
+        for (auto&& e : G[u]) {
+          std::size_t v = target(G, e);
+          if (!keep(u, v)) {
+            continue;
+          }
+          double c = 0;
+          if constexpr (Measure == similarity_measure::adamic_adar) {
+            auto i = G[u].begin(), ie = G[u].end();
+            auto j = G[v].begin(), je = G[v].end();
+            while (i != ie && j != je) {
+              auto x = target(G, *i), y = target(G, *j);
+              if (x < y) {
+                ++i;
+              } else if (y < x) {
+                ++j;
+              } else {
+                c += weights[x];
+                ++i;
+                ++j;
+              }
+            }
+          } else {
+            c = intersection_size(G[u], G[v]);
+          }
+          f(u, e, detail::similarity_score<Measure>(c, degrees[u], degrees[v]));
+        }
+      }
+    }
+  });
+}
+
+/**
+ * @brief Score every edge of a graph by the similarity of its end points.
+ *
+ * @tparam Measure The similarity measure.
+ * @param G A symmetric graph with sorted rows.
+ * @return The scores, in the order of the edges of G.
+ */
+template <similarity_measure Measure, adjacency_list_graph Graph>
+std::vector<double> edge_similarity(const Graph& G) {
+  auto                     degrees = detail::degrees_of(G);
+  std::vector<std::size_t> offsets(G.size() + 1);
+  std::inclusive_scan(degrees.begin(), degrees.end(), offsets.begin() + 1);
+
+  // The rows are visited in order by one task each, so a per-row cursor is enough.
+  std::vector<double>      scores(offsets.back());
+  std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+  for_each_similarity<Measure>(G, [&](std::size_t u, auto&&, double score) { scores[cursor[u]++] = score; });
+  return scores;
+}
+
+/**
+ * @brief The k most similar vertices of every vertex, among the vertices two hops away.
+ *
+ * Every row is handled by one task, with the rows split into tasks of about
+ * equal two-hop work, i.e., the sum of the degrees of the neighbors.  A task
+ * counts the common neighbors of u and every vertex w two hops away in a
+ * per-thread dense accumulator, so each pair is scored once without an
+ * intersection, and keeps the best k candidates in a bounded min-heap.
+ *
+ * @tparam Measure The similarity measure.
+ * @param G A symmetric graph with sorted rows.
+ * @param k The number of candidates per vertex.
+ * @param exclude_neighbors Whether to skip the vertices that are already neighbors of u, e.g., for link prediction.
+ * @return An adjacency<0, double> whose row u holds the best candidates of u, by decreasing score (ties by increasing id).
+ */
+template <similarity_measure Measure, adjacency_list_graph Graph>
+auto top_k_similar(const Graph& G, std::size_t k, bool exclude_neighbors = true) {
+  using vertex_id_type = default_vertex_id_type;
+  using index_type     = default_index_t;
+
+  const std::size_t n       = G.size();
+  auto              degrees = detail::degrees_of(G);
+
+  std::vector<std::size_t> work(n);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      for (auto&& edge : G[u]) {
+        work[u] += degrees[target(G, edge)];
+      }
+    }
+  });
+  auto parts = detail::balanced_parts(work);
+
+  std::vector<double> weights;
+  if constexpr (Measure == similarity_measure::adamic_adar) {
+    weights = detail::adamic_adar_weights(degrees);
+  }
+
+  struct accumulator {
+    std::vector<double>         common;
+    std::vector<char>           neighbor;
+    std::vector<vertex_id_type> touched;
+  };
+  tbb::enumerable_thread_specific<accumulator> accumulators([n] { return accumulator{std::vector<double>(n), std::vector<char>(n), {}}; });
+
+  // Better candidates compare less, so the heap top is the worst one kept.
+  using candidate = std::tuple<double, vertex_id_type>;
+  auto better     = [](const candidate& a, const candidate& b) {
+    return std::get<0>(a) > std::get<0>(b) || (std::get<0>(a) == std::get<0>(b) && std::get<1>(a) < std::get<1>(b));
+  };
+
+  // Each part buffers the candidates of its rows, so the space is the size of
+  // the result rather than n * k.
+  struct part_rows {
+    std::vector<vertex_id_type> targets;
+    std::vector<double>         scores;
+  };
+  std::vector<part_rows>  rows(parts.size() - 1);
+  std::vector<index_type> counts(n + 1);
+
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, parts.size() - 1, 1), [&](auto&& r) {
+    auto&& [common, neighbor, touched] = accumulators.local();
+    std::vector<candidate> heap;
+    for (auto p = r.begin(), pe = r.end(); p != pe; ++p) {
+      auto&& [part_targets, part_scores] = rows[p];
+      for (std::size_t u = parts[p]; u != parts[p + 1]; ++u) {
+        if (exclude_neighbors) {
+          for (auto&& e : G[u]) {
+            neighbor[target(G, e)] = true;
+          }
+        }
+        for (auto&& e : G[u]) {
+          auto   v = target(G, e);
+          double c = 1;
+          if constexpr (Measure == similarity_measure::adamic_adar) {
+            c = weights[v];
+          }
+          for (auto&& f : G[v]) {
+            if (auto w = target(G, f); w != u) {
+              if (common[w] == 0) {
+                touched.push_back(w);
+              }
+              common[w] += c;
+            }
+          }
+        }
+
+        heap.clear();
+        for (auto w : touched) {
+          if (!neighbor[w] && k != 0) {
+            candidate x(detail::similarity_score<Measure>(common[w], degrees[u], degrees[w]), w);
+            if (heap.size() < k) {
+              heap.push_back(x);
+              std::push_heap(heap.begin(), heap.end(), better);
+            } else if (better(x, heap.front())) {
+              std::pop_heap(heap.begin(), heap.end(), better);
+              heap.back() = x;
+              std::push_heap(heap.begin(), heap.end(), better);
+            }
+          }
+          common[w] = 0;
+        }
+        touched.clear();
+        if (exclude_neighbors) {
+          for (auto&& e : G[u]) {
+            neighbor[target(G, e)] = false;
+          }
+        }
+
+        std::sort_heap(heap.begin(), heap.end(), better);
+        for (auto&& [score, w] : heap) {
+          part_scores.push_back(score);
+          part_targets.push_back(w);
+        }
+        counts[u + 1] = heap.size();
+      }
+    }
+  });
+
+  std::inclusive_scan(counts.begin(), counts.end(), counts.begin());
+  std::vector<vertex_id_type> targets(counts.back());
+  std::vector<double>         scores(counts.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, rows.size(), 1), [&](auto&& r) {
+    for (auto p = r.begin(), pe = r.end(); p != pe; ++p) {
+      std::copy(rows[p].targets.begin(), rows[p].targets.end(), targets.begin() + counts[parts[p]]);
+      std::copy(rows[p].scores.begin(), rows[p].scores.end(), scores.begin() + counts[parts[p]]);
+      rows[p] = {};
+    }
+  });
+
+  return adjacency<0, double>(std::move(counts), std::move(targets), std::move(scores));
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_SIMILARITY_HPP
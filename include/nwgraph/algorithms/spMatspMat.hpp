@@ -19,10 +19,24 @@
 #define NW_GRAPH_SPMATSPMAT_HPP
 
 #include <algorithm>
-#include <map>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
 #include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
 
 #include "nwgraph/adaptors/plain_range.hpp"
+#include "nwgraph/adjacency.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/util/util.hpp"
 
@@ -30,62 +44,380 @@ namespace nw {
 namespace graph {
 
 //****************************************************************************
-// A * B
+// Semirings
 //****************************************************************************
 
-//****************************************************************************
-/// @todo cannot currently pass "const &" for A or B
-/// @todo Need to discuss interface options
+/// The conventional (+, *) semiring.
+template <class T>
+struct plus_times {
+  using value_type = T;
+  static constexpr T zero() { return T(0); }
+  static constexpr T add(T a, T b) { return a + b; }
+  static constexpr T mul(T a, T b) { return a * b; }
+};
+
+/// The tropical (min, +) semiring, for shortest paths.
+template <class T>
+struct min_plus {
+  using value_type = T;
+  static constexpr T zero() { return std::numeric_limits<T>::max(); }
+  static constexpr T add(T a, T b) { return std::min(a, b); }
+  static constexpr T mul(T a, T b) { return a + b; }
+};
+
+/// Counts the paths (k) from i to j, ignoring the values: C(i, j) = |A(i, :) ∩ B(:, j)|.
+template <class T>
+struct plus_pair {
+  using value_type = T;
+  static constexpr T zero() { return T(0); }
+  static constexpr T add(T a, T b) { return a + b; }
+  static constexpr T mul(T, T) { return T(1); }
+};
+
+/// A semiring built from a pair of binary function objects, whose additive
+/// identity is a value-initialized T.
+template <class T, class AddOp = std::plus<T>, class MulOp = std::multiplies<T>>
+struct op_semiring {
+  using value_type = T;
+  static constexpr T zero() { return T{}; }
+  static constexpr T add(T a, T b) { return AddOp()(a, b); }
+  static constexpr T mul(T a, T b) { return MulOp()(a, b); }
+};
+
+namespace detail {
+
+/// The value stored on an edge, or 1 for an edge without properties.
+template <class T, class Edge>
+T edge_value(const Edge& e) {
+  if constexpr (requires { std::tuple_size<std::remove_cvref_t<Edge>>::value; }) {
+    if constexpr (std::tuple_size_v<std::remove_cvref_t<Edge>> >= 2) {
+      return T(std::get<1>(e));
+    } else {
+      return T(1);
+    }
+  } else {
+    return T(1);
+  }
+}
+
+/// The absence of a mask.
+struct no_mask {};
+
+/// Per-thread workspace of the Gustavson kernel.
+///
+/// A row is accumulated either in a dense sparse accumulator (SPA) indexed by
+/// column, or in an open-addressing hash table sized to the row's flop count,
+/// whichever fits the row.  Both keep a slot state so that a mask can mark the
+/// columns that may be written before the products are accumulated.
+template <class T, class Index>
+struct spgemm_workspace {
+  enum : std::uint8_t { empty, allowed, set };
+
+  std::vector<T>            dense_values;
+  std::vector<std::uint8_t> dense_state;
+
+  std::vector<Index>        hash_keys;
+  std::vector<T>            hash_values;
+  std::vector<std::uint8_t> hash_state;
+
+  std::vector<Index>                 touched;    // dense columns or hash slots
+  std::vector<std::tuple<Index, T>>  row;        // sorted output of a hash row
+};
+
+}    // namespace detail
 
 /**
- * @brief SpGEMM for C = A * B.
- * 
- * @tparam ScalarT scalar type
- * @tparam LGraphT adjacency_list_graph type
- * @tparam RGraphT adjacency_list_graph type
- * @tparam MapOpT map operation type
- * @tparam ReduceOpT reduce operation type
- * @param A Input matrix A
- * @param B Input matrix B
- * @return edge_list<directedness::directed, ScalarT> a weighted edge list 
+ * @brief Row-parallel Gustavson SpGEMM, C = A * B over a semiring, with an optional structural mask.
+ *
+ * Row i of C is the semiring combination of the rows B(k, :) for every k in
+ * A(i, :).  The kernel runs in two phases: a symbolic phase that counts the
+ * entries of every row of C, from which the CSR indices are scanned, and a
+ * numeric phase that writes each row into its slot in sorted order.  Each
+ * row is accumulated either in a dense SPA, when its flop count is a sizable
+ * fraction of the number of columns, or in a small hash table otherwise.
+ *
+ * With a mask M, only the entries C(i, j) with j in M(i, :) are computed, e.g.,
+ * the masked product L * L .* L counts the triangles of a graph.
+ *
+ * Edges without a value contribute a value of 1, so plus_pair and plus_times
+ * of structure-only graphs both count paths of length two.
+ *
+ * @tparam Semiring The semiring, e.g., plus_times<double>, with value_type, zero(), add() and mul().
+ * @param A The left matrix, as an adjacency_list_graph.
+ * @param B The right matrix, as an adjacency_list_graph.
+ * @param M The mask, as an adjacency_list_graph, or detail::no_mask.
+ * @return adjacency<0, typename Semiring::value_type> holding C.
  */
-template <typename ScalarT, adjacency_list_graph LGraphT, adjacency_list_graph RGraphT, typename MapOpT = std::multiplies<ScalarT>,
-          typename ReduceOpT = std::plus<ScalarT>>
-edge_list<directedness::directed, ScalarT> spMatspMat(const LGraphT& A, const RGraphT& B) {
-  edge_list<directedness::directed, ScalarT> edges(0);
-  edges.open_for_push_back();
+template <class Semiring, adjacency_list_graph LGraphT, adjacency_list_graph RGraphT, class MaskT = detail::no_mask>
+auto spgemm(const LGraphT& A, const RGraphT& B, const MaskT& M = {}) {
+  using T              = typename Semiring::value_type;
+  using vertex_id_type = default_vertex_id_type;
+  using index_type     = default_index_t;
+  using workspace      = detail::spgemm_workspace<T, vertex_id_type>;
 
-  using vertex_id_type = vertex_id_t<LGraphT>;
+  constexpr bool masked = !std::is_same_v<MaskT, detail::no_mask>;
 
-  for (vertex_id_type i = 0; i < num_vertices(A); ++i) {
+  // Rows whose flop count reaches ncols / dense_ratio use the dense SPA.
+  constexpr std::size_t dense_ratio = 16;
 
-    std::map<size_t, ScalarT> Ci_tmp;
+  const std::size_t n = A.size();
+
+  std::size_t ncols = tbb::parallel_reduce(
+      tbb::blocked_range<std::size_t>(0, B.size()), std::size_t(0),
+      [&](auto&& r, std::size_t m) {
+        for (auto k = r.begin(), e = r.end(); k != e; ++k) {
+          for (auto&& f : B[k]) {
+            m = std::max<std::size_t>(m, target(B, f) + 1);
+          }
+        }
+        return m;
+      },
+      [](std::size_t a, std::size_t b) { return std::max(a, b); });
 
-    for (auto&& [k, a_ik] : A[i]) {
-      for (auto&& [j, b_kj] : B[k]) {
+  std::vector<std::size_t> flops(n);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      std::size_t f = 0;
+      for (auto&& a : A[i]) {
+        f += std::ranges::size(B[target(A, a)]);
+      }
+      flops[i] = f;
+    }
+  });
+
+  tbb::enumerable_thread_specific<workspace> workspaces;
+
+  // Accumulate row i and return its number of entries.  In the numeric phase
+  // the entries are also written, in column order, to targets and values.
+  auto accumulate = [&]<bool numeric>(std::size_t i, workspace& w, vertex_id_type* targets, T* values) -> std::size_t {
+    if (flops[i] == 0) {
+      return 0;
+    }
+    if constexpr (masked) {
+      if (std::ranges::size(M[i]) == 0) {
+        return 0;
+      }
+    }
 
-        // TODO: Do we really want semiring support.  If so,
-        // what is best way to deal with additive identity?
-        ScalarT tmp = MapOpT()(a_ik, b_kj);    // C_ij partial product
+    auto&& touched = w.touched;
+    touched.clear();
 
-        if (Ci_tmp.find(j) != Ci_tmp.end()) {
-          Ci_tmp[j] = ReduceOpT()(Ci_tmp[j], tmp);
-        } else {
-          Ci_tmp[j] = tmp;
+    if (flops[i] * dense_ratio >= ncols) {
+      auto&& state = w.dense_state;
+      auto&& spa   = w.dense_values;
+      if (state.size() < ncols) {
+        state.resize(ncols, workspace::empty);
+        spa.resize(ncols);
+      }
+      if constexpr (masked) {
+        for (auto&& m : M[i]) {
+          if (std::size_t j = target(M, m); j < ncols) {
+            state[j] = workspace::allowed;
+          }
+        }
+      }
+
+      for (auto&& a : A[i]) {
+        T a_ik = detail::edge_value<T>(a);
+        for (auto&& b : B[target(A, a)]) {
+          vertex_id_type j = target(B, b);
+          if constexpr (masked) {
+            if (state[j] == workspace::empty) {
+              continue;
+            }
+          }
+          if (state[j] != workspace::set) {
+            state[j] = workspace::set;
+            touched.push_back(j);
+            if constexpr (numeric) {
+              spa[j] = Semiring::mul(a_ik, detail::edge_value<T>(b));
+            }
+          } else if constexpr (numeric) {
+            spa[j] = Semiring::add(spa[j], Semiring::mul(a_ik, detail::edge_value<T>(b)));
+          }
+        }
+      }
+
+      if constexpr (numeric) {
+        std::sort(touched.begin(), touched.end());
+        for (std::size_t k = 0; k < touched.size(); ++k) {
+          targets[k] = touched[k];
+          values[k]  = spa[touched[k]];
         }
       }
+      for (auto j : touched) {
+        state[j] = workspace::empty;
+      }
+      if constexpr (masked) {
+        for (auto&& m : M[i]) {
+          if (std::size_t j = target(M, m); j < ncols) {
+            state[j] = workspace::empty;
+          }
+        }
+      }
+      return touched.size();
     }
 
-    // extract from the map and put in edge_list
-    for (auto const& elt : Ci_tmp) {
-      edges.push_back(i, elt.first, elt.second);
+    // Hash accumulator with linear probing and Fibonacci hashing.
+    // A masked row holds exactly the columns of its mask row.
+    std::size_t bound = flops[i];
+    if constexpr (masked) {
+      bound = std::ranges::size(M[i]);
+    }
+    const std::size_t capacity = std::bit_ceil(std::max<std::size_t>(8, 2 * bound));
+    const int         shift    = 64 - std::countr_zero(capacity);
+    auto&&            keys     = w.hash_keys;
+    auto&&            table    = w.hash_values;
+    auto&&            state    = w.hash_state;
+    if (state.size() < capacity) {
+      state.resize(capacity, workspace::empty);
+      keys.resize(capacity);
+      table.resize(capacity);
+    }
+
+    // Find the slot of column j, claiming an empty one when insert is true.
+    auto slot = [&](vertex_id_type j, bool insert) -> std::size_t {
+      for (std::size_t s = (std::uint64_t(j) * 0x9e3779b97f4a7c15ull) >> shift;; s = (s + 1) & (capacity - 1)) {
+        if (state[s] == workspace::empty) {
+          if (!insert) {
+            return capacity;
+          }
+          keys[s] = j;
+          touched.push_back(s);
+          return s;
+        }
+        if (keys[s] == j) {
+          return s;
+        }
+      }
+    };
+
+    if constexpr (masked) {
+      for (auto&& m : M[i]) {
+        if (auto s = slot(target(M, m), true); state[s] == workspace::empty) {
+          state[s] = workspace::allowed;
+        }
+      }
     }
-  }
 
+    std::size_t count = 0;
+    for (auto&& a : A[i]) {
+      T a_ik = detail::edge_value<T>(a);
+      for (auto&& b : B[target(A, a)]) {
+        std::size_t s = slot(target(B, b), !masked);
+        if constexpr (masked) {
+          if (s == capacity) {
+            continue;
+          }
+        }
+        if (state[s] != workspace::set) {
+          state[s] = workspace::set;
+          ++count;
+          if constexpr (numeric) {
+            table[s] = Semiring::mul(a_ik, detail::edge_value<T>(b));
+          }
+        } else if constexpr (numeric) {
+          table[s] = Semiring::add(table[s], Semiring::mul(a_ik, detail::edge_value<T>(b)));
+        }
+      }
+    }
+
+    if constexpr (numeric) {
+      auto&& row = w.row;
+      row.clear();
+      for (auto s : touched) {
+        if (state[s] == workspace::set) {
+          row.emplace_back(keys[s], table[s]);
+        }
+      }
+      std::sort(row.begin(), row.end(), [](auto&& x, auto&& y) { return std::get<0>(x) < std::get<0>(y); });
+      for (std::size_t k = 0; k < row.size(); ++k) {
+        std::tie(targets[k], values[k]) = row[k];
+      }
+    }
+    for (auto s : touched) {
+      state[s] = workspace::empty;
+    }
+    return count;
+  };
+
+  // Symbolic phase: size the rows of C.
+  std::vector<index_type> indices(n + 1);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    auto&& w = workspaces.local();
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      indices[i + 1] = accumulate.template operator()<false>(i, w, nullptr, nullptr);
+    }
+  });
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
+
+  // Numeric phase: fill the rows of C in place.
+  std::vector<vertex_id_type> targets(indices.back());
+  std::vector<T>              values(indices.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+    auto&& w = workspaces.local();
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      accumulate.template operator()<true>(i, w, targets.data() + indices[i], values.data() + indices[i]);
+    }
+  });
+
+  return adjacency<0, T>(std::move(indices), std::move(targets), std::move(values));
+}
+
+namespace detail {
+
+/// Copy a CSR product into a directed edge list, in parallel.
+template <class T, class Graph>
+edge_list<directedness::directed, T> to_edge_list(const Graph& C, std::size_t ncols) {
+  edge_list<directedness::directed, T> edges(0);
+  edges.resize(C.num_edges());
+  auto&& base = static_cast<typename edge_list<directedness::directed, T>::base&>(edges);
+  auto&& rows = std::get<0>(base);
+  auto&& cols = std::get<1>(base);
+  auto&& vals = std::get<2>(base);
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, C.size()), [&](auto&& r) {
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      std::size_t k = C.indices_[i];
+      for (auto&& [j, v] : C[i]) {
+        rows[k]   = i;
+        cols[k]   = j;
+        vals[k++] = v;
+      }
+    }
+  });
+  edges.extend_vertex_cardinality({std::max<std::size_t>(C.size(), ncols), ncols});
   edges.close_for_push_back();
   return edges;
 }
 
+}    // namespace detail
+
+//****************************************************************************
+// A * B
+//****************************************************************************
+
+/**
+ * @brief SpGEMM for C = A * B.
+ *
+ * Runs spgemm() over the semiring (ReduceOpT, MapOpT) and returns the product
+ * as a weighted edge list.
+ *
+ * @tparam ScalarT scalar type
+ * @tparam LGraphT adjacency_list_graph type
+ * @tparam RGraphT adjacency_list_graph type
+ * @tparam MapOpT map operation type
+ * @tparam ReduceOpT reduce operation type
+ * @param A Input matrix A
+ * @param B Input matrix B
+ * @return edge_list<directedness::directed, ScalarT> a weighted edge list 
+ */
+template <typename ScalarT, adjacency_list_graph LGraphT, adjacency_list_graph RGraphT, typename MapOpT = std::multiplies<ScalarT>,
+          typename ReduceOpT = std::plus<ScalarT>>
+edge_list<directedness::directed, ScalarT> spMatspMat(const LGraphT& A, const RGraphT& B) {
+  auto C = spgemm<op_semiring<ScalarT, ReduceOpT, MapOpT>>(A, B);
+  return detail::to_edge_list<ScalarT>(C, num_vertices(C));
+}
+
 /**
  * @brief Set the ewise intersection object
  * 
@@ -119,9 +451,12 @@ void set_ewise_intersection(InputIt1 first1, InputIt1 last1, InputIt2 first2, In
 }
 
 //****************************************************************************
-/// @todo cannot currently pass "const &" for A or BT
 /**
  * @brief SpGEMM for C = A * BT.
+ *
+ * Every entry of C is a sparse dot product of a row of A with a row of BT.
+ * The rows of C are computed in parallel, in chunks that buffer their entries
+ * until the row offsets are known.  Rows of A and BT must be sorted.
  * 
  * @tparam ScalarT scalar type
  * @tparam LGraphT adjacency_list_graph type
@@ -134,39 +469,60 @@ void set_ewise_intersection(InputIt1 first1, InputIt1 last1, InputIt2 first2, In
  */
 template <typename ScalarT, adjacency_list_graph LGraphT, adjacency_list_graph RGraphT, typename MapOpT = std::multiplies<ScalarT>,
           typename ReduceOpT = std::plus<ScalarT>>
-edge_list<directedness::directed, ScalarT> spMatspMatT(LGraphT& A, RGraphT& BT) {
-  std::vector<ScalarT> products;
+edge_list<directedness::directed, ScalarT> spMatspMatT(const LGraphT& A, const RGraphT& BT) {
+  using vertex_id_type = default_vertex_id_type;
+  using index_type     = default_index_t;
 
-  using vertex_id_type = vertex_id_t<LGraphT>;
+  const std::size_t n = A.size();
 
-  edge_list<directedness::directed, ScalarT> edges(0);
-  edges.open_for_push_back();
+  struct part {
+    std::vector<vertex_id_type> targets;
+    std::vector<ScalarT>        values;
+  };
+  const std::size_t       num_parts = std::clamp<std::size_t>(n / 16, 1, 64 * tbb::this_task_arena::max_concurrency());
+  std::vector<part>       parts(num_parts);
+  std::vector<index_type> indices(n + 1);
 
   // compute A * B' with a series of sparse dot products
-  vertex_id_type row_idx = 0;
-  for (auto row_it = A.begin(); row_it != A.end(); ++row_it, ++row_idx) {
-    vertex_id_type col_idx = 0;
-    for (auto col_it = BT.begin(); col_it != BT.end(); ++col_it, ++col_idx) {
-      // std::cout << "Computing " << row_idx << "," << col_idx << std::endl;
-      products.clear();
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_parts, 1), [&](auto&& r) {
+    std::vector<ScalarT> products;
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto&& [targets, values] = parts[c];
+      for (std::size_t i = n * c / num_parts, ie = n * (c + 1) / num_parts; i != ie; ++i) {
+        std::size_t degree = 0;
+        for (std::size_t j = 0, je = BT.size(); j != je; ++j) {
+          products.clear();
+          set_ewise_intersection(A[i].begin(), A[i].end(), BT[j].begin(), BT[j].end(), products,
+                                 [](auto&& a, auto&& bt) -> bool { return std::get<0>(a) < std::get<0>(bt); },
+                                 [](auto&& a, auto&& bt) -> ScalarT { return MapOpT()(std::get<1>(a), std::get<1>(bt)); });
+          if (!products.empty()) {
+            targets.push_back(j);
+            values.push_back(std::accumulate(products.begin() + 1, products.end(), products.front(), ReduceOpT()));
+            ++degree;
+          }
+        }
+        indices[i + 1] = degree;
+      }
+    }
+  });
 
-      set_ewise_intersection((*row_it).begin(), (*row_it).end(), (*col_it).begin(), (*col_it).end(), products,
-                             [](auto&& a, auto&& bt) -> bool { return std::get<0>(a) < std::get<0>(bt); },
-                             [](auto&& a, auto&& bt) -> ScalarT { return MapOpT()(std::get<1>(a), std::get<1>(bt)); });
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
 
-      if (!products.empty()) {
-        ScalarT res = std::accumulate(products.begin(), products.end(), (ScalarT)0, ReduceOpT());
-        edges.push_back(row_idx, col_idx, res);
-        // std::cout << "Added element (" << row_idx << ","
-        //          << col_idx << ") = " << res << std::endl;
-        products.clear();
-      }
+  std::vector<vertex_id_type> targets(indices.back());
+  std::vector<ScalarT>        values(indices.back());
+  tbb::parallel_for(tbb::blocked_range<std::size_t>(0, num_parts, 1), [&](auto&& r) {
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto offset = indices[n * c / num_parts];
+      std::copy(parts[c].targets.begin(), parts[c].targets.end(), targets.begin() + offset);
+      std::copy(parts[c].values.begin(), parts[c].values.end(), values.begin() + offset);
+      parts[c] = {};
     }
-  }
+  });
 
-  edges.close_for_push_back();
-  return edges;
+  adjacency<0, ScalarT> C(std::move(indices), std::move(targets), std::move(values));
+  return detail::to_edge_list<ScalarT>(C, BT.size());
 }
+
 }    // namespace graph
 }    // namespace nw
 
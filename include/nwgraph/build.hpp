@@ -19,19 +19,29 @@
 
 #include "nwgraph/graph_base.hpp"
 #include "nwgraph/graph_traits.hpp"
+#include "nwgraph/util/atomic.hpp"
+#include "nwgraph/util/index_map.hpp"
+#include "nwgraph/util/radix_sort.hpp"
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <cstdint>
 #include <execution>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <numeric>
 #include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
 
 #include "graph_concepts.hpp"
 
@@ -43,24 +53,195 @@ namespace graph {
 
 using default_execution_policy = std::execution::parallel_unsequenced_policy;
 
+/// Edge lists stored as columns of unsigned vertex ids (i.e., index_edge_list),
+/// which are sorted with radix_sort rather than by comparisons.
+template <class edge_list_t>
+concept radix_sortable_edge_list = requires {
+  typename edge_list_t::base;
+  typename edge_list_t::vertex_id_type;
+} && std::derived_from<edge_list_t, typename edge_list_t::base> && std::unsigned_integral<typename edge_list_t::vertex_id_type>;
+
+namespace detail {
+template <class attributes_t>
+constexpr bool unsigned_attributes = false;
+
+template <class... Attributes>
+constexpr bool unsigned_attributes<std::tuple<Attributes...>> = (std::unsigned_integral<Attributes> && ...);
+}    // namespace detail
+
+/// Radix-sortable edge lists whose attributes are all unsigned integers, so
+/// that radix_sort can also order ties by them.
+template <class edge_list_t>
+concept radix_lexical_sortable_edge_list = radix_sortable_edge_list<edge_list_t> && requires {
+  typename edge_list_t::attributes_t;
+} && detail::unsigned_attributes<typename edge_list_t::attributes_t>;
+
+namespace detail {
+
+/// Number of bits needed by the vertex ids in the first two columns of an edge list.
+template <radix_sortable_edge_list edge_list_t>
+unsigned vertex_id_bits(const edge_list_t& el) {
+  using vertex_id_type = typename edge_list_t::vertex_id_type;
+
+  auto&& base = static_cast<const typename edge_list_t::base&>(el);
+  auto&& u    = std::get<0>(base);
+  auto&& v    = std::get<1>(base);
+
+  vertex_id_type max = tbb::parallel_reduce(
+      tbb::blocked_range(0ul, el.size()), vertex_id_type(0),
+      [&](auto&& r, vertex_id_type m) {
+        for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+          m = std::max({m, u[i], v[i]});
+        }
+        return m;
+      },
+      [](auto a, auto b) { return std::max(a, b); });
+  return std::bit_width(max);
+}
+
+/// Call f with a vector of unsigned indices wide enough for n elements.
+template <class F>
+decltype(auto) with_index_vector(std::size_t n, F&& f) {
+  if (n <= std::numeric_limits<std::uint32_t>::max()) {
+    return f(std::vector<std::uint32_t>(n));
+  } else {
+    return f(std::vector<std::size_t>(n));
+  }
+}
+
+/// Reorder every column of an edge list in place so that element i moves from
+/// perm[i], by following the cycles of the permutation; perm is left as the
+/// identity.
+template <radix_sortable_edge_list edge_list_t, class Perm>
+void permute_columns(edge_list_t& el, Perm& perm) {
+  std::apply(
+      [&](auto&... columns) {
+        for (std::size_t i = 0, e = perm.size(); i != e; ++i) {
+          if (perm[i] == i) {
+            continue;
+          }
+          auto        first = std::tuple(std::move(columns[i])...);
+          std::size_t j     = i;
+          for (std::size_t k = perm[j]; k != i; k = perm[j]) {
+            ((columns[j] = std::move(columns[k])), ...);
+            perm[j] = j;
+            j       = k;
+          }
+          std::tie(columns[j]...) = std::move(first);
+          perm[j]                 = j;
+        }
+      },
+      static_cast<typename edge_list_t::base&>(el));
+}
+
+/// Stable radix sort of an edge list by its idx column, and then, if lexical,
+/// by its other column.  If by_attributes, ties are further ordered by the
+/// attribute columns, which must be unsigned integers, as a tuple comparison
+/// would order them.
+template <int idx, bool lexical, bool by_attributes = false, radix_sortable_edge_list edge_list_t>
+void radix_sort_edges(edge_list_t& el) {
+  constexpr int jdx = (idx + 1) % 2;
+
+  auto&&         base = static_cast<typename edge_list_t::base&>(el);
+  auto&&         a    = std::get<idx>(base);
+  auto&&         b    = std::get<jdx>(base);
+  const unsigned bits = vertex_id_bits(el);
+  const size_t   m    = el.size();
+
+  with_index_vector(m, [&](auto perm) {
+    std::iota(perm.begin(), perm.end(), 0);
+
+    // Sort on the key given by k(i), the i-th element of the current order,
+    // in 32-bit keys whenever it fits.  The keys only live for one sort.
+    auto sort_on = [&](auto&& k, unsigned key_bits) {
+      auto sort_keys = [&](auto keys) {
+        tbb::parallel_for(tbb::blocked_range(0ul, m), [&](auto&& r) {
+          for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+            keys[i] = k(perm[i]);
+          }
+        });
+        radix_sort(keys, perm, key_bits);
+      };
+      if (key_bits <= 32) {
+        sort_keys(std::vector<std::uint32_t>(m));
+      } else {
+        sort_keys(std::vector<std::uint64_t>(m));
+      }
+    };
+
+    if constexpr (by_attributes) {
+      // Least significant first: the last attribute, ..., the first attribute.
+      std::apply(
+          [&](auto&, auto&, auto&... attributes) {
+            auto sort_on_column = [&](auto& column) {
+              using value_type = typename std::remove_reference_t<decltype(column)>::value_type;
+              static_assert(std::unsigned_integral<value_type>);
+              value_type max = tbb::parallel_reduce(
+                  tbb::blocked_range(0ul, m), value_type(0),
+                  [&](auto&& r, value_type x) {
+                    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+                      x = std::max(x, column[i]);
+                    }
+                    return x;
+                  },
+                  [](auto x, auto y) { return std::max(x, y); });
+              sort_on([&](auto i) { return std::uint64_t(column[i]); }, std::bit_width(max));
+            };
+            auto sort_on_columns = [&](auto& self, auto& column, auto&... rest) -> void {
+              if constexpr (sizeof...(rest) != 0) {
+                self(self, rest...);
+              }
+              sort_on_column(column);
+            };
+            if constexpr (sizeof...(attributes) != 0) {
+              sort_on_columns(sort_on_columns, attributes...);
+            }
+          },
+          base);
+    }
+
+    if (!lexical) {
+      sort_on([&](auto i) { return std::uint64_t(a[i]); }, bits);
+    } else if (2 * bits <= 64) {
+      sort_on([&](auto i) { return std::uint64_t(a[i]) << bits | b[i]; }, 2 * bits);
+    } else {
+      sort_on([&](auto i) { return std::uint64_t(b[i]); }, bits);
+      sort_on([&](auto i) { return std::uint64_t(a[i]); }, bits);
+    }
+
+    permute_columns(el, perm);
+  });
+}
+
+}    // namespace detail
+
 template <int idx, edge_list_graph edge_list_t, class ExecutionPolicy = default_execution_policy>
 void sort_by(edge_list_t& el, ExecutionPolicy&& policy = {}) {
-  std::sort(std::execution::seq, el.begin(), el.end(),
-            [](const auto& a, const auto& b) -> bool { return (std::get<idx>(a) < std::get<idx>(b)); });
+  if constexpr (radix_sortable_edge_list<edge_list_t>) {
+    detail::radix_sort_edges<idx, false>(el);
+  } else {
+    std::sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool { return (std::get<idx>(a) < std::get<idx>(b)); });
+  }
 }
 
 template <int idx, edge_list_graph edge_list_t, class ExecutionPolicy = default_execution_policy>
 void stable_sort_by(edge_list_t& el, ExecutionPolicy&& policy = {}) {
-  std::stable_sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool { return (std::get<idx>(a) < std::get<idx>(b)); });
+  if constexpr (radix_sortable_edge_list<edge_list_t>) {
+    detail::radix_sort_edges<idx, false>(el);
+  } else {
+    std::stable_sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool { return (std::get<idx>(a) < std::get<idx>(b)); });
+  }
 }
 
 template <int idx, edge_list_graph edge_list_t, class ExecutionPolicy = default_execution_policy>
 void lexical_sort_by(edge_list_t& el, ExecutionPolicy&& policy = {}) {
   static_assert(std::is_same_v<decltype(el.begin()), typename edge_list_t::iterator>);
 
-  const int jdx = (idx + 1) % 2;
-
-  if constexpr (idx == 0) {
+  if constexpr (idx == 0 && radix_lexical_sortable_edge_list<edge_list_t>) {
+    detail::radix_sort_edges<idx, true, true>(el);
+  } else if constexpr (idx == 1 && radix_sortable_edge_list<edge_list_t>) {
+    detail::radix_sort_edges<idx, true>(el);
+  } else if constexpr (idx == 0) {
     std::sort(policy, el.begin(), el.end());
   } else {
     std::sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool {
@@ -74,9 +255,13 @@ void lexical_stable_sort_by(edge_list_t& el, ExecutionPolicy&& policy = {}) {
 
   const int jdx = (idx + 1) % 2;
 
-  std::stable_sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool {
-    return std::tie(std::get<idx>(a), std::get<jdx>(a)) < std::tie(std::get<idx>(b), std::get<jdx>(b));
-  });
+  if constexpr (radix_sortable_edge_list<edge_list_t>) {
+    detail::radix_sort_edges<idx, true>(el);
+  } else {
+    std::stable_sort(policy, el.begin(), el.end(), [](const auto& a, const auto& b) -> bool {
+      return std::tie(std::get<idx>(a), std::get<jdx>(a)) < std::tie(std::get<idx>(b), std::get<jdx>(b));
+    });
+  }
 }
 
 
@@ -185,6 +370,143 @@ void fill_helper_tmp(edge_list_t& el, adjacency_t& cs, std::index_sequence<Is...
                    std::get<Is + 2>(dynamic_cast<typename edge_list_t::base&>(Tmp)).end(), std::get<Is + 1>(cs.to_be_indexed_).begin())));
 }
 
+template <class Index, class EdgeList, class Adjacency, size_t... Is>
+void counting_place_helper(const EdgeList& el, Adjacency& cs, std::index_sequence<Is...> is, Index to, size_t from) {
+  (..., (std::get<Is + 1>(cs.to_be_indexed_)[to] = std::get<Is + 2>(el)[from]));
+}
+
+/**
+ * @brief Scatter the edges of an edge list into the neighborhoods of a compressed structure with a parallel counting sort.
+ *
+ * The sort has two levels.  The edge list is split into one contiguous chunk per thread and the vertices into ranges
+ * (blocks) of a power of two.  Each chunk first counts its edges per block, and after a scan of these small counts it
+ * writes the positions of its edges into a buffer grouped by block.  Each block then counts the degrees of its own
+ * vertices and, after a scan of the degrees, places its edges (and their attributes) into their final slots.  The work
+ * is O(E + N) and the extra space is one position per placed edge plus chunks * blocks counts, so the parallelism
+ * depends on the number of threads and not on the density of the graph.  Since the chunks and the blocks are processed
+ * in order every neighborhood keeps the relative order of the edge list, and the result is the same for every run.
+ * A sequential policy uses one chunk and runs every phase on the calling thread.
+ *
+ * If `symmetric` is true each edge (u, v) is placed in the neighborhood of both u and v, which is what an undirected
+ * edge list needs.  Otherwise edge (u, v) is placed in the neighborhood of its idx endpoint.
+ *
+ * On return `cs.indices_` holds the N + 1 neighborhood offsets and `cs.to_be_indexed_` holds the placed edges.
+ *
+ * @tparam idx Which end point of the edge list owns the edge.
+ * @tparam symmetric Whether to place every edge in the neighborhoods of both end points.
+ * @param el The edge list.
+ * @param N Number of vertices (neighborhoods) in the compressed structure.
+ * @param cs The compressed structure to fill.
+ * @param policy The execution policy, where std::execution::seq runs sequentially and any other policy in parallel.
+ */
+template <int idx, bool symmetric, edge_list_graph edge_list_t, adjacency_list_graph adjacency_t, class Int,
+          class ExecutionPolicy = default_execution_policy>
+void counting_sort_fill(const edge_list_t& el, Int N, adjacency_t& cs, ExecutionPolicy&& policy = {}) {
+  using index_type = typename decltype(cs.indices_)::value_type;
+
+  constexpr bool sequential = std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>;
+
+  constexpr int kdx    = (idx + 1) % 2;
+  const size_t  n      = N;
+  const size_t  m      = el.size();
+  const size_t  placed = symmetric ? 2 * m : m;
+
+  auto&& base = static_cast<const typename edge_list_t::base&>(el);
+  auto&& from = std::get<idx>(base);
+  auto&& to   = std::get<kdx>(base);
+
+  // Visit the i-th (source, target, edge) of the possibly symmetrized edge stream
+  auto visit = [&](size_t i, auto&& f) {
+    if (i < m) {
+      f(from[i], to[i], i);
+    } else {
+      f(to[i - m], from[i - m], i - m);
+    }
+  };
+
+  auto place = [&](index_type j, auto&& target, size_t e) {
+    std::get<0>(cs.to_be_indexed_)[j] = target;
+    if constexpr (std::tuple_size<typename edge_list_t::attributes_t>::value > 0) {
+      counting_place_helper(base, cs, std::make_integer_sequence<size_t, std::tuple_size<typename edge_list_t::attributes_t>::value>(), j, e);
+    }
+  };
+
+  cs.indices_.resize(n + 1);
+  cs.to_be_indexed_.resize(placed);
+
+  // Run f over the blocks of [0, size), in parallel unless the policy is sequential
+  auto for_blocks = [&](size_t size, size_t grain, auto&& f) {
+    if constexpr (sequential) {
+      f(tbb::blocked_range(0ul, size, grain));
+    } else {
+      tbb::parallel_for(tbb::blocked_range(0ul, size, grain), f);
+    }
+  };
+
+  const size_t grain   = 1 << 16;
+  const size_t nchunks = sequential ? 1 : std::clamp<size_t>((placed + grain - 1) / grain, 1, tbb::this_task_arena::max_concurrency());
+  const size_t chunk   = (placed + nchunks - 1) / nchunks;
+
+  // Blocks of 2^shift vertices, about 16 per chunk so that skewed degrees still balance.
+  const size_t width   = std::max<size_t>(1, (n + 16 * nchunks - 1) / (16 * nchunks));
+  const int    shift   = std::bit_width(width - 1);
+  const size_t nblocks = (n + (size_t(1) << shift) - 1) >> shift;
+
+  // counts[c * nblocks + b] is the number of edges chunk c places in block b; after the scan it is the position in
+  // the buffer where chunk c writes its next edge for block b, and starts[b] is where block b begins.
+  std::vector<index_type> counts(nchunks * nblocks, 0);
+  std::vector<index_type> starts(nblocks + 1, 0);
+  std::vector<index_type> buffer(placed);
+
+  for_blocks(nchunks, 1, [&](auto&& r) {
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto local = counts.begin() + c * nblocks;
+      for (size_t i = c * chunk, e = std::min(placed, (c + 1) * chunk); i < e; ++i) {
+        visit(i, [&](auto&& u, auto&&, size_t) { ++local[size_t(u) >> shift]; });
+      }
+    }
+  });
+
+  index_type offset = 0;
+  for (size_t b = 0; b < nblocks; ++b) {
+    starts[b] = offset;
+    for (size_t c = 0; c < nchunks; ++c) {
+      offset += std::exchange(counts[c * nblocks + b], offset);
+    }
+  }
+  starts[nblocks] = offset;
+
+  for_blocks(nchunks, 1, [&](auto&& r) {
+    for (auto c = r.begin(), ce = r.end(); c != ce; ++c) {
+      auto local = counts.begin() + c * nblocks;
+      for (size_t i = c * chunk, e = std::min(placed, (c + 1) * chunk); i < e; ++i) {
+        visit(i, [&](auto&& u, auto&&, size_t) { buffer[local[size_t(u) >> shift]++] = i; });
+      }
+    }
+  });
+
+  std::fill(cs.indices_.begin(), cs.indices_.end(), 0);
+  for_blocks(nblocks, 1, [&](auto&& r) {
+    for (auto b = r.begin(), be = r.end(); b != be; ++b) {
+      for (auto i = starts[b], e = starts[b + 1]; i != e; ++i) {
+        visit(buffer[i], [&](auto&& u, auto&&, size_t) { ++cs.indices_[u + 1]; });
+      }
+    }
+  });
+  std::inclusive_scan(policy, cs.indices_.begin() + 1, cs.indices_.end(), cs.indices_.begin() + 1);
+
+  for_blocks(nblocks, 1, [&](auto&& r) {
+    std::vector<index_type> cursor(size_t(1) << shift);
+    for (auto b = r.begin(), be = r.end(); b != be; ++b) {
+      const size_t first = b << shift, last = std::min(n, (b + 1) << shift);
+      std::copy(cs.indices_.begin() + first, cs.indices_.begin() + last, cursor.begin());
+      for (auto i = starts[b], e = starts[b + 1]; i != e; ++i) {
+        visit(buffer[i], [&](auto&& u, auto&& v, size_t edge) { place(cursor[size_t(u) - first]++, v, edge); });
+      }
+    }
+  });
+}
+
 /**
  * @brief This function fills an adjacency list graph structure from edges contained in a directed edge list.
  *
@@ -208,60 +530,8 @@ void fill_helper_tmp(edge_list_t& el, adjacency_t& cs, std::index_sequence<Is...
  */
 template <int idx, edge_list_graph edge_list_t, adjacency_list_graph adjacency_t, class Int, class ExecutionPolicy = default_execution_policy>
 void fill_directed(edge_list_t& el, Int N, adjacency_t& cs, ExecutionPolicy&& policy = {}) {
-
-  auto degree = degrees<idx>(el);
-
-  cs.indices_.resize(N + 1);
-  cs.indices_[0] = 0;
-  std::inclusive_scan(policy, degree.begin(), degree.end(), cs.indices_.begin() + 1);
-  cs.to_be_indexed_.resize(el.size());
-
-#if 0
-
-  sort_by<idx>(el);  // Need to do this in a way that will let us have const el
-                     // If not, we should steal (move) the vectors rather than copy
-
-  // Copy kdx (the other index)
-  const int kdx = (idx + 1) % 2;
-
-  std::copy(policy, std::get<kdx>(dynamic_cast<typename edge_list_t::base&>(el)).begin(),
-	    std::get<kdx>(dynamic_cast<typename edge_list_t::base&>(el)).end(), std::get<0>(cs.to_be_indexed_).begin());
-
-  // Copy properties
-  if constexpr (std::tuple_size<typename edge_list_t::attributes_t>::value > 0) {
-    fill_helper(el, cs, std::make_integer_sequence<size_t, std::tuple_size<typename edge_list_t::attributes_t>::value>(), policy);
-  }
-
-  // auto perm = proxysort(std::get<idx>(el));
-  // permute(cs.to_be_indexed_, perm, policy);
-
-#else
-  // Best: parallel insertion sort -- need concurrent container safe for push_at
-
-
-  // Better yet
-  const int kdx = (idx + 1) % 2;
-  std::copy(policy, std::get<kdx>(dynamic_cast<typename edge_list_t::base&>(el)).begin(),
-            std::get<kdx>(dynamic_cast<typename edge_list_t::base&>(el)).end(), std::get<0>(cs.to_be_indexed_).begin());
-
-  // Copy properties
-  if constexpr (std::tuple_size<typename edge_list_t::attributes_t>::value > 0) {
-    fill_helper(el, cs, std::make_integer_sequence<size_t, std::tuple_size<typename edge_list_t::attributes_t>::value>(), policy);
-  }
-
-
-  // which is faster?
-  std::vector<nw::graph::vertex_id_t<adjacency_t>> tmp(std::get<idx>(dynamic_cast<typename edge_list_t::base&>(el)));
-
-  // this dumps core for some reason
-  //std::vector<nw::graph::vertex_id_t<adjacency_t>> tmp(std::get<idx>(dynamic_cast<typename edge_list_t::base&>(el)).size());
-  //std::copy(policy, std::get<idx>(dynamic_cast<typename edge_list_t::base&>(el)).begin(),
-  //	    std::get<kdx>(dynamic_cast<typename edge_list_t::base&>(el)).end(), tmp.begin());
-
-  auto a = make_zipped(tmp, cs.to_be_indexed_);
-  std::sort(policy, a.begin(), a.end(), [](auto&& a, auto&& b) { return std::get<0>(a) < std::get<0>(b); });
-
-#endif
+  // Scatter each edge straight into its slot rather than sorting the zipped edge list by source
+  counting_sort_fill<idx, false>(el, N, cs, std::forward<ExecutionPolicy>(policy));
 }
 
 
@@ -272,36 +542,8 @@ void fill_undirected(edge_list_t& el, Int N, adjacency_t& cs, ExecutionPolicy&&
 
 #if 1
 
-  using vertex_id_type = vertex_id_t<edge_list_t>;
-
-  std::vector<vertex_id_type> Tmp(2 * el.size());
-  const int                   kdx = (idx + 1) % 2;
-
-  std::copy(policy, std::get<idx>(el).begin(), std::get<idx>(el).end(), Tmp.begin());
-  std::copy(policy, std::get<kdx>(el).begin(), std::get<kdx>(el).end(), Tmp.begin() + el.size());
-
-  {
-    std::vector<vertex_id_type> degrees(N);
-    cs.indices_.resize(N + 1);
-    cs.indices_[0] = 0;
-    std::for_each(/* policy, */ Tmp.begin(), Tmp.end(), [&](auto&& i) { ++degrees[i]; });
-    std::inclusive_scan(policy, degrees.begin(), degrees.end(), cs.indices_.begin() + 1);
-  }
-
-  cs.to_be_indexed_.resize(Tmp.size());
-
-  std::copy(policy, std::get<kdx>(el).begin(), std::get<kdx>(el).end(), std::get<0>(cs.to_be_indexed_).begin());
-  std::copy(policy, std::get<idx>(el).begin(), std::get<idx>(el).end(), std::get<0>(cs.to_be_indexed_).begin() + el.size());
-
-  if constexpr (std::tuple_size<typename edge_list_t::attributes_t>::value > 0) {
-    copy_helper(el, cs, std::make_integer_sequence<size_t, std::tuple_size<typename edge_list_t::attributes_t>::value>(), 0, policy);
-  }
-  if constexpr (std::tuple_size<typename edge_list_t::attributes_t>::value > 0) {
-    copy_helper(el, cs, std::make_integer_sequence<size_t, std::tuple_size<typename edge_list_t::attributes_t>::value>(), el.size(), policy);
-  }
-
-  auto a = make_zipped(Tmp, cs.to_be_indexed_);
-  std::sort(policy, a.begin(), a.end(), [](auto&& a, auto&& b) { return std::get<0>(a) < std::get<0>(b); });
+  // Place (u, v) and (v, u) for every edge without materializing the symmetrized edge list
+  counting_sort_fill<idx, true>(el, N, cs, std::forward<ExecutionPolicy>(policy));
 
 #else
 
@@ -442,6 +684,165 @@ void remove_self_loops(edge_list_t& el) {
   el.resize(past_the_end - el.begin());
 }
 
+namespace detail {
+
+/// Radix-sort the oriented non-loop edges of an edge list (and, if mirror, of
+/// its transpose) on their (idx, other) key, and keep the first edge of each
+/// run of equal keys.  The vertex ids must fit in 32 bits.
+template <int idx, radix_sortable_edge_list edge_list_t, class Orient>
+void radix_simplify(edge_list_t& el, unsigned bits, bool mirror, Orient&& orient) {
+  using vertex_id_type = typename edge_list_t::vertex_id_type;
+  constexpr int jdx    = (idx + 1) % 2;
+
+  auto&&              base       = static_cast<typename edge_list_t::base&>(el);
+  auto&&              u          = std::get<0>(base);
+  auto&&              v          = std::get<1>(base);
+  const size_t        m          = el.size();
+  const size_t        candidates = mirror ? 2 * m : m;
+  const std::uint64_t mask       = (std::uint64_t(1) << bits) - 1;
+
+  with_index_vector(candidates, [&](auto src) {
+    // Visit the i-th candidate edge as its (column 0, column 1) pair.
+    auto edge = [&](size_t i) { return i < m ? orient(u[i], v[i]) : std::pair(v[i - m], u[i - m]); };
+    auto key  = [&](auto&& e) { return std::uint64_t(std::get<idx>(e)) << bits | std::get<jdx>(e); };
+
+    // Keep the non-loops in order, by counting them per chunk and scanning.
+    std::vector<std::uint64_t> keys(candidates);
+    radix_chunks               chunks(candidates);
+    std::vector<size_t>        kept(chunks.size() + 1);
+    chunks.for_each([&](size_t c, size_t i, size_t e) {
+      for (; i != e; ++i) {
+        auto&& [x, y] = edge(i);
+        kept[c + 1] += (x != y);
+      }
+    });
+    std::partial_sum(kept.begin(), kept.end(), kept.begin());
+    chunks.for_each([&](size_t c, size_t i, size_t e) {
+      for (size_t j = kept[c]; i != e; ++i) {
+        if (auto&& xy = edge(i); std::get<0>(xy) != std::get<1>(xy)) {
+          keys[j]  = key(xy);
+          src[j++] = i < m ? i : i - m;
+        }
+      }
+    });
+    keys.resize(kept.back());
+    src.resize(kept.back());
+
+    radix_sort(keys, src, 2 * bits);
+
+    // Keep the first edge of each run of equal keys, the same way.
+    const size_t n = keys.size();
+    auto         first = [&](size_t i) { return i == 0 || keys[i] != keys[i - 1]; };
+    radix_chunks runs(n);
+    kept.assign(runs.size() + 1, 0);
+    runs.for_each([&](size_t c, size_t i, size_t e) {
+      for (; i != e; ++i) {
+        kept[c + 1] += first(i);
+      }
+    });
+    std::partial_sum(kept.begin(), kept.end(), kept.begin());
+    auto for_each_kept = [&](auto&& f) {
+      runs.for_each([&](size_t c, size_t i, size_t e) {
+        for (size_t j = kept[c]; i != e; ++i) {
+          if (first(i)) {
+            f(j++, i);
+          }
+        }
+      });
+    };
+
+    std::vector<vertex_id_type> column_idx(kept.back()), column_jdx(kept.back());
+    for_each_kept([&](size_t j, size_t i) {
+      column_idx[j] = keys[i] >> bits;
+      column_jdx[j] = keys[i] & mask;
+    });
+    [&]<size_t... Is>(std::index_sequence<Is...>) {
+      (
+          [&](auto& column) {
+            std::remove_reference_t<decltype(column)> tmp(kept.back());
+            for_each_kept([&](size_t j, size_t i) { tmp[j] = column[src[i]]; });
+            column.swap(tmp);
+          }(std::get<Is + 2>(base)),
+          ...);
+    }(std::make_index_sequence<std::tuple_size_v<typename edge_list_t::attributes_t>>());
+    std::get<idx>(base).swap(column_idx);
+    std::get<jdx>(base).swap(column_jdx);
+  });
+}
+
+}    // namespace detail
+
+/**
+ * @brief Reduce an undirected edge list to a simple graph, stored once per edge.
+ *
+ * Equivalent to swap_to_triangular<idx>(el, cessor), lexical_sort_by<idx>(el),
+ * uniq(el) and remove_self_loops(el), but for an index_edge_list the edges
+ * are oriented, filtered, sorted and deduplicated in a single radix sort.  Of
+ * duplicate edges, the first one in the edge list is kept.
+ *
+ * @tparam idx The column the edge list is sorted by.
+ * @param el The edge list.
+ * @param cessor Whether the idx column holds the larger (predecessor) or the smaller (successor) end point.
+ */
+template <int idx, edge_list_graph edge_list_t>
+void simplify_triangular(edge_list_t& el, succession cessor = succession::predecessor) {
+  if constexpr (radix_sortable_edge_list<edge_list_t>) {
+    if (unsigned bits = detail::vertex_id_bits(el); 2 * bits <= 64) {
+      // Column 0 holds the larger end point for these, the smaller for the others.
+      const bool descending = (idx == 0) == (cessor == succession::predecessor);
+      detail::radix_simplify<idx>(el, bits, false, [descending](auto x, auto y) {
+        return (x < y) == descending ? std::pair(y, x) : std::pair(x, y);
+      });
+      return;
+    }
+  }
+  swap_to_triangular<idx>(el, cessor);
+  lexical_sort_by<idx>(el);
+  uniq(el);
+  remove_self_loops(el);
+}
+
+template <int idx, edge_list_graph edge_list_t>
+void simplify_triangular(edge_list_t& el, const std::string& cessor) {
+  if (cessor == "predecessor") {
+    simplify_triangular<idx>(el, succession::predecessor);
+  } else if (cessor == "successor") {
+    simplify_triangular<idx>(el, succession::successor);
+  } else {
+    std::cout << "Bad succession: " + cessor << std::endl;
+  }
+}
+
+/**
+ * @brief Symmetrize an edge list and reduce it to a simple graph.
+ *
+ * Adds the edge (v, u) for every edge (u, v), and removes duplicate edges and
+ * self loops, leaving the edges sorted lexically by idx.  For vertex ids that
+ * fit in 32 bits this is a single radix sort.
+ *
+ * @tparam idx The column the edge list is sorted by.
+ * @param el The edge list.
+ */
+template <int idx, radix_sortable_edge_list edge_list_t>
+void simplify_symmetric(edge_list_t& el) {
+  if (unsigned bits = detail::vertex_id_bits(el); 2 * bits <= 64) {
+    detail::radix_simplify<idx>(el, bits, true, [](auto x, auto y) { return std::pair(x, y); });
+    return;
+  }
+
+  const size_t m = el.size();
+  el.resize(2 * m);
+  std::apply(
+      [&](auto& u, auto& v, auto&... attributes) {
+        std::copy(u.begin(), u.begin() + m, v.begin() + m);
+        std::copy(v.begin(), v.begin() + m, u.begin() + m);
+        (std::copy(attributes.begin(), attributes.begin() + m, attributes.begin() + m), ...);
+      },
+      static_cast<typename edge_list_t::base&>(el));
+  lexical_sort_by<idx>(el);
+  uniq(el);
+  remove_self_loops(el);
+}
 
 template <degree_enumerable_graph Graph, class ExecutionPolicy = default_execution_policy>
 auto degrees(const Graph& graph, ExecutionPolicy&& policy = {}) {
@@ -646,30 +1047,68 @@ requires(is_unipartite<typename edge_list_t::unipartite_graph_base>::value) auto
 }
 
 /**
- *  Make a map from data to the index value of each element in its container
+ *  Make a map from data to the index value of each element in its container.
+ *  Keys that std::hash supports are hashed into a concurrent_index_map in
+ *  parallel; any other keys go into a std::map, which needs operator<.
  */
 template <std::ranges::random_access_range R>
 auto make_index_map(const R& range) {
   using value_type = std::ranges::range_value_t<R>;
 
-  std::map<value_type, size_t> the_map;
-  for (size_t i = 0; i < size(range); ++i) {
-    the_map[range[i]] = i;
+  if constexpr (hashable_key<value_type>) {
+    concurrent_index_map<value_type> the_map(size(range));
+    the_map.insert_indices(range);
+    return the_map;
+  } else {
+    std::map<value_type, size_t> the_map;
+    for (size_t i = 0; i < size(range); ++i) {
+      the_map[range[i]] = i;
+    }
+    return the_map;
+  }
+}
+
+namespace detail {
+
+/// The index of a vertex key, through at() when the map has it, so a missing key throws.
+template <class M, class Key>
+auto mapped_index(M& map, const Key& key) {
+  if constexpr (requires { map.at(key); }) {
+    return map.at(key);
+  } else {
+    return map[key];
+  }
+}
+
+/// Call f(i) for every edge, in parallel when the map(s) support concurrent lookups.
+template <class... M, class F>
+void for_each_mapped_edge(std::size_t n, F&& f) {
+  if constexpr ((is_concurrent_index_map_v<std::remove_const_t<M>> && ...)) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, n), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        f(i);
+      }
+    });
+  } else {
+    for (std::size_t i = 0; i < n; ++i) {
+      f(i);
+    }
   }
-  return the_map;
 }
 
+}    // namespace detail
+
 /**
  * Make an edge list without properties from original data, e.g., vector<tuple<size_t, size_t>>
  */
 template <class M, std::ranges::random_access_range E, class Edge = decltype(std::tuple_cat(std::tuple<size_t, size_t>())),
           class EdgeList = std::vector<Edge>>
 auto make_plain_edges(M& map, const E& edges) {
-  EdgeList index_edges;
+  EdgeList index_edges(size(edges));
 
-  for (Edge&& e : edges) {
-    std::apply([&](auto&& u, auto&& v, auto... props_) { index_edges.push_back(std::make_tuple(map[u], map[v])); }, e);
-  }
+  detail::for_each_mapped_edge<M>(size(edges), [&](size_t i) {
+    std::apply([&](auto&& u, auto&& v, auto&&...) { index_edges[i] = Edge(detail::mapped_index(map, u), detail::mapped_index(map, v)); }, edges[i]);
+  });
 
   return index_edges;
 }
@@ -680,11 +1119,11 @@ auto make_plain_edges(M& map, const E& edges) {
 template <class M, std::ranges::random_access_range E, class Edge = decltype(std::tuple_cat(std::tuple<size_t, size_t>(), props(E()[0]))),
           class EdgeList = std::vector<Edge>>
 auto make_property_edges(M& map, const E& edges) {
-  EdgeList index_edges;
+  EdgeList index_edges(size(edges));
 
-  for (auto&& e : edges) {
-    std::apply([&](auto&& u, auto&& v, auto... props_) { index_edges.push_back(std::make_tuple(map[u], map[v], props_...)); }, e);
-  }
+  detail::for_each_mapped_edge<M>(size(edges), [&](size_t i) {
+    std::apply([&](auto&& u, auto&& v, auto&&... props_) { index_edges[i] = Edge(detail::mapped_index(map, u), detail::mapped_index(map, v), props_...); }, edges[i]);
+  });
 
   return index_edges;
 }
@@ -695,15 +1134,14 @@ auto make_property_edges(M& map, const E& edges) {
 template <class I = std::vector<std::tuple<size_t, size_t, size_t>>, class M, std::ranges::random_access_range E>
 auto make_index_edges(M& map, const E& edges) {
 
-  auto index_edges = I();
-
-  for (size_t i = 0; i < size(edges); ++i) {
+  auto index_edges = I(size(edges));
 
-    auto left  = std::get<0>(edges[i]);
-    auto right = std::get<1>(edges[i]);
+  detail::for_each_mapped_edge<M>(size(edges), [&](size_t i) {
+    auto&& left  = std::get<0>(edges[i]);
+    auto&& right = std::get<1>(edges[i]);
 
-    index_edges.push_back(std::make_tuple(map[left], map[right], i));
-  }
+    index_edges[i] = std::make_tuple(detail::mapped_index(map, left), detail::mapped_index(map, right), i);
+  });
 
   return index_edges;
 }
@@ -764,15 +1202,14 @@ auto data_to_graph_edge_list(const V& left_vertices, const V& right_vertices, co
   auto left_map  = make_index_map(left_vertices);
   auto right_map = make_index_map(right_vertices);
 
-  std::vector<std::tuple<size_t, size_t>> index_edges;
-
-  for (size_t i = 0; i < size(edges); ++i) {
+  std::vector<std::tuple<size_t, size_t>> index_edges(size(edges));
 
-    auto left  = std::get<0>(edges[i]);
-    auto right = std::get<1>(edges[i]);
+  detail::for_each_mapped_edge<decltype(left_map), decltype(right_map)>(size(edges), [&](size_t i) {
+    auto&& left  = std::get<0>(edges[i]);
+    auto&& right = std::get<1>(edges[i]);
 
-    index_edges.push_back({left_map[left], right_map[right]});
-  }
+    index_edges[i] = {detail::mapped_index(left_map, left), detail::mapped_index(right_map, right)};
+  });
 
   return index_edges;
 }
@@ -833,6 +1270,9 @@ auto make_bipartite_graphs(const V& left_vertices, const V& right_vertices, cons
   return make_tuple(G, H);
 }
 
+/// Sequential pairwise join of two bipartite adjacencies, materializing every
+/// (i, j, k) triple.  See bipartite_projection() in
+/// nwgraph/algorithms/projection.hpp for the parallel CSR version.
 template <class Graph1, class Graph2, class IndexGraph = std::vector<std::vector<std::tuple<size_t, size_t>>>>
 auto join(const Graph1& G, const Graph2& H) {
 
@@ -31,6 +31,8 @@
 #include <iostream>
 #include <istream>
 #include <numeric>
+#include <stdexcept>
+#include <string>
 
 #if defined(CL_SYCL_LANGUAGE_VERSION)
 #include <dpstd/algorithm>
@@ -244,7 +246,7 @@ public:    // fixme
     if (to_be_indexed_.size() == 0) return;
 
     indices_.resize(N_ + 1);
-    std::exclusive_scan(indices_.begin(), indices_.end(), indices_.begin(), 0);
+    std::exclusive_scan(indices_.begin(), indices_.end(), indices_.begin(), index_t(0));
     assert(indices_.back() == to_be_indexed_.size());
     is_open_ = false;
   }
@@ -300,20 +302,21 @@ public:    // fixme
     }
   }
 
-  void serialize(std::ostream& outfile) {
+  void serialize(std::ostream& outfile) const {
     size_t el_size = sizeof(indices_[0]);
     size_t st_size = indices_.size();
+    size_t N       = N_;
 
     outfile.write(reinterpret_cast<const char*>(magic_), sizeof(magic_));
-    outfile.write(reinterpret_cast<char*>(&N_), sizeof(size_t));
+    outfile.write(reinterpret_cast<char*>(&N), sizeof(size_t));
 
     outfile.write(reinterpret_cast<char*>(&st_size), sizeof(size_t));
     outfile.write(reinterpret_cast<char*>(&el_size), sizeof(size_t));
-    outfile.write(reinterpret_cast<char*>(indices_.data()), st_size * el_size);
+    outfile.write(reinterpret_cast<const char*>(indices_.data()), st_size * el_size);
     to_be_indexed_.serialize(outfile);
   }
 
-  void serialize(const std::string& outfile_name) {
+  void serialize(const std::string& outfile_name) const {
     std::ofstream out_file(outfile_name, std::ofstream::binary);
     serialize(out_file);
   }
@@ -322,12 +325,18 @@ public:    // fixme
     char   spell[sizeof(magic_) + 1];
     size_t el_size = -1;
     size_t st_size = -1;
+    size_t N       = 0;
 
     infile.read(reinterpret_cast<char*>(spell), sizeof(magic_));
-    infile.read(reinterpret_cast<char*>(&N_), sizeof(size_t));
+    infile.read(reinterpret_cast<char*>(&N), sizeof(size_t));
+    N_ = N;
 
     infile.read(reinterpret_cast<char*>(&st_size), sizeof(size_t));
     infile.read(reinterpret_cast<char*>(&el_size), sizeof(size_t));
+    if (el_size != sizeof(index_t)) {
+      throw std::runtime_error("file has " + std::to_string(el_size) + " byte indices but " + std::to_string(sizeof(index_t)) +
+                               " were expected (NWGRAPH_64BIT_INDEX mismatch?)");
+    }
     indices_.resize(st_size);
     infile.read(reinterpret_cast<char*>(indices_.data()), st_size * el_size);
     to_be_indexed_.deserialize(infile);
@@ -175,6 +175,13 @@ struct struct_of_arrays : std::tuple<std::vector<Attributes>...> {
     pointer operator->() {
       return {**this};
     }
+
+    /// Pointer to the element of the k-th column at the iterator position;
+    /// columns are contiguous, so this allows vectorized access to ranges.
+    template <std::size_t k = 0>
+    auto* column_data() const {
+      return std::get<k>(*soa_).data() + i_;
+    }
   };
 
   using iterator = soa_iterator<false>;
@@ -167,6 +167,19 @@ public:
     base::push_back(elem);
   }
 
+  /**
+   * Grow the vertex cardinality to cover vertex ids that were written into the columns directly rather than
+   * through push_back.  For a unipartite edge list only n[0] is used.
+   */
+  void extend_vertex_cardinality(const std::array<size_t, 2>& n) {
+    if constexpr (is_unipartite<graph_base>::value) {
+      graph_base::vertex_cardinality[0] = std::max(n[0], graph_base::vertex_cardinality[0]);
+    } else {
+      graph_base::vertex_cardinality[0] = std::max(n[0], graph_base::vertex_cardinality[0]);
+      graph_base::vertex_cardinality[1] = std::max(n[1], graph_base::vertex_cardinality[1]);
+    }
+  }
+
   size_t size() const { return base::size(); }
   // size_t length() const { return base::size(); }
   // auto max() const { return graph_base::vertex_cardinality; }
@@ -18,6 +18,10 @@
 #include <cstring>
 #include <fcntl.h>
 #include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -41,10 +45,10 @@ public:
 };
 
 class MatrixMarketFile final {
-  int fd_  = -1;    // .mtx file descriptor
-  int n_   = 0;     // number of rows
-  int m_   = 0;     // number of columns
-  int nnz_ = 0;     // number of edges
+  int  fd_  = -1;    // .mtx file descriptor
+  long n_   = 0;     // number of rows
+  long m_   = 0;     // number of columns
+  long nnz_ = 0;     // number of edges
 
   char* base_ = nullptr;    // base pointer to mmap-ed file
   long  i_    = 0;          // byte offset of the first edge
@@ -53,49 +57,78 @@ class MatrixMarketFile final {
   MM_typecode type_;
 
 public:
+  /// Map the file at path, throwing std::runtime_error if it cannot be read
+  /// or is not a real, integer or pattern coordinate file that is general or
+  /// symmetric (complex files are rejected).
   explicit MatrixMarketFile(std::filesystem::path path) : fd_(open(path.c_str(), O_RDONLY)) {
+    // Release what has been acquired so far and throw, with errno if nonzero.
+    auto fail = [&](std::string what, int err = 0) {
+      release();
+      if (err) {
+        what += ", " + std::to_string(err) + ": " + strerror(err);
+      }
+      throw std::runtime_error(path.string() + ": " + what);
+    };
+
     if (fd_ < 0) {
-      fprintf(stderr, "open failed, %d: %s\n", errno, strerror(errno));
-      std::terminate();
+      fail("open failed", errno);
     }
 
-    FILE* f = fdopen(fd_, "r");
+    // Read the header through a stream on a duplicate of fd_, so that closing
+    // the stream leaves fd_ open for mmap.
+    int dup_fd = dup(fd_);
+    if (dup_fd < 0) {
+      fail("dup failed", errno);
+    }
+    std::unique_ptr<FILE, int (*)(FILE*)> f(fdopen(dup_fd, "r"), &fclose);
     if (f == nullptr) {
-      fprintf(stderr, "fdopen failed, %d: %s\n", errno, strerror(errno));
-      goto error;
+      int err = errno;
+      close(dup_fd);
+      fail("fdopen failed", err);
     }
 
-    switch (mm_read_banner(f, &type_)) {
+    switch (mm_read_banner(f.get(), &type_)) {
       case MM_PREMATURE_EOF:       // if all items are not present on first line of file.
       case MM_NO_HEADER:           // if the file does not begin with "%%MatrixMarket".
       case MM_UNSUPPORTED_TYPE:    // if not recongizable description.
-        goto error;
+        fail("not a supported Matrix Market file");
     }
 
     if (!mm_is_coordinate(type_)) {
-      goto error;
+      fail("not a coordinate Matrix Market file");
     }
 
-    switch (mm_read_mtx_crd_size(f, &n_, &m_, &nnz_)) {
-      case MM_PREMATURE_EOF:    // if an end-of-file is encountered before processing these three values.
-        goto error;
+    // An entry holds a real and an imaginary part, and only one value is read.
+    if (mm_is_complex(type_)) {
+      fail("complex Matrix Market files are not supported");
     }
 
-    i_ = ftell(f);
-    fseek(f, 0L, SEEK_END);
-    e_ = ftell(f);
+    // Only the stored triangle of these is in the file, and the mirrored
+    // entries would need their values negated or conjugated.
+    if (mm_is_skew(type_) || mm_is_hermitian(type_)) {
+      fail("skew-symmetric and hermitian Matrix Market files are not supported");
+    }
 
-    base_ = static_cast<char*>(mmap(nullptr, e_, PROT_READ, MAP_PRIVATE, fd_, 0));
-    if (base_ == MAP_FAILED) {
-      fprintf(stderr, "mmap failed, %d: %s\n", errno, strerror(errno));
-      goto error;
+    // mm_read_mtx_crd_size reads ints, which overflow for files with 2^31 or more entries
+    {
+      char line[MM_MAX_LINE_LENGTH + 1];
+      do {
+        if (fgets(line, sizeof(line), f.get()) == nullptr) {    // end-of-file before the size line
+          fail("no size line");
+        }
+      } while (line[0] == '%' || sscanf(line, "%ld %ld %ld", &n_, &m_, &nnz_) != 3);
     }
 
-    return;
+    i_ = ftell(f.get());
+    if (i_ < 0 || fseek(f.get(), 0L, SEEK_END) || (e_ = ftell(f.get())) < 0) {
+      fail("seek failed", errno);
+    }
 
-  error:
-    close(fd_);
-    std::terminate();
+    void* base = mmap(nullptr, e_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (base == MAP_FAILED) {
+      fail("mmap failed", errno);
+    }
+    base_ = static_cast<char*>(base);
   };
 
   ~MatrixMarketFile() { release(); };
@@ -116,16 +149,19 @@ public:
   /// ADL
   friend void release(MatrixMarketFile& mm) { mm.release(); }
 
-  int getNRows() const { return n_; }
+  long getNRows() const { return n_; }
 
-  int getNCols() const { return m_; }
+  long getNCols() const { return m_; }
 
-  int getNEdges() const { return nnz_; }
+  long getNEdges() const { return nnz_; }
 
   bool isPattern() const { return mm_is_pattern(type_); }
 
   bool isSymmetric() const { return mm_is_symmetric(type_); }
 
+  /// The mmap-ed bytes holding the edge entries, from the first entry to the end of the file.
+  std::string_view entries() const { return {base_ + i_, size_t(e_ - i_)}; }
+
   // Iterator over edges in the file.
   template <typename... Vs>
   class iterator {
@@ -139,7 +175,7 @@ public:
     static constexpr U get(const char*(&i)) {
       U     v;
       char* e;
-      if constexpr (std::is_same_v<U, int>) {
+      if constexpr (std::is_integral_v<U>) {
         v = std::strtol(i, &e, 10);
       } else {
         v = std::strtod(i, &e);
@@ -151,10 +187,10 @@ public:
   public:
     iterator(const char* i) : i_(i) {}
 
-    std::tuple<int, int, Vs...> operator*() const {
+    std::tuple<long, long, Vs...> operator*() const {
       const char* i = i_;
-      int         u = get<int>(i) - 1;
-      int         v = get<int>(i) - 1;
+      long        u = get<long>(i) - 1;
+      long        v = get<long>(i) - 1;
       return std::tuple(u, v, get<Vs>(i)...);
     }
 
@@ -194,7 +230,7 @@ public:
 };
 
 template <typename... Vs>
-auto edges(const MatrixMarketFile& mm, int j, int k) {
+auto edges(const MatrixMarketFile& mm, long j, long k) {
   return Range(mm.template at<Vs...>(j), mm.template at<Vs...>(k));
 }
 }    // namespace mmio
@@ -0,0 +1,607 @@
+/**
+ * @file mapped_graph.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_MAPPED_GRAPH_HPP
+#define NW_GRAPH_MAPPED_GRAPH_HPP
+
+#include "nwgraph/adaptors/splittable_range_adaptor.hpp"
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/graph_base.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/util/arrow_proxy.hpp"
+#include "nwgraph/util/defaults.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <type_traits>
+#include <unistd.h>
+#include <vector>
+
+namespace nw {
+namespace graph {
+
+/**
+ * @brief Header of the memory-mapped graph format.
+ *
+ * The file is this header followed by one block per column.  Every block starts on a
+ * page boundary, so once the file is mmap-ed the columns can be used in place.  An
+ * adjacency stores the N + 1 offsets followed by the targets and one block per edge
+ * attribute; an edge list stores the sources, the targets and one block per attribute.
+ */
+struct mapped_graph_header {
+  static constexpr char     magic_[16]  = "NW GRAPH mapped";
+  static constexpr uint32_t version_    = 2;
+  static constexpr size_t   alignment_  = 4096;
+  static constexpr size_t   max_blocks_ = 16;
+
+  enum kind_t : uint32_t { adjacency_kind = 0, edge_list_kind = 1 };
+
+  struct block_t {
+    uint64_t offset;          // byte offset from the start of the file
+    uint64_t count;           // number of elements
+    uint64_t element_size;    // sizeof each element
+    uint64_t element_type;    // type_code of each element
+  };
+
+  enum type_class_t : uint64_t { opaque_class = 0, unsigned_class = 1, signed_class = 2, floating_class = 3 };
+
+  /// The class of an element type in the high word and its size in the low one.
+  /// Types other than arithmetic ones are only told apart by their size.
+  template <class T>
+  static constexpr uint64_t type_code() {
+    uint64_t c = std::is_floating_point_v<T> ? floating_class
+                 : std::is_integral_v<T>     ? (std::is_signed_v<T> ? signed_class : unsigned_class)
+                                             : opaque_class;
+    return c << 32 | sizeof(T);
+  }
+
+  static std::string type_name(uint64_t code) {
+    static constexpr const char* classes[] = {"opaque", "unsigned", "signed", "floating point"};
+    return std::to_string(code & 0xffffffff) + " byte " + ((code >> 32) < 4 ? classes[code >> 32] : "unknown");
+  }
+
+  char     magic[16];
+  uint32_t version;
+  uint32_t kind;
+  uint32_t orientation;    // idx of an adjacency, directedness of an edge list
+  uint32_t num_blocks;
+  uint64_t num_vertices;
+  uint64_t num_edges;
+  block_t  blocks[max_blocks_];
+
+  static constexpr size_t align(size_t n) { return (n + alignment_ - 1) / alignment_ * alignment_; }
+};
+
+/**
+ * @brief Read-only mapping of a file in the mapped graph format.
+ *
+ * The mapping is shared, so processes that open the same file share its page cache.
+ */
+class mapped_graph_file {
+  int         fd_   = -1;
+  const char* base_ = nullptr;
+  size_t      size_ = 0;
+  std::string path_;
+
+public:
+  [[noreturn]] void fail(const std::string& what) const { throw std::runtime_error(path_ + ": " + what); }
+
+  explicit mapped_graph_file(const std::string& path) : fd_(open(path.c_str(), O_RDONLY)), path_(path) {
+    if (fd_ < 0) {
+      fail(std::string("open failed: ") + strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st)) {
+      close(fd_);
+      fail(std::string("fstat failed: ") + strerror(errno));
+    }
+    size_ = st.st_size;
+    if (size_ < sizeof(mapped_graph_header)) {
+      close(fd_);
+      fail("too small to be a mapped graph");
+    }
+
+    void* base = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (base == MAP_FAILED) {
+      close(fd_);
+      fail(std::string("mmap failed: ") + strerror(errno));
+    }
+    base_ = static_cast<const char*>(base);
+
+    const mapped_graph_header& h = header();
+    if (std::memcmp(h.magic, mapped_graph_header::magic_, sizeof(h.magic)) || h.version != mapped_graph_header::version_ ||
+        h.num_blocks > mapped_graph_header::max_blocks_) {
+      release();
+      fail("not a version " + std::to_string(mapped_graph_header::version_) + " mapped graph");
+    }
+    for (uint32_t i = 0; i < h.num_blocks; ++i) {
+      const auto& b = h.blocks[i];
+      if (b.offset % mapped_graph_header::alignment_ || b.offset > size_ || b.element_size == 0 ||
+          b.count > (size_ - b.offset) / b.element_size) {
+        release();
+        fail("block " + std::to_string(i) + " lies outside the file");
+      }
+    }
+  }
+
+  mapped_graph_file(const mapped_graph_file&)            = delete;
+  mapped_graph_file& operator=(const mapped_graph_file&) = delete;
+
+  ~mapped_graph_file() { release(); }
+
+  void release() {
+    if (base_ && munmap(const_cast<char*>(base_), size_)) {
+      std::cerr << "munmap failed: " << strerror(errno) << std::endl;
+    }
+    base_ = nullptr;
+    if (fd_ != -1 && close(fd_)) {
+      std::cerr << "close failed: " << strerror(errno) << std::endl;
+    }
+    fd_ = -1;
+  }
+
+  const mapped_graph_header& header() const { return *reinterpret_cast<const mapped_graph_header*>(base_); }
+
+  /// Check the shape of the file against what the caller expects to view it as.
+  void expect(uint32_t kind, uint32_t orientation, uint32_t num_blocks) const {
+    const mapped_graph_header& h = header();
+    if (h.kind != kind) {
+      fail(kind == mapped_graph_header::adjacency_kind ? "does not hold an adjacency" : "does not hold an edge list");
+    }
+    if (h.orientation != orientation) {
+      fail("was written with orientation " + std::to_string(h.orientation) + ", not " + std::to_string(orientation));
+    }
+    if (h.num_blocks != num_blocks) {
+      fail("has " + std::to_string(h.num_blocks) + " columns, not " + std::to_string(num_blocks));
+    }
+  }
+
+  /// Get a typed pointer to block i, checking its element type and length.
+  template <class T>
+  const T* block(uint32_t i, size_t count) const {
+    const auto& b = header().blocks[i];
+    if (b.element_size != sizeof(T) || b.element_type != mapped_graph_header::type_code<T>()) {
+      fail("block " + std::to_string(i) + " has " + mapped_graph_header::type_name(b.element_type) + " elements, not " +
+           mapped_graph_header::type_name(mapped_graph_header::type_code<T>()));
+    }
+    if (b.count != count) {
+      fail("block " + std::to_string(i) + " has " + std::to_string(b.count) + " elements, not " + std::to_string(count));
+    }
+    return reinterpret_cast<const T*>(base_ + b.offset);
+  }
+};
+
+/**
+ * @brief Random access iterator over a set of parallel read-only columns.
+ *
+ * Like the struct_of_arrays iterator this keeps a single cursor.  The columns are
+ * read-only, so it dereferences to a tuple of values rather than of references.
+ */
+template <class... Ts>
+class mapped_columns_iterator {
+  std::tuple<const Ts*...> columns_;
+  std::ptrdiff_t           i_ = 0;
+
+public:
+  using value_type        = std::tuple<Ts...>;
+  using difference_type   = std::ptrdiff_t;
+  using reference         = value_type;
+  using pointer           = arrow_proxy<reference>;
+  using iterator_category = std::random_access_iterator_tag;
+
+  mapped_columns_iterator() = default;
+  mapped_columns_iterator(std::tuple<const Ts*...> columns, std::ptrdiff_t i) : columns_(columns), i_(i) {}
+
+  reference operator*() const {
+    return std::apply([&](auto... c) { return reference(c[i_]...); }, columns_);
+  }
+  reference operator[](difference_type n) const { return *(*this + n); }
+  pointer   operator->() const { return {**this}; }
+
+  mapped_columns_iterator& operator++() {
+    ++i_;
+    return *this;
+  }
+  mapped_columns_iterator operator++(int) {
+    mapped_columns_iterator tmp(*this);
+    ++i_;
+    return tmp;
+  }
+  mapped_columns_iterator& operator--() {
+    --i_;
+    return *this;
+  }
+  mapped_columns_iterator operator--(int) {
+    mapped_columns_iterator tmp(*this);
+    --i_;
+    return tmp;
+  }
+  mapped_columns_iterator& operator+=(difference_type n) {
+    i_ += n;
+    return *this;
+  }
+  mapped_columns_iterator& operator-=(difference_type n) {
+    i_ -= n;
+    return *this;
+  }
+
+  mapped_columns_iterator operator+(difference_type n) const { return {columns_, i_ + n}; }
+  mapped_columns_iterator operator-(difference_type n) const { return {columns_, i_ - n}; }
+  friend mapped_columns_iterator operator+(difference_type n, const mapped_columns_iterator& i) { return i + n; }
+
+  difference_type operator-(const mapped_columns_iterator& b) const { return i_ - b.i_; }
+
+  bool operator==(const mapped_columns_iterator& b) const { return i_ == b.i_; }
+  auto operator<=>(const mapped_columns_iterator& b) const { return i_ <=> b.i_; }
+
+  /// Pointer to the element of the k-th column at the iterator position.
+  template <std::size_t k = 0>
+  const auto* column_data() const { return std::get<k>(columns_) + i_; }
+};
+
+/**
+ * @brief Zero-copy, read-only adjacency view of a file written by write_mapped.
+ *
+ * Copies of the view share the mapping, which is released with the last copy.
+ *
+ * @tparam idx The orientation the adjacency was built with, 0 or 1.
+ * @tparam index_type The data type used to represent an edge offset.
+ * @tparam vertex_id The data type used to represent a vertex ID.
+ * @tparam Attributes A variadic list of edge property types.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, typename... Attributes>
+requires(std::is_trivially_copyable_v<Attributes>&&...) class index_mapped_adjacency {
+  std::shared_ptr<const mapped_graph_file>   file_;
+  size_t                                     N_ = 0;
+  size_t                                     M_ = 0;
+  const index_type*                          indices_ = nullptr;
+  std::tuple<const vertex_id*, const Attributes*...> columns_;
+
+public:
+  using index_t           = index_type;
+  using vertex_id_type    = vertex_id;
+  using num_vertices_type = std::array<vertex_id_type, 1>;
+  using num_edges_type    = index_t;
+  using attributes_t      = std::tuple<Attributes...>;
+
+  using inner_iterator = mapped_columns_iterator<vertex_id, Attributes...>;
+  using sub_view       = splittable_range_adaptor<inner_iterator>;
+
+  static constexpr std::size_t getNAttr() { return sizeof...(Attributes); }
+
+  class outer_iterator {
+    const index_type*                                  indices_ = nullptr;
+    std::tuple<const vertex_id*, const Attributes*...> columns_;
+    std::ptrdiff_t                                     i_ = 0;
+
+  public:
+    using value_type        = sub_view;
+    using difference_type   = std::ptrdiff_t;
+    using reference         = sub_view;
+    using pointer           = arrow_proxy<reference>;
+    using iterator_category = std::random_access_iterator_tag;
+
+    outer_iterator() = default;
+    outer_iterator(const index_type* indices, std::tuple<const vertex_id*, const Attributes*...> columns, std::ptrdiff_t i)
+        : indices_(indices), columns_(columns), i_(i) {}
+
+    reference operator*() const { return {inner_iterator(columns_, indices_[i_]), inner_iterator(columns_, indices_[i_ + 1])}; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+    pointer   operator->() const { return {**this}; }
+
+    outer_iterator& operator++() {
+      ++i_;
+      return *this;
+    }
+    outer_iterator operator++(int) {
+      outer_iterator tmp(*this);
+      ++i_;
+      return tmp;
+    }
+    outer_iterator& operator--() {
+      --i_;
+      return *this;
+    }
+    outer_iterator operator--(int) {
+      outer_iterator tmp(*this);
+      --i_;
+      return tmp;
+    }
+    outer_iterator& operator+=(difference_type n) {
+      i_ += n;
+      return *this;
+    }
+    outer_iterator& operator-=(difference_type n) {
+      i_ -= n;
+      return *this;
+    }
+
+    outer_iterator        operator+(difference_type n) const { return {indices_, columns_, i_ + n}; }
+    outer_iterator        operator-(difference_type n) const { return {indices_, columns_, i_ - n}; }
+    friend outer_iterator operator+(difference_type n, const outer_iterator& i) { return i + n; }
+
+    difference_type operator-(const outer_iterator& b) const { return i_ - b.i_; }
+
+    bool operator==(const outer_iterator& b) const { return i_ == b.i_; }
+    auto operator<=>(const outer_iterator& b) const { return i_ <=> b.i_; }
+  };
+
+  using iterator        = outer_iterator;
+  using const_iterator  = outer_iterator;
+  using value_type      = sub_view;
+  using reference       = sub_view;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  index_mapped_adjacency() = default;
+
+  /**
+   * @brief Map the file at path.  Throws std::runtime_error if it does not hold an
+   * adjacency with this orientation, index type, vertex id type and attributes.
+   *
+   * Only the header, the block sizes and the first and last offsets are checked, which
+   * touches a few pages whatever the size of the graph.  Pass validate = true (or call
+   * validate()) to also scan every offset of a file that may be corrupt.
+   */
+  explicit index_mapped_adjacency(const std::string& path, bool validate = false)
+      : file_(std::make_shared<const mapped_graph_file>(path)) {
+    file_->expect(mapped_graph_header::adjacency_kind, idx, 2 + sizeof...(Attributes));
+    N_       = file_->header().num_vertices;
+    M_       = file_->header().num_edges;
+    indices_ = file_->template block<index_type>(0, N_ + 1);
+    if (indices_[0] != 0 || indices_[N_] != M_) {
+      file_->fail("offsets do not run from 0 to the number of edges");
+    }
+    columns_ = [&]<size_t... Is>(std::index_sequence<Is...>) {
+      return std::tuple(file_->template block<vertex_id>(1, M_), file_->template block<Attributes>(2 + Is, M_)...);
+    }(std::index_sequence_for<Attributes...>());
+    if (validate) {
+      this->validate();
+    }
+  }
+
+  /// Check that the offsets never decrease, reading all of them.  Throws std::runtime_error if they do.
+  void validate() const {
+    if (std::adjacent_find(indices_, indices_ + N_ + 1, std::greater{}) != indices_ + N_ + 1) {
+      file_->fail("offsets are not a nondecreasing sequence");
+    }
+  }
+
+  iterator begin() const { return {indices_, columns_, 0}; }
+  iterator end() const { return {indices_, columns_, std::ptrdiff_t(N_)}; }
+
+  reference operator[](size_t i) const { return begin()[i]; }
+
+  size_t size() const { return N_; }
+
+  num_vertices_type num_vertices() const { return {static_cast<vertex_id_type>(N_)}; }
+  num_edges_type    num_edges() const { return M_; }
+
+  /// Raw access to the mapped columns, mirroring indexed_struct_of_arrays::indices_ and to_be_indexed_.
+  const index_type*                                        indices() const { return indices_; }
+  const std::tuple<const vertex_id*, const Attributes*...>& columns() const { return columns_; }
+};
+
+template <int idx, typename... Attributes>
+using mapped_adjacency = index_mapped_adjacency<idx, default_index_t, default_vertex_id_type, Attributes...>;
+
+/**
+ * @brief Zero-copy, read-only edge list view of a file written by write_mapped.
+ *
+ * @tparam vertex_id The data type used to represent a vertex ID.
+ * @tparam direct The directedness the edge list was written with.
+ * @tparam Attributes A variadic list of edge property types.
+ */
+template <std::unsigned_integral vertex_id, directedness direct = directedness::undirected, typename... Attributes>
+requires(std::is_trivially_copyable_v<Attributes>&&...) class index_mapped_edge_list {
+  std::shared_ptr<const mapped_graph_file>                       file_;
+  size_t                                                         N_ = 0;
+  size_t                                                         M_ = 0;
+  std::tuple<const vertex_id*, const vertex_id*, const Attributes*...> columns_;
+
+public:
+  using vertex_id_type    = vertex_id;
+  using attributes_t      = std::tuple<Attributes...>;
+  using num_vertices_type = std::array<size_t, 1>;
+  using num_edges_type    = std::ptrdiff_t;
+
+  static const directedness edge_directedness = direct;
+
+  using iterator        = mapped_columns_iterator<vertex_id, vertex_id, Attributes...>;
+  using const_iterator  = iterator;
+  using value_type      = typename iterator::value_type;
+  using reference       = typename iterator::reference;
+  using size_type       = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  index_mapped_edge_list() = default;
+
+  /**
+   * @brief Map the file at path.  Throws std::runtime_error if it does not hold an edge
+   * list with this directedness, vertex id type and attributes.
+   */
+  explicit index_mapped_edge_list(const std::string& path) : file_(std::make_shared<const mapped_graph_file>(path)) {
+    file_->expect(mapped_graph_header::edge_list_kind, uint32_t(direct), 2 + sizeof...(Attributes));
+    N_       = file_->header().num_vertices;
+    M_       = file_->header().num_edges;
+    columns_ = [&]<size_t... Is>(std::index_sequence<Is...>) {
+      return std::tuple(file_->template block<vertex_id>(0, M_), file_->template block<vertex_id>(1, M_),
+                        file_->template block<Attributes>(2 + Is, M_)...);
+    }(std::index_sequence_for<Attributes...>());
+  }
+
+  iterator begin() const { return {columns_, 0}; }
+  iterator end() const { return {columns_, std::ptrdiff_t(M_)}; }
+
+  reference operator[](size_t i) const { return begin()[i]; }
+
+  size_t size() const { return M_; }
+
+  num_vertices_type num_vertices() const { return {N_}; }
+  num_edges_type    num_edges() const { return M_; }
+};
+
+template <directedness direct = directedness::undirected, typename... Attributes>
+using mapped_edge_list = index_mapped_edge_list<default_vertex_id_type, direct, Attributes...>;
+
+namespace detail {
+/// Assign the block offsets from the counts and element sizes, and return the size of the file.
+inline size_t layout_mapped_blocks(mapped_graph_header& h) {
+  size_t offset = mapped_graph_header::align(sizeof(mapped_graph_header));
+  for (uint32_t i = 0; i < h.num_blocks; ++i) {
+    h.blocks[i].offset = offset;
+    offset             = mapped_graph_header::align(offset + h.blocks[i].count * h.blocks[i].element_size);
+  }
+  return offset;
+}
+
+inline void write_mapped_blocks(const std::string& path, mapped_graph_header& h, const std::vector<const void*>& data) {
+  size_t offset = layout_mapped_blocks(h);
+
+  std::ofstream out(path, std::ofstream::binary);
+  if (!out) {
+    throw std::runtime_error(path + ": could not open for writing");
+  }
+
+  std::vector<char> zeros(mapped_graph_header::alignment_);
+  size_t            written = 0;
+  auto              write   = [&](const void* p, size_t bytes) {
+    out.write(static_cast<const char*>(p), bytes);
+    written += bytes;
+  };
+  auto pad = [&](size_t to) { write(zeros.data(), to - written); };
+
+  write(&h, sizeof(h));
+  for (uint32_t i = 0; i < h.num_blocks; ++i) {
+    pad(h.blocks[i].offset);
+    write(data[i], h.blocks[i].count * h.blocks[i].element_size);
+  }
+  pad(offset);
+
+  if (!out) {
+    throw std::runtime_error(path + ": write failed");
+  }
+}
+
+inline mapped_graph_header make_mapped_header(uint32_t kind, uint32_t orientation, uint32_t num_blocks, size_t N, size_t M) {
+  mapped_graph_header h{};
+  std::memcpy(h.magic, mapped_graph_header::magic_, sizeof(h.magic));
+  h.version      = mapped_graph_header::version_;
+  h.kind         = kind;
+  h.orientation  = orientation;
+  h.num_blocks   = num_blocks;
+  h.num_vertices = N;
+  h.num_edges    = M;
+  return h;
+}
+}    // namespace detail
+
+/**
+ * @brief Write an adjacency in the mapped graph format, to be opened with index_mapped_adjacency.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, typename... Attributes>
+requires(std::is_trivially_copyable_v<Attributes>&&...) void write_mapped(const std::string&                                               path,
+                                                                          const index_adjacency<idx, index_type, vertex_id, Attributes...>& g) {
+  static_assert(2 + sizeof...(Attributes) <= mapped_graph_header::max_blocks_, "too many attributes for the mapped graph format");
+  size_t N = g.size(), M = g.num_edges();
+  auto   h = detail::make_mapped_header(mapped_graph_header::adjacency_kind, idx, 2 + sizeof...(Attributes), N, M);
+
+  std::vector<const void*> data{g.indices_.data()};
+  h.blocks[0] = {0, N + 1, sizeof(index_type), mapped_graph_header::type_code<index_type>()};
+  std::apply(
+      [&](auto&... cols) {
+        uint32_t i = 1;
+        ((h.blocks[i++] = {0, M, sizeof(cols[0]), mapped_graph_header::type_code<std::remove_cvref_t<decltype(cols[0])>>()},
+          data.push_back(cols.data())),
+         ...);
+      },
+      g.to_be_indexed_);
+
+  detail::write_mapped_blocks(path, h, data);
+}
+
+/**
+ * @brief Write an edge list in the mapped graph format, to be opened with index_mapped_edge_list.
+ */
+template <std::unsigned_integral vertex_id, directedness direct, typename... Attributes>
+requires(std::is_trivially_copyable_v<Attributes>&&...) void write_mapped(
+    const std::string& path, const index_edge_list<vertex_id, unipartite_graph_base, direct, Attributes...>& el) {
+  static_assert(2 + sizeof...(Attributes) <= mapped_graph_header::max_blocks_, "too many attributes for the mapped graph format");
+  size_t N = el.num_vertices()[0], M = el.size();
+  auto   h = detail::make_mapped_header(mapped_graph_header::edge_list_kind, uint32_t(direct), 2 + sizeof...(Attributes), N, M);
+
+  std::vector<const void*> data;
+  std::apply(
+      [&](auto&... cols) {
+        uint32_t i = 0;
+        ((h.blocks[i++] = {0, M, sizeof(cols[0]), mapped_graph_header::type_code<std::remove_cvref_t<decltype(cols[0])>>()},
+          data.push_back(cols.data())),
+         ...);
+      },
+      static_cast<const typename index_edge_list<vertex_id, unipartite_graph_base, direct, Attributes...>::base&>(el));
+
+  detail::write_mapped_blocks(path, h, data);
+}
+
+//index_mapped_adjacency num_vertices CPO
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id_type, typename... Attributes>
+auto tag_invoke(const num_vertices_tag, const index_mapped_adjacency<idx, index_type, vertex_id_type, Attributes...>& g) {
+  return g.num_vertices()[0];
+}
+//index_mapped_adjacency degree CPO
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id_type, std::unsigned_integral lookup_type, typename... Attributes>
+auto tag_invoke(const degree_tag, const index_mapped_adjacency<idx, index_type, vertex_id_type, Attributes...>& g, lookup_type i) {
+  return g.indices()[i + 1] - g.indices()[i];
+}
+//index_mapped_edge_list num_vertices CPO
+template <std::unsigned_integral vertex_id, directedness direct, typename... Attributes>
+auto tag_invoke(const num_vertices_tag, const index_mapped_edge_list<vertex_id, direct, Attributes...>& el) {
+  return el.num_vertices()[0];
+}
+//index_mapped_edge_list num_edges CPO
+template <std::unsigned_integral vertex_id, directedness direct, typename... Attributes>
+auto tag_invoke(const num_edges_tag, const index_mapped_edge_list<vertex_id, direct, Attributes...>& el) {
+  return el.num_edges();
+}
+//index_mapped_edge_list source CPO
+template <std::unsigned_integral vertex_id, directedness direct, typename... Attributes>
+auto tag_invoke(const source_tag, const index_mapped_edge_list<vertex_id, direct, Attributes...>&,
+                 const typename index_mapped_edge_list<vertex_id, direct, Attributes...>::reference& e) {
+  return std::get<0>(e);
+}
+//index_mapped_edge_list target CPO
+template <std::unsigned_integral vertex_id, directedness direct, typename... Attributes>
+auto tag_invoke(const target_tag, const index_mapped_edge_list<vertex_id, direct, Attributes...>&,
+                 const typename index_mapped_edge_list<vertex_id, direct, Attributes...>::reference& e) {
+  return std::get<1>(e);
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_MAPPED_GRAPH_HPP
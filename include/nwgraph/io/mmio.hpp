@@ -17,12 +17,18 @@
 #define NW_GRAPH_MMIO_HPP
 
 #include <cassert>
+#include <charconv>
+#include <cmath>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fcntl.h>
 #include <future>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -34,6 +40,8 @@
 #include "nwgraph/edge_list.hpp"
 
 #include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
 
 namespace nw {
 namespace graph {
@@ -168,6 +176,195 @@ void mm_fill(std::istream& inputStream, edge_list<directedness::undirected, T>&
   A.close_for_push_back();
 }
 
+/**
+ * Parse one number from [first, last) with std::from_chars, skipping leading blanks and an explicit '+' sign.
+ * Floating-point values that underflow are kept as the denormal or zero they round to.
+ * Returns the position just past the number.
+ */
+template <class T>
+const char* mm_parse(const char* first, const char* last, T& value) {
+  while (first != last && (*first == ' ' || *first == '\t')) {
+    ++first;
+  }
+  if (first != last && *first == '+') {
+    ++first;
+  }
+  auto [ptr, ec] = std::from_chars(first, last, value);
+  if constexpr (std::is_floating_point_v<T>) {
+    // Underflow is reported as out of range with value unset, so take the
+    // denormal or zero that strto* rounds it to, unless it overflowed.  The
+    // magnitude test, unlike isfinite, survives -ffast-math.
+    if (ec == std::errc::result_out_of_range) {
+      std::string token(first, ptr);
+      T           small;
+      if constexpr (std::is_same_v<T, float>) {
+        small = std::strtof(token.c_str(), nullptr);
+      } else if constexpr (std::is_same_v<T, double>) {
+        small = std::strtod(token.c_str(), nullptr);
+      } else {
+        small = std::strtold(token.c_str(), nullptr);
+      }
+      if (std::abs(small) < T(1)) {
+        value = small;
+        return ptr;
+      }
+    }
+  }
+  if (ec != std::errc()) {
+    throw std::runtime_error("Matrix Market parse error near \"" + std::string(first, std::find(first, last, '\n')) + "\"");
+  }
+  return ptr;
+}
+
+/**
+ * Whether the line [first, last) holds an entry, i.e., it is neither blank nor a comment.
+ */
+inline bool mm_is_entry(const char* first, const char* last) {
+  while (first != last && (*first == ' ' || *first == '\t' || *first == '\r')) {
+    ++first;
+  }
+  return first != last && *first != '%';
+}
+
+/**
+ * Visit every entry line in [first, last), which must begin on a line boundary.
+ */
+template <class F>
+void mm_for_each_line(const char* first, const char* last, F&& f) {
+  while (first < last) {
+    auto eol = static_cast<const char*>(std::memchr(first, '\n', last - first));
+    if (eol == nullptr) {
+      eol = last;
+    }
+    if (mm_is_entry(first, eol)) {
+      f(first, eol);
+    }
+    first = eol + 1;
+  }
+}
+
+/**
+ * Fill an edge list from the mmap-ed entries of a Matrix Market file.
+ *
+ * The entries are split into byte ranges at newline boundaries.  A first parallel pass counts the entries in each range,
+ * which gives every range its offset in the edge list, and a second parallel pass parses the indices (and the value, if
+ * the edge list has an attribute) with std::from_chars directly into the columns of the edge list.  If `mirror` is set,
+ * a final pass appends (v, u) for every off-diagonal entry (u, v).
+ *
+ * @param mm The Matrix Market file.
+ * @param A The edge list, which may be unipartite or bipartite and may have zero or one attribute.
+ * @param mirror Whether to add the transpose of every off-diagonal entry (for symmetric files read into directed edge lists).
+ */
+template <std::unsigned_integral vertex_id, typename graph_base_t, directedness direct, typename... Attributes>
+void mm_fill(const mmio::MatrixMarketFile& mm, index_edge_list<vertex_id, graph_base_t, direct, Attributes...>& A, bool mirror) {
+  static_assert(sizeof...(Attributes) <= 1, "Matrix Market entries have at most one value");
+
+  using edge_list_t = index_edge_list<vertex_id, graph_base_t, direct, Attributes...>;
+
+  const std::string_view bytes   = mm.entries();
+  const bool             pattern = mm.isPattern();
+
+  // Split at line boundaries, aiming for a few ranges per thread but not less than a megabyte each
+  const size_t parts = std::max<size_t>(1, std::min<size_t>(4 * tbb::this_task_arena::max_concurrency(), bytes.size() >> 20));
+
+  std::vector<const char*> bounds(parts + 1);
+  bounds[0]     = bytes.data();
+  bounds[parts] = bytes.data() + bytes.size();
+  for (size_t k = 1; k < parts; ++k) {
+    auto p = std::max(bytes.data() + k * (bytes.size() / parts), bounds[k - 1]);
+    while (p != bounds[parts] && p[-1] != '\n') {
+      ++p;
+    }
+    bounds[k] = p;
+  }
+
+  std::vector<size_t> offsets(parts + 1, 0);
+  tbb::parallel_for(tbb::blocked_range(0ul, parts, 1), [&](auto&& r) {
+    for (auto k = r.begin(), e = r.end(); k != e; ++k) {
+      size_t n = 0;
+      mm_for_each_line(bounds[k], bounds[k + 1], [&](auto, auto) { ++n; });
+      offsets[k + 1] = n;
+    }
+  });
+  std::inclusive_scan(offsets.begin(), offsets.end(), offsets.begin());
+
+  const size_t entries = offsets[parts];
+  if (entries != size_t(mm.getNEdges())) {
+    std::cerr << "Warning: Matrix Market header declares " << mm.getNEdges() << " entries but the file has " << entries << std::endl;
+  }
+
+  A.open_for_push_back();
+  A.resize(mirror ? 2 * entries : entries);
+
+  auto& columns = static_cast<typename edge_list_t::base&>(A);
+  auto  src     = std::get<0>(columns).data();
+  auto  dst     = std::get<1>(columns).data();
+
+  std::vector<std::array<size_t, 2>> max_ids(parts, {0, 0});
+  std::vector<size_t>                off_diagonal(parts + 1, 0);
+
+  tbb::parallel_for(tbb::blocked_range(0ul, parts, 1), [&](auto&& r) {
+    for (auto k = r.begin(), e = r.end(); k != e; ++k) {
+      size_t j     = offsets[k];
+      auto&& limit = max_ids[k];
+      mm_for_each_line(bounds[k], bounds[k + 1], [&](const char* first, const char* last) {
+        uint64_t u = 0, v = 0;
+        first      = mm_parse(first, last, u);
+        first      = mm_parse(first, last, v);
+        src[j]     = u - 1;
+        dst[j]     = v - 1;
+        limit[0]   = std::max<size_t>(limit[0], u);
+        limit[1]   = std::max<size_t>(limit[1], v);
+        if (u != v) {
+          ++off_diagonal[k + 1];
+        }
+        if constexpr (sizeof...(Attributes) == 1) {
+          using T = std::tuple_element_t<0, std::tuple<Attributes...>>;
+          T w(1);
+          if (!pattern) {
+            mm_parse(first, last, w);
+          }
+          std::get<2>(columns)[j] = w;
+        }
+        ++j;
+      });
+    }
+  });
+
+  if (mirror) {
+    // off_diagonal[k + 1] counted the off-diagonal entries of range k; scan them into offsets for the transposed entries
+    std::inclusive_scan(off_diagonal.begin(), off_diagonal.end(), off_diagonal.begin());
+    tbb::parallel_for(tbb::blocked_range(0ul, parts, 1), [&](auto&& r) {
+      for (auto k = r.begin(), e = r.end(); k != e; ++k) {
+        size_t j = entries + off_diagonal[k];
+        for (size_t i = offsets[k]; i < offsets[k + 1]; ++i) {
+          if (src[i] != dst[i]) {
+            src[j] = dst[i];
+            dst[j] = src[i];
+            if constexpr (sizeof...(Attributes) == 1) {
+              std::get<2>(columns)[j] = std::get<2>(columns)[i];
+            }
+            ++j;
+          }
+        }
+      }
+    });
+    A.resize(entries + off_diagonal[parts]);
+  }
+
+  std::array<size_t, 2> limit = {0, 0};
+  for (auto&& m : max_ids) {
+    limit[0] = std::max(limit[0], m[0]);
+    limit[1] = std::max(limit[1], m[1]);
+  }
+  if constexpr (is_unipartite<graph_base_t>::value) {
+    A.extend_vertex_cardinality({std::max(limit[0], limit[1]), 0});
+  } else {
+    A.extend_vertex_cardinality(limit);
+  }
+  A.close_for_push_back();
+}
+
 template <directedness sym, typename... Attributes>
 edge_list<sym, Attributes...> read_mm(std::istream& inputStream) {
   std::string              string_input;
@@ -209,49 +406,25 @@ edge_list<sym, Attributes...> read_mm(std::istream& inputStream) {
 
 template <directedness sym, typename... Attributes>
 edge_list<sym, Attributes...> read_mm(const std::string& filename) {
-  std::ifstream inputFile(filename);
+  mmio::MatrixMarketFile mm(filename);
 
-  edge_list<sym, Attributes...> A = read_mm<sym, Attributes...>(inputFile);
+  edge_list<sym, Attributes...> A(mm.getNRows());
+  mm_fill(mm, A, sym == directedness::directed && mm.isSymmetric());
 
   return A;
 }
 
 template <directedness sym, typename... Attributes, edge_list_graph edge_list_t>
 edge_list_t read_mm(const std::string& filename) {
-  std::ifstream            inputStream(filename);
-  std::string              string_input;
-  bool                     file_symmetry = false;
-  std::vector<std::string> header(5);
+  mmio::MatrixMarketFile mm(filename);
 
-  // %%MatrixMarket matrix coordinate integer symmetric
-  std::getline(inputStream, string_input);
-  std::stringstream h(string_input);
-  for (auto& s : header)
-    h >> s;
-
-  if (header[0] != "%%MatrixMarket") {
-    std::cerr << "Unsupported format" << std::endl;
-    throw;
-  }
-  if (header[4] == "symmetric") {
-    file_symmetry = true;
-  } else if (header[4] == "general") {
-    file_symmetry = false;
-  } else {
-    std::cerr << "Bad format (symmetry): " << header[4] << std::endl;
-    throw;
-  }
-
-  while (std::getline(inputStream, string_input)) {
-    if (string_input[0] != '%') break;
-  }
-  size_t n0, n1, nNonzeros;
-  std::stringstream(string_input) >> n0 >> n1 >> nNonzeros;
+  size_t n0 = mm.getNRows(), n1 = mm.getNCols();
+  bool   file_symmetry = mm.isSymmetric();
 
   if (n0 == n1 && is_unipartite<edge_list_t>::value) {
     //unipartite edge list
     //edge_list<sym, Attributes...> A(n0);
-    //mm_fill(inputStream, A, nNonzeros, file_symmetry, (header[3] == "pattern"));
+    //mm_fill(mm, A, file_symmetry);
 
     //return A;
     std::cerr << "Can not populate unipartite graph with symmetric matrix" << std::endl;
@@ -264,7 +437,7 @@ edge_list_t read_mm(const std::string& filename) {
       throw;
     }
     bi_edge_list<sym, Attributes...> A(n0, n1);
-    mm_fill(inputStream, A, nNonzeros, file_symmetry, (header[3] == "pattern"));
+    mm_fill(mm, A, false);
 
     return A;
   }
@@ -422,7 +595,7 @@ void adjacency_stream(std::ofstream& outputStream, adjacency<idx, Attributes...>
   outputStream << "%%MatrixMarket matrix coordinate " << w_type << " " << file_symmetry << "\n%%\n";
 
   outputStream << num_vertices(A) << " " << num_vertices(A) << " "
-               << std::accumulate(A.begin(), A.end(), 0, [&](int a, auto b) { return a + (int)(b.end() - b.begin()); }) << std::endl;
+               << std::accumulate(A.begin(), A.end(), size_t(0), [&](size_t a, auto b) { return a + size_t(b.end() - b.begin()); }) << std::endl;
 
   for (auto first = A.begin(); first != A.end(); ++first) {
     for (auto v = (*first).begin(); v != (*first).end(); ++v) {
@@ -454,7 +627,7 @@ void adjacency_stream(std::ofstream& outputStream, biadjacency<idx, Attributes..
   outputStream << "%%MatrixMarket matrix coordinate " << w_type << " " << file_symmetry << "\n%%\n";
 
   outputStream << num_vertices(A, 0) << " " << num_vertices(A, 1) << " "
-               << std::accumulate(A.begin(), A.end(), 0, [&](int a, auto b) { return a + (int)(b.end() - b.begin()); }) << std::endl;
+               << std::accumulate(A.begin(), A.end(), size_t(0), [&](size_t a, auto b) { return a + size_t(b.end() - b.begin()); }) << std::endl;
 
   for (auto first = A.begin(); first != A.end(); ++first) {
     for (auto v = (*first).begin(); v != (*first).end(); ++v) {
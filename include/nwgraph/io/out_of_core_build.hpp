@@ -0,0 +1,433 @@
+/**
+ * @file out_of_core_build.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_OUT_OF_CORE_BUILD_HPP
+#define NW_GRAPH_OUT_OF_CORE_BUILD_HPP
+
+#include "nwgraph/graph_base.hpp"
+#include "nwgraph/io/MatrixMarketFile.hpp"
+#include "nwgraph/io/mapped_graph.hpp"
+#include "nwgraph/io/mmio.hpp"
+#include "nwgraph/util/defaults.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <execution>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace nw {
+namespace graph {
+
+namespace detail {
+
+/// The output file of a build, closed when the build ends and removed unless the build completed.
+class output_file {
+  int         fd_;
+  std::string path_;
+
+public:
+  explicit output_file(const std::string& path) : fd_(open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644)), path_(path) {
+    if (fd_ < 0) {
+      throw std::runtime_error(path_ + ": open failed: " + strerror(errno));
+    }
+  }
+
+  output_file(const output_file&)            = delete;
+  output_file& operator=(const output_file&) = delete;
+
+  ~output_file() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      discard();
+    }
+  }
+
+  int get() const { return fd_; }
+
+  /// Close the completed file, which then stays.
+  void close() {
+    if (::close(std::exchange(fd_, -1))) {
+      discard();
+      throw std::runtime_error(path_ + ": close failed: " + strerror(errno));
+    }
+  }
+
+private:
+  void discard() const {
+    std::error_code ec;
+    std::filesystem::remove(path_, ec);
+  }
+};
+
+/// The spilled runs of a build, removed when the build ends, whether it completes or throws.
+class scratch_files {
+  std::vector<std::string> paths_;
+
+public:
+  scratch_files() = default;
+
+  scratch_files(const scratch_files&)            = delete;
+  scratch_files& operator=(const scratch_files&) = delete;
+
+  ~scratch_files() {
+    for (auto&& path : paths_) {
+      std::error_code ec;
+      std::filesystem::remove(path, ec);
+    }
+  }
+
+  const std::string& add(std::string path) { return paths_.emplace_back(std::move(path)); }
+};
+
+/// Buffered writer for one block of a file, at a fixed starting offset.
+class block_writer {
+  int               fd_;
+  size_t            offset_;
+  std::vector<char> buffer_;
+
+public:
+  block_writer(int fd, size_t offset, size_t capacity) : fd_(fd), offset_(offset) { buffer_.reserve(capacity); }
+
+  void write(const void* data, size_t bytes) {
+    if (buffer_.size() + bytes > buffer_.capacity()) {
+      flush();
+    }
+    auto p = static_cast<const char*>(data);
+    buffer_.insert(buffer_.end(), p, p + bytes);
+  }
+
+  void flush() {
+    for (size_t i = 0; i < buffer_.size();) {
+      ssize_t n = pwrite(fd_, buffer_.data() + i, buffer_.size() - i, offset_ + i);
+      if (n < 0) {
+        throw std::runtime_error(std::string("pwrite failed: ") + strerror(errno));
+      }
+      i += n;
+    }
+    offset_ += buffer_.size();
+    buffer_.clear();
+  }
+};
+
+/// Buffered sequential reader of fixed-size records from a spilled run.
+class run_reader {
+  std::ifstream     in_;
+  size_t            record_;
+  size_t            left_;
+  std::vector<char> buffer_;
+  size_t            i_ = 0;
+
+public:
+  run_reader(const std::string& path, size_t record, size_t count, size_t capacity)
+      : in_(path, std::ifstream::binary), record_(record), left_(count), buffer_(std::max(record, capacity / record * record)) {
+    if (!in_) {
+      throw std::runtime_error(path + ": could not open run");
+    }
+    fill();
+  }
+
+  bool        empty() const { return i_ == buffer_.size(); }
+  const char* front() const { return buffer_.data() + i_; }
+
+  void pop() {
+    i_ += record_;
+    if (i_ == buffer_.size()) {
+      fill();
+    }
+  }
+
+private:
+  void fill() {
+    size_t records = std::min(left_, buffer_.capacity() / record_);
+    buffer_.resize(records * record_);
+    in_.read(buffer_.data(), buffer_.size());
+    left_ -= records;
+    i_ = 0;
+  }
+};
+
+}    // namespace detail
+
+/**
+ * @brief Build a mapped adjacency from an edge list that need not fit in memory.
+ *
+ * The input is a Matrix Market file or an edge list written by write_mapped.  It is
+ * read in chunks of at most `memory` bytes.  Each chunk is sorted by the idx end point
+ * of its edges and spilled to `scratch` as a run, and the runs are then merged straight
+ * into the target and attribute columns of the output file, which can be opened with
+ * mapped_adjacency<idx, Attributes...>.  Only the runs' read buffers and the vertex
+ * degrees are held in memory during the merge.  If the whole input fits in one chunk
+ * nothing is spilled.
+ *
+ * The result is the adjacency that `adjacency<idx, Attributes...>(read_mm<sym, Attributes...>(input))`
+ * would build: undirected edges appear in the neighborhoods of both end points, symmetric
+ * Matrix Market files read as directed are mirrored, and every neighborhood keeps the
+ * order of the input.
+ *
+ * Matrix Market ids must fit the vertex id type once made zero-based.  If the build
+ * throws, the runs and the partial output are removed.
+ *
+ * @tparam idx Which end point of an edge owns it, 0 or 1.
+ * @tparam sym The directedness to read the input with.
+ * @tparam Attributes The edge attributes (at most one for Matrix Market input).
+ * @param input The Matrix Market or mapped edge list file.
+ * @param output The mapped adjacency file to write.
+ * @param memory Approximate bound, in bytes, on the edges held in memory at once.
+ * @param scratch Directory for the runs, defaults to the system temporary directory.
+ * @throws std::runtime_error If the input cannot be read, an id does not fit, or a file cannot be written.
+ */
+template <int idx, directedness sym = directedness::directed, typename... Attributes>
+requires(std::is_trivially_copyable_v<Attributes>&&...) void out_of_core_build(const std::string& input, const std::string& output,
+                                                                               size_t memory = size_t(1) << 30, std::string scratch = {}) {
+  using index_type = default_index_t;
+  using vertex_id  = default_vertex_id_type;
+
+  constexpr size_t attr_bytes   = (sizeof(Attributes) + ... + 0);
+  constexpr size_t record_bytes = 2 * sizeof(vertex_id) + attr_bytes;
+
+  if (scratch.empty()) {
+    scratch = std::filesystem::temp_directory_path().string();
+  }
+
+  // Each buffered edge costs its record, its sort key and its slot in the sort permutation
+  const size_t capacity = std::max<size_t>(1024, memory / (record_bytes + sizeof(vertex_id) + sizeof(size_t)));
+
+  std::vector<vertex_id>                  keys;
+  std::vector<char>                       records;
+  std::vector<index_type>                 degrees;
+  std::vector<std::pair<std::string, size_t>> runs;
+  detail::scratch_files                       scratch_guard;
+  size_t                                  num_vertices = 0;
+  size_t                                  num_edges    = 0;
+
+  keys.reserve(capacity);
+  records.reserve(capacity * record_bytes);
+
+  // Record layout: key, other end point, attributes
+  auto push = [&](vertex_id u, vertex_id v, const Attributes&... attrs) {
+    vertex_id key = idx == 0 ? u : v, other = idx == 0 ? v : u;
+    size_t    at  = records.size();
+    records.resize(at + record_bytes);
+    char* p = records.data() + at;
+    std::memcpy(p, &key, sizeof(vertex_id));
+    std::memcpy(p + sizeof(vertex_id), &other, sizeof(vertex_id));
+    p += 2 * sizeof(vertex_id);
+    ((std::memcpy(p, &attrs, sizeof(Attributes)), p += sizeof(Attributes)), ...);
+    keys.push_back(key);
+
+    if (key >= degrees.size()) {
+      degrees.resize(std::max<size_t>(size_t(key) + 1, 2 * degrees.size()), 0);
+    }
+    ++degrees[key];
+    num_vertices = std::max<size_t>(num_vertices, size_t(std::max(u, v)) + 1);
+    ++num_edges;
+  };
+
+  // Stable sort of the buffered records by key, returned as a permutation
+  auto sorted = [&] {
+    std::vector<size_t> perm(keys.size());
+    std::iota(perm.begin(), perm.end(), 0);
+    std::stable_sort(std::execution::par_unseq, perm.begin(), perm.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    return perm;
+  };
+
+  auto spill = [&] {
+    if (keys.empty()) {
+      return;
+    }
+    const std::string& path = scratch_guard.add(scratch + "/" + std::filesystem::path(output).filename().string() + ".run" +
+                                                std::to_string(getpid()) + "." + std::to_string(runs.size()));
+    std::ofstream      out(path, std::ofstream::binary);
+    auto          perm = sorted();
+    for (auto i : perm) {
+      out.write(records.data() + i * record_bytes, record_bytes);
+    }
+    if (!out) {
+      throw std::runtime_error(path + ": could not write run");
+    }
+    runs.emplace_back(path, keys.size());
+    keys.clear();
+    records.clear();
+  };
+
+  auto emit = [&](vertex_id u, vertex_id v, const Attributes&... attrs) {
+    if (keys.size() == capacity) {
+      spill();
+    }
+    push(u, v, attrs...);
+  };
+
+  // Read the input, in the same order read_mm and fill would place it: all edges, then their transposes
+  char magic[sizeof(mapped_graph_header::magic_)] = {};
+  std::ifstream(input, std::ifstream::binary).read(magic, sizeof(magic));
+
+  if (std::memcmp(magic, mapped_graph_header::magic_, sizeof(magic)) == 0) {
+    index_mapped_edge_list<vertex_id, sym, Attributes...> el(input);
+    num_vertices = el.num_vertices()[0];
+    for (auto&& e : el) {
+      std::apply(emit, e);
+    }
+    if constexpr (sym == directedness::undirected) {
+      for (auto&& e : el) {
+        std::apply([&](vertex_id u, vertex_id v, const Attributes&... attrs) { emit(v, u, attrs...); }, e);
+      }
+    }
+  } else if constexpr (sizeof...(Attributes) > 1) {
+    throw std::runtime_error(input + ": Matrix Market entries have at most one value");
+  } else {
+    mmio::MatrixMarketFile mm(input);
+    const std::string_view bytes   = mm.entries();
+    const bool             pattern = mm.isPattern();
+    const bool             mirror  = sym == directedness::directed && mm.isSymmetric();
+    num_vertices                   = mm.getNRows();
+
+    auto scan = [&](bool transpose) {
+      mm_for_each_line(bytes.data(), bytes.data() + bytes.size(), [&](const char* first, const char* last) {
+        uint64_t u = 0, v = 0;
+        first      = mm_parse(first, last, u);
+        first      = mm_parse(first, last, v);
+        if (u == 0 || v == 0 || std::max(u, v) - 1 > std::numeric_limits<vertex_id>::max()) {
+          throw std::runtime_error(input + ": vertex id " + std::to_string(u == 0 || v == 0 ? 0 : std::max(u, v)) +
+                                   " is out of range for the vertex id type");
+        }
+        if (transpose && sym == directedness::directed && u == v) {
+          return;
+        }
+        if (transpose) {
+          std::swap(u, v);
+        }
+        if constexpr (sizeof...(Attributes) == 1) {
+          std::tuple_element_t<0, std::tuple<Attributes...>> w(1);
+          if (!pattern) {
+            mm_parse(first, last, w);
+          }
+          emit(u - 1, v - 1, w);
+        } else {
+          emit(u - 1, v - 1);
+        }
+      });
+    };
+    scan(false);
+    if (sym == directedness::undirected || mirror) {
+      scan(true);
+    }
+  }
+
+  // Lay out the output and write the offsets from the degrees
+  degrees.resize(num_vertices, 0);
+  auto h = detail::make_mapped_header(mapped_graph_header::adjacency_kind, idx, 2 + sizeof...(Attributes), num_vertices, num_edges);
+  h.blocks[0] = {0, num_vertices + 1, sizeof(index_type), mapped_graph_header::type_code<index_type>()};
+  h.blocks[1] = {0, num_edges, sizeof(vertex_id), mapped_graph_header::type_code<vertex_id>()};
+  {
+    uint32_t i = 2;
+    ((h.blocks[i++] = {0, num_edges, sizeof(Attributes), mapped_graph_header::type_code<Attributes>()}), ...);
+  }
+  const size_t size = detail::layout_mapped_blocks(h);
+
+  detail::output_file file(output);
+  const int           fd = file.get();
+  if (ftruncate(fd, size)) {
+    throw std::runtime_error(output + ": ftruncate failed: " + strerror(errno));
+  }
+
+  const size_t buffer = std::max<size_t>(1 << 16, memory / (4 + sizeof...(Attributes)));
+  {
+    detail::block_writer header(fd, 0, sizeof(h));
+    header.write(&h, sizeof(h));
+    header.flush();
+
+    detail::block_writer offsets(fd, h.blocks[0].offset, buffer);
+    index_type           offset = 0;
+    offsets.write(&offset, sizeof(offset));
+    for (auto d : degrees) {
+      offset += d;
+      offsets.write(&offset, sizeof(offset));
+    }
+    offsets.flush();
+  }
+  degrees = {};
+
+  // Copy records, which are already in neighborhood order, into the target and attribute columns
+  std::vector<detail::block_writer> columns;
+  for (uint32_t i = 1; i < h.num_blocks; ++i) {
+    columns.emplace_back(fd, h.blocks[i].offset, buffer);
+  }
+  auto write_record = [&](const char* p) {
+    columns[0].write(p + sizeof(vertex_id), sizeof(vertex_id));
+    p += 2 * sizeof(vertex_id);
+    size_t i = 1;
+    ((columns[i++].write(p, sizeof(Attributes)), p += sizeof(Attributes)), ...);
+  };
+
+  if (runs.empty()) {
+    for (auto i : sorted()) {
+      write_record(records.data() + i * record_bytes);
+    }
+  } else {
+    spill();
+    keys    = {};
+    records = {};
+
+    std::vector<detail::run_reader> readers;
+    for (auto&& [path, count] : runs) {
+      readers.emplace_back(path, record_bytes, count, std::max(record_bytes, memory / (2 * runs.size())));
+    }
+
+    // Ties go to the earlier run, which keeps the input order within each neighborhood
+    using entry = std::pair<vertex_id, size_t>;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heads;
+    auto key = [&](size_t r) {
+      vertex_id k;
+      std::memcpy(&k, readers[r].front(), sizeof(vertex_id));
+      return k;
+    };
+    for (size_t r = 0; r < readers.size(); ++r) {
+      if (!readers[r].empty()) {
+        heads.emplace(key(r), r);
+      }
+    }
+    while (!heads.empty()) {
+      size_t r = heads.top().second;
+      heads.pop();
+      write_record(readers[r].front());
+      readers[r].pop();
+      if (!readers[r].empty()) {
+        heads.emplace(key(r), r);
+      }
+    }
+  }
+
+  for (auto&& c : columns) {
+    c.flush();
+  }
+  file.close();
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_OUT_OF_CORE_BUILD_HPP
@@ -0,0 +1,491 @@
+/**
+ * @file reorder.hpp
+ *
+ * Vertex orderings for cache locality.
+ *
+ * Every ordering returns a permutation that lists the old vertex ids in their
+ * new order (perm[new] == old), like perm_by_degree.  relabel(el, perm)
+ * applies it to an edge list and permute_vertices(graph, perm) to an
+ * adjacency.  The orderings that look at neighborhoods expect a symmetric
+ * graph, i.e., an adjacency built from an undirected edge list.  Degree-based
+ * grouping and hub clustering run in parallel; reverse Cuthill-McKee, Gorder
+ * and Rabbit order compute their orders sequentially.
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Kevin Deweese
+ *
+ */
+
+#ifndef NW_GRAPH_REORDER_HPP
+#define NW_GRAPH_REORDER_HPP
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/graph_concepts.hpp"
+#include "nwgraph/graph_traits.hpp"
+#include "nwgraph/util/radix_sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace nw {
+namespace graph {
+
+namespace detail {
+
+template <adjacency_list_graph Graph>
+auto vertex_degrees(const Graph& graph) {
+  std::vector<std::size_t> degrees(num_vertices(graph));
+  tbb::parallel_for(tbb::blocked_range(0ul, degrees.size()), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      degrees[u] = degree(graph, u);
+    }
+  });
+  return degrees;
+}
+
+/// Stable parallel partition of [0, n) into groups, the highest group first.
+template <class Vertex, class Group>
+std::vector<Vertex> order_by_group(std::size_t n, std::size_t groups, Group&& group) {
+  radix_chunks             chunks(n);
+  std::vector<std::size_t> counts(chunks.size() * groups);
+  chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+    for (; i != e; ++i) {
+      ++counts[c * groups + group(i)];
+    }
+  });
+
+  std::size_t offset = 0;
+  for (std::size_t g = groups; g-- != 0;) {
+    for (std::size_t c = 0; c < chunks.size(); ++c) {
+      offset += std::exchange(counts[c * groups + g], offset);
+    }
+  }
+
+  std::vector<Vertex> perm(n);
+  chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+    for (; i != e; ++i) {
+      perm[counts[c * groups + group(i)]++] = i;
+    }
+  });
+  return perm;
+}
+
+/// Bucket priority queue for keys that only ever change by small steps, as
+/// used by Gorder.  Each key has a doubly linked list of its vertices.
+class unit_heap {
+  static constexpr std::size_t nil = std::numeric_limits<std::size_t>::max();
+
+  std::vector<std::size_t> key_, prev_, next_, head_;
+  std::size_t              top_ = 0;
+
+  void unlink(std::size_t v) {
+    (prev_[v] == nil ? head_[key_[v]] : next_[prev_[v]]) = next_[v];
+    if (next_[v] != nil) {
+      prev_[next_[v]] = prev_[v];
+    }
+  }
+
+  void link(std::size_t v) {
+    if (key_[v] == head_.size()) {
+      head_.push_back(nil);
+    }
+    prev_[v] = nil;
+    next_[v] = head_[key_[v]];
+    if (next_[v] != nil) {
+      prev_[next_[v]] = v;
+    }
+    head_[key_[v]] = v;
+    top_           = std::max(top_, key_[v]);
+  }
+
+public:
+  /// All vertices start with key 0; ties pop in increasing vertex order.
+  explicit unit_heap(std::size_t n) : key_(n), prev_(n), next_(n), head_(1, nil) {
+    for (std::size_t v = n; v-- != 0;) {
+      link(v);
+    }
+  }
+
+  void increment(std::size_t v) {
+    unlink(v);
+    ++key_[v];
+    link(v);
+  }
+
+  void decrement(std::size_t v) {
+    unlink(v);
+    --key_[v];
+    link(v);
+  }
+
+  void erase(std::size_t v) { unlink(v); }
+
+  /// Remove and return a vertex with the largest key (the heap must not be empty).
+  std::size_t pop() {
+    while (head_[top_] == nil) {
+      --top_;
+    }
+    std::size_t v = head_[top_];
+    unlink(v);
+    return v;
+  }
+};
+
+}    // namespace detail
+
+/**
+ * @brief Reverse Cuthill-McKee ordering.
+ *
+ * Each connected component is searched breadth first from a pseudo-peripheral
+ * vertex, visiting the neighbors of a vertex in increasing degree order, and
+ * the resulting order is reversed.  This keeps the neighbors of a vertex
+ * close to it, i.e., it reduces the bandwidth of the adjacency matrix.  The
+ * searches are sequential, since each level is ordered by its parents.
+ *
+ * @tparam Graph adjacency_list_graph type of a symmetric graph.
+ * @param graph The graph.
+ * @return The permutation, perm[new] == old.
+ */
+template <adjacency_list_graph Graph>
+auto rcm(const Graph& graph) {
+  using vertex_id_type = vertex_id_t<Graph>;
+
+  const std::size_t           n       = num_vertices(graph);
+  auto                        degrees = detail::vertex_degrees(graph);
+  std::vector<vertex_id_type> perm;
+  perm.reserve(n);
+  std::vector<bool> visited(n);
+
+  // Breadth first search from root, appending to perm, and return the vertex of
+  // minimum degree in the last level along with the number of levels.  Unless
+  // kept, the search is undone.
+  auto search = [&](vertex_id_type root, bool keep) {
+    std::size_t first = perm.size();
+    perm.push_back(root);
+    visited[root]           = true;
+    std::size_t level_begin = first, level_end = first + 1, depth = 1;
+    for (std::size_t i = first; i < perm.size(); ++i) {
+      if (i == level_end) {
+        level_begin = std::exchange(level_end, perm.size());
+        ++depth;
+      }
+      std::size_t begin = perm.size();
+      for (auto&& e : graph[perm[i]]) {
+        if (auto v = target(graph, e); !visited[v]) {
+          visited[v] = true;
+          perm.push_back(v);
+        }
+      }
+      std::stable_sort(perm.begin() + begin, perm.end(), [&](auto a, auto b) { return degrees[a] < degrees[b]; });
+    }
+    vertex_id_type far = *std::min_element(perm.begin() + level_begin, perm.end(), [&](auto a, auto b) { return degrees[a] < degrees[b]; });
+    if (!keep) {
+      for (std::size_t i = first; i < perm.size(); ++i) {
+        visited[perm[i]] = false;
+      }
+      perm.resize(first);
+    }
+    return std::tuple(far, depth);
+  };
+
+  for (std::size_t u = 0; u < n; ++u) {
+    if (visited[u]) {
+      continue;
+    }
+
+    // Move the root to the far end of the component while its eccentricity grows.
+    vertex_id_type root = u;
+    auto [far, depth]   = search(root, false);
+    for (auto [next, d] = search(far, false); d > depth; std::tie(next, d) = search(far, false)) {
+      root  = std::exchange(far, next);
+      depth = d;
+    }
+    search(root, true);
+  }
+
+  std::reverse(perm.begin(), perm.end());
+  return perm;
+}
+
+/**
+ * @brief Degree-based grouping (DBG).
+ *
+ * Vertices are grouped by degree on a logarithmic scale around the average
+ * degree, hot (high degree) groups first, and keep their original relative
+ * order within a group.  This packs the frequently accessed vertices together
+ * without destroying the locality already present in the input order.
+ *
+ * @tparam Graph adjacency_list_graph type.
+ * @param graph The graph.
+ * @param num_groups The number of degree groups.
+ * @return The permutation, perm[new] == old.
+ */
+template <adjacency_list_graph Graph>
+auto degree_based_grouping(const Graph& graph, std::size_t num_groups = 8) {
+  auto        degrees = detail::vertex_degrees(graph);
+  std::size_t n       = degrees.size();
+  double      average = n ? std::accumulate(degrees.begin(), degrees.end(), 0.0) / n : 0.0;
+
+  // Group 0 is [0, average / 2), and group g doubles the bounds of group g - 1.
+  return detail::order_by_group<vertex_id_t<Graph>>(n, num_groups, [&](std::size_t u) -> std::size_t {
+    if (2 * degrees[u] < average) {
+      return 0;
+    }
+    return std::min<std::size_t>(num_groups - 1, 1 + std::floor(std::log2(2 * degrees[u] / average)));
+  });
+}
+
+/**
+ * @brief Hub clustering.
+ *
+ * The vertices with more than the average degree (the hubs) come first, then
+ * all others, each in their original relative order.
+ *
+ * @tparam Graph adjacency_list_graph type.
+ * @param graph The graph.
+ * @return The permutation, perm[new] == old.
+ */
+template <adjacency_list_graph Graph>
+auto hub_cluster(const Graph& graph) {
+  auto        degrees = detail::vertex_degrees(graph);
+  std::size_t n       = degrees.size();
+  double      average = n ? std::accumulate(degrees.begin(), degrees.end(), 0.0) / n : 0.0;
+  return detail::order_by_group<vertex_id_t<Graph>>(n, 2, [&](std::size_t u) -> std::size_t { return degrees[u] > average; });
+}
+
+/**
+ * @brief Gorder (Wei et al., SIGMOD'16).
+ *
+ * Greedily appends the vertex with the highest score against the last
+ * `window` placed vertices, where the score counts the edges to the window
+ * vertices and the neighbors shared with them.  Scores are kept in a unit
+ * heap; shared neighbors are not counted through vertices whose degree exceeds
+ * sqrt(n), which bounds the cost of an update.  The greedy placement is
+ * sequential.
+ *
+ * @tparam Graph adjacency_list_graph type of a symmetric graph.
+ * @param graph The graph.
+ * @param window The size of the window.
+ * @return The permutation, perm[new] == old.
+ */
+template <adjacency_list_graph Graph>
+auto gorder(const Graph& graph, std::size_t window = 5) {
+  using vertex_id_type = vertex_id_t<Graph>;
+
+  const std::size_t n = num_vertices(graph);
+  if (n == 0) {
+    return std::vector<vertex_id_type>{};
+  }
+  auto              degrees = detail::vertex_degrees(graph);
+  const std::size_t hub     = std::sqrt(n);
+
+  std::vector<vertex_id_type> perm;
+  perm.reserve(n);
+  std::vector<bool> placed(n);
+  detail::unit_heap heap(n);
+
+  auto update = [&](vertex_id_type x, auto&& change) {
+    for (auto&& e : graph[x]) {
+      auto u = target(graph, e);
+      if (!placed[u]) {
+        change(u);
+      }
+      if (degrees[u] <= hub) {
+        for (auto&& f : graph[u]) {
+          if (auto w = target(graph, f); w != x && !placed[w]) {
+            change(w);
+          }
+        }
+      }
+    }
+  };
+
+  vertex_id_type first = std::max_element(degrees.begin(), degrees.end()) - degrees.begin();
+  heap.erase(first);
+  for (std::size_t i = 0; i < n; ++i) {
+    vertex_id_type v = i == 0 ? first : heap.pop();
+    perm.push_back(v);
+    placed[v] = true;
+    update(v, [&](auto u) { heap.increment(u); });
+    if (i >= window) {
+      update(perm[i - window], [&](auto u) { heap.decrement(u); });
+    }
+  }
+  return perm;
+}
+
+/**
+ * @brief Rabbit order (Arai et al., IPDPS'16).
+ *
+ * Vertices are visited in increasing degree order, and each one is merged into
+ * the neighboring community that gives the largest positive modularity gain,
+ * aggregating its edges into that community.  A depth-first walk of the
+ * resulting dendrogram numbers the members of every community consecutively.
+ * This is the sequential form of the algorithm; the merges are not done
+ * concurrently.
+ *
+ * @tparam Graph adjacency_list_graph type of a symmetric graph.
+ * @param graph The graph.
+ * @return The permutation, perm[new] == old.
+ */
+template <adjacency_list_graph Graph>
+auto rabbit_order(const Graph& graph) {
+  using vertex_id_type = vertex_id_t<Graph>;
+
+  const std::size_t n       = num_vertices(graph);
+  auto              degrees = detail::vertex_degrees(graph);
+  const double      m2      = std::accumulate(degrees.begin(), degrees.end(), 0.0);    // twice the edges
+
+  std::vector<std::vector<std::pair<vertex_id_type, double>>> edges(n);
+  std::vector<double>                                         strength(n);
+  tbb::parallel_for(tbb::blocked_range(0ul, n), [&](auto&& r) {
+    for (auto u = r.begin(), e = r.end(); u != e; ++u) {
+      for (auto&& x : graph[u]) {
+        edges[u].emplace_back(target(graph, x), 1.0);
+      }
+      strength[u] = degrees[u];
+    }
+  });
+
+  std::vector<vertex_id_type> dest(n);
+  std::iota(dest.begin(), dest.end(), 0);
+  auto find = [&](vertex_id_type x) {
+    while (dest[x] != x) {
+      x = dest[x] = dest[dest[x]];
+    }
+    return x;
+  };
+
+  std::vector<vertex_id_type> visit(n);
+  std::iota(visit.begin(), visit.end(), 0);
+  std::stable_sort(visit.begin(), visit.end(), [&](auto a, auto b) { return degrees[a] < degrees[b]; });
+
+  std::vector<std::vector<vertex_id_type>> children(n);
+  std::vector<vertex_id_type>              roots;
+  std::vector<double>                      weight(n);
+  std::vector<vertex_id_type>              touched;
+
+  for (auto u : visit) {
+    // Aggregate the edges of u by the community at their other end.
+    for (auto&& [x, w] : edges[u]) {
+      if (auto c = find(x); c != u) {
+        if (weight[c] == 0) {
+          touched.push_back(c);
+        }
+        weight[c] += w;
+      }
+    }
+
+    vertex_id_type best = u;
+    double         gain = 0;
+    edges[u].clear();
+    for (auto c : touched) {
+      edges[u].emplace_back(c, weight[c]);
+      if (double dq = 2 * (weight[c] / m2 - strength[u] * strength[c] / (m2 * m2)); dq > gain) {
+        gain = dq;
+        best = c;
+      }
+      weight[c] = 0;
+    }
+    touched.clear();
+
+    if (best == u) {
+      roots.push_back(u);
+      continue;
+    }
+    dest[u] = best;
+    strength[best] += strength[u];
+    edges[best].insert(edges[best].end(), edges[u].begin(), edges[u].end());
+    std::vector<std::pair<vertex_id_type, double>>().swap(edges[u]);
+    children[best].push_back(u);
+  }
+
+  std::vector<vertex_id_type> perm;
+  perm.reserve(n);
+  std::vector<vertex_id_type> stack;
+  for (auto root : roots) {
+    for (stack.push_back(root); !stack.empty();) {
+      auto v = stack.back();
+      stack.pop_back();
+      perm.push_back(v);
+      stack.insert(stack.end(), children[v].rbegin(), children[v].rend());
+    }
+  }
+  return perm;
+}
+
+/**
+ * @brief Apply a vertex permutation to an adjacency.
+ *
+ * Both the rows and the neighbor ids are renumbered, and every row is sorted
+ * by its new neighbor ids, carrying the edge attributes along.  The rows are
+ * copied in parallel.
+ *
+ * @param graph The adjacency.
+ * @param perm The permutation, perm[new] == old.
+ * @return The permuted adjacency.
+ */
+template <int idx, std::unsigned_integral index_type, std::unsigned_integral vertex_id, class... Attributes, class Perm>
+auto permute_vertices(const index_adjacency<idx, index_type, vertex_id, Attributes...>& graph, const Perm& perm) {
+  const std::size_t      n = perm.size();
+  std::vector<vertex_id> iperm(n);
+  tbb::parallel_for(tbb::blocked_range(0ul, n), [&](auto&& r) {
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      iperm[perm[i]] = i;
+    }
+  });
+
+  auto&&                  old_indices = graph.indices_;
+  std::vector<index_type> indices(n + 1);
+  tbb::parallel_for(tbb::blocked_range(0ul, n), [&](auto&& r) {
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      indices[i + 1] = old_indices[perm[i] + 1] - old_indices[perm[i]];
+    }
+  });
+  std::inclusive_scan(indices.begin(), indices.end(), indices.begin());
+
+  auto&& old_columns = static_cast<const typename struct_of_arrays<vertex_id, Attributes...>::base&>(graph.to_be_indexed_);
+  std::tuple<std::vector<vertex_id>, std::vector<Attributes>...> columns(std::vector<vertex_id>(indices.back()),
+                                                                         std::vector<Attributes>(indices.back())...);
+
+  tbb::parallel_for(tbb::blocked_range(0ul, n), [&](auto&& r) {
+    std::vector<index_type> order;
+    for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+      index_type begin = old_indices[perm[i]], end = old_indices[perm[i] + 1];
+      order.resize(end - begin);
+      std::iota(order.begin(), order.end(), begin);
+      auto&& targets = std::get<0>(old_columns);
+      std::sort(order.begin(), order.end(), [&](auto a, auto b) { return iperm[targets[a]] < iperm[targets[b]]; });
+
+      [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+        for (std::size_t j = 0; j < order.size(); ++j) {
+          std::get<0>(columns)[indices[i] + j] = iperm[targets[order[j]]];
+          ((std::get<Is + 1>(columns)[indices[i] + j] = std::get<Is + 1>(old_columns)[order[j]]), ...);
+        }
+      }(std::index_sequence_for<Attributes...>());
+    }
+  });
+
+  return index_adjacency<idx, index_type, vertex_id, Attributes...>(std::move(indices), std::move(columns));
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_REORDER_HPP
@@ -130,10 +130,13 @@ constexpr void relaxed(T&& t, U&& u) {
 /// @returns            The value of the variable prior to the add operation.
 template <std::memory_order order = std::memory_order_acq_rel, class T, class U>
 constexpr auto fetch_add(T&& t, U&& u) {
+  // The failed CAS of a floating point add may not be stronger than its success.
+  constexpr auto failure =
+      order == std::memory_order_relaxed || order == std::memory_order_release ? std::memory_order_relaxed : std::memory_order_acquire;
   if constexpr (is_atomic_v<std::decay_t<T>>) {
     if constexpr (std::is_floating_point_v<remove_atomic_t<std::decay_t<T>>>) {
       auto&& e = acquire(t);
-      while (!cas<order>(std::forward<T>(t), e, e + u))
+      while (!cas<order, failure>(std::forward<T>(t), e, e + u))
         ;
       return e;
     } else {
@@ -143,7 +146,7 @@ constexpr auto fetch_add(T&& t, U&& u) {
     /// fallback to compiler atomics here... C++20 has atomic_ref.
     if constexpr (std::is_floating_point_v<std::decay_t<T>>) {
       auto e = acquire(std::forward<T>(t));
-      for (auto f = e + u; !cas<order>(std::forward<T>(t), e, f); f = e + u)
+      for (auto f = e + u; !cas<order, failure>(std::forward<T>(t), e, f); f = e + u)
         ;
       return e;
     } else {
@@ -0,0 +1,146 @@
+/**
+ * @file d_ary_heap.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_D_ARY_HEAP_HPP
+#define NW_GRAPH_D_ARY_HEAP_HPP
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace nw {
+namespace graph {
+
+/// An indexed d-ary min-heap with decrease-key.
+///
+/// Holds at most one entry per index in [0, n), e.g., per vertex, and keeps
+/// the position of every index in the heap, so a key is lowered in place
+/// instead of pushing a duplicate.  With d = 4 the children of an entry share
+/// a cache line, and the heap is half as deep as a binary heap.  Indices that
+/// are popped forget their position, so clear() only visits the entries still
+/// in the heap.
+///
+/// @tparam Key   The key type, e.g., a floating point distance.
+/// @tparam Index The index type.
+/// @tparam D     The arity.
+template <class Key, std::unsigned_integral Index, std::size_t D = 4>
+class indexed_d_ary_heap {
+  static_assert(D >= 2);
+
+  using entry = std::pair<Key, Index>;
+
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::vector<entry>       heap_;
+  std::vector<std::size_t> position_;
+
+  void place(std::size_t i, const entry& e) {
+    heap_[i]            = e;
+    position_[e.second] = i;
+  }
+
+  void sift_up(std::size_t i) {
+    entry e = heap_[i];
+    while (i > 0) {
+      std::size_t parent = (i - 1) / D;
+      if (!(e.first < heap_[parent].first)) {
+        break;
+      }
+      place(i, heap_[parent]);
+      i = parent;
+    }
+    place(i, e);
+  }
+
+  void sift_down(std::size_t i) {
+    entry             e = heap_[i];
+    const std::size_t n = heap_.size();
+    while (true) {
+      std::size_t first = D * i + 1;
+      if (first >= n) {
+        break;
+      }
+      std::size_t best = first;
+      for (std::size_t c = first + 1, ce = std::min(first + D, n); c < ce; ++c) {
+        if (heap_[c].first < heap_[best].first) {
+          best = c;
+        }
+      }
+      if (!(heap_[best].first < e.first)) {
+        break;
+      }
+      place(i, heap_[best]);
+      i = best;
+    }
+    place(i, e);
+  }
+
+public:
+  using value_type = entry;
+  using size_type  = std::size_t;
+
+  /// A heap for indices in [0, n).
+  explicit indexed_d_ary_heap(std::size_t n = 0) : position_(n, npos) {}
+
+  bool        empty() const { return heap_.empty(); }
+  std::size_t size() const { return heap_.size(); }
+  bool        contains(Index index) const { return position_[index] != npos; }
+
+  /// Insert index with key, or lower its key if it is already in the heap and key is smaller.
+  void push(Key key, Index index) {
+    if (std::size_t i = position_[index]; i != npos) {
+      if (key < heap_[i].first) {
+        heap_[i].first = key;
+        sift_up(i);
+      }
+      return;
+    }
+    heap_.emplace_back(key, index);
+    sift_up(heap_.size() - 1);
+  }
+
+  /// The entry with the smallest key.
+  const entry& top() const {
+    assert(!empty());
+    return heap_.front();
+  }
+
+  void pop() {
+    assert(!empty());
+    position_[heap_.front().second] = npos;
+    if (heap_.size() > 1) {
+      heap_.front() = heap_.back();
+      heap_.pop_back();
+      sift_down(0);
+    } else {
+      heap_.pop_back();
+    }
+  }
+
+  /// Remove every entry, in time proportional to the entries left.
+  void clear() {
+    for (auto&& e : heap_) {
+      position_[e.second] = npos;
+    }
+    heap_.clear();
+  }
+};
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_D_ARY_HEAP_HPP
@@ -21,7 +21,14 @@ namespace nw {
 namespace graph {
 
 using default_vertex_id_type = uint32_t;
-using default_index_t        = uint32_t;
+
+// Offsets into the edge arrays of compressed structures.  Define NWGRAPH_64BIT_INDEX
+// (cmake -DNWGRAPH_64BIT_INDEX=ON) for graphs with 2^32 or more edges; vertex ids stay 32 bits.
+#if defined(NWGRAPH_64BIT_INDEX)
+using default_index_t = uint64_t;
+#else
+using default_index_t = uint32_t;
+#endif
 
  }
 }
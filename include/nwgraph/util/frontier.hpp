@@ -0,0 +1,224 @@
+/**
+ * @file frontier.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_FRONTIER_HPP
+#define NW_GRAPH_FRONTIER_HPP
+
+#include "nwgraph/util/AtomicBitVector.hpp"
+#include "nwgraph/util/atomic.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace nw {
+namespace graph {
+
+/// Preallocated frontier queue.
+///
+/// The queue holds a window [begin, end) that is the frontier currently being
+/// processed, while the next frontier is appended behind it.  `slide_window`
+/// makes the appended entries the current window.  Nothing is ever moved or
+/// freed, so every earlier window is still available through `window(i)`,
+/// which is what algorithms that walk the levels backwards (like BC) need.
+///
+/// Appends come either from `push_back` in sequential code, or from
+/// `queue_buffer`s filled concurrently.  The capacity must bound the total
+/// number of entries ever appended, e.g., the number of vertices for a search
+/// that visits each vertex once.
+template <class T>
+class sliding_queue {
+  std::vector<T>           data_;
+  std::size_t              in_ = 0;
+  std::vector<std::size_t> windows_ = {0};    // start of each window, plus the end of the current one
+
+public:
+  using value_type = T;
+  using iterator   = typename std::vector<T>::iterator;
+
+  explicit sliding_queue(std::size_t capacity) : data_(capacity) {}
+
+  /// Append a value to the next window (not thread safe).
+  void push_back(T value) {
+    assert(in_ < data_.size());
+    data_[in_++] = value;
+  }
+
+  /// Atomically reserve n slots in the next window, returning the first one.
+  std::size_t reserve(std::size_t n) {
+    std::size_t i = nw::graph::fetch_add(in_, n);
+    assert(i + n <= data_.size());
+    return i;
+  }
+
+  T* data() { return data_.data(); }
+
+  /// Make the entries appended since the last slide the current window.
+  void slide_window() { windows_.push_back(in_); }
+
+  /// Forget all windows.
+  void reset() {
+    in_      = 0;
+    windows_ = {0};
+  }
+
+  iterator    begin() { return data_.begin() + windows_[windows_.size() - 2 + (windows_.size() == 1)]; }
+  iterator    end() { return data_.begin() + windows_.back(); }
+  std::size_t size() const { return windows_.size() == 1 ? 0 : windows_.back() - windows_[windows_.size() - 2]; }
+  bool        empty() const { return size() == 0; }
+
+  /// The number of windows made current so far, including the current one.
+  std::size_t num_windows() const { return windows_.size() - 1; }
+
+  /// The entries of the i-th window.
+  std::span<const T> window(std::size_t i) const { return {data_.data() + windows_[i], windows_[i + 1] - windows_[i]}; }
+
+  /// Drain a collection of queue_buffers into the next window.
+  ///
+  /// The buffer sizes are scanned into offsets, so every buffer copies its
+  /// contents into its own slots in parallel without touching the shared
+  /// append cursor.
+  template <class Buffers>
+  void flush(Buffers&& buffers) {
+    std::vector<typename std::decay_t<Buffers>::value_type*> bs;
+    for (auto&& b : buffers) {
+      bs.push_back(&b);
+    }
+    std::vector<std::size_t> offsets(bs.size() + 1, in_);
+    for (std::size_t i = 0; i < bs.size(); ++i) {
+      offsets[i + 1] = offsets[i] + bs[i]->size();
+    }
+    assert(offsets.back() <= data_.size());
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, bs.size(), 1), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        std::copy(bs[i]->begin(), bs[i]->end(), data_.begin() + offsets[i]);
+        bs[i]->clear();
+      }
+    });
+    in_ = offsets.back();
+  }
+};
+
+/// Fixed-capacity per-thread buffer in front of a sliding_queue.
+///
+/// Pushes go to the local buffer.  A full buffer reserves a block of the queue
+/// with a single atomic and copies itself there; whatever is left at the end of
+/// a step is drained with sliding_queue::flush.  Use one buffer per thread,
+/// e.g., through `frontier_buffers`.
+template <class T, std::size_t Capacity = 16384>
+class queue_buffer {
+  sliding_queue<T>*    queue_;
+  std::unique_ptr<T[]> local_;
+  std::size_t          size_ = 0;
+
+public:
+  explicit queue_buffer(sliding_queue<T>& queue) : queue_(&queue), local_(new T[Capacity]) {}
+
+  queue_buffer(const queue_buffer& b) : queue_(b.queue_), local_(new T[Capacity]), size_(b.size_) {
+    std::copy(b.begin(), b.end(), local_.get());
+  }
+  queue_buffer(queue_buffer&&) = default;
+
+  void push_back(T value) {
+    if (size_ == Capacity) {
+      flush();
+    }
+    local_[size_++] = value;
+  }
+
+  /// Move the buffered entries into the queue.
+  void flush() {
+    std::size_t i = queue_->reserve(size_);
+    std::copy(begin(), end(), queue_->data() + i);
+    size_ = 0;
+  }
+
+  const T*    begin() const { return local_.get(); }
+  const T*    end() const { return local_.get() + size_; }
+  std::size_t size() const { return size_; }
+  void        clear() { size_ = 0; }
+};
+
+/// Thread-local queue_buffers for a sliding_queue.
+template <class T, std::size_t Capacity = 16384>
+using frontier_buffers = tbb::enumerable_thread_specific<queue_buffer<T, Capacity>>;
+
+template <class T>
+auto make_frontier_buffers(sliding_queue<T>& queue) {
+  return frontier_buffers<T>([&queue] { return queue_buffer<T>(queue); });
+}
+
+/// Set the bits of the entries of the current window in a dense bitmap.
+template <class T, class Word>
+void queue_to_bitmap(sliding_queue<T>& queue, AtomicBitVector<Word>& bitmap) {
+  tbb::parallel_for(tbb::blocked_range(queue.begin(), queue.end()), [&](auto&& r) {
+    for (auto&& u : r) {
+      bitmap.atomic_set(u);
+    }
+  });
+}
+
+/// Append the set bits of a dense bitmap to the next window, in increasing order
+/// within each thread's share of the bitmap.
+template <class T, class Word>
+void bitmap_to_queue(AtomicBitVector<Word>& bitmap, sliding_queue<T>& queue) {
+  auto buffers = make_frontier_buffers(queue);
+  tbb::parallel_for(bitmap.non_zeros(std::size_t(1) << 12), [&](auto&& range) {
+    auto&& local = buffers.local();
+    for (auto&& i = range.begin(), e = range.end(); i != e; ++i) {
+      local.push_back(*i);
+    }
+  });
+  queue.flush(buffers);
+}
+
+/// Per-level record of a frontier-based traversal.
+struct frontier_level {
+  std::size_t frontier;     //!< entries in the frontier the level expanded
+  bool        bottom_up;    //!< whether the level was a bottom-up (pull) step
+  double      seconds;      //!< time taken by the level
+};
+
+/// Appends a frontier_level to an optional trace for the lifetime of a step.
+class frontier_level_timer {
+  std::vector<frontier_level>*                   trace_;
+  frontier_level                                 level_;
+  std::chrono::high_resolution_clock::time_point start_;
+
+public:
+  frontier_level_timer(std::vector<frontier_level>* trace, std::size_t frontier, bool bottom_up)
+      : trace_(trace), level_{frontier, bottom_up, 0.0}, start_(trace ? std::chrono::high_resolution_clock::now() : decltype(start_){}) {}
+
+  ~frontier_level_timer() {
+    if (trace_) {
+      std::chrono::duration<double> d = std::chrono::high_resolution_clock::now() - start_;
+      level_.seconds                  = d.count();
+      trace_->push_back(level_);
+    }
+  }
+};
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_FRONTIER_HPP
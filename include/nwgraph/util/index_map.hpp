@@ -0,0 +1,234 @@
+/**
+ * @file index_map.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_INDEX_MAP_HPP
+#define NW_GRAPH_INDEX_MAP_HPP
+
+#include "nwgraph/util/atomic.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+namespace nw {
+namespace graph {
+
+/// Arena storage for strings.
+///
+/// Every thread copies the strings it interns into its own list of large
+/// blocks, so interning never contends and a million keys cost a handful of
+/// allocations instead of a million.  The views stay valid for the lifetime of
+/// the pool.
+class string_pool {
+  struct arena {
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t                          used     = 0;
+    std::size_t                          capacity = 0;
+  };
+
+  std::size_t                            block_size_;
+  tbb::enumerable_thread_specific<arena> arenas_;
+
+public:
+  explicit string_pool(std::size_t block_size = std::size_t(1) << 20) : block_size_(block_size) {}
+
+  string_pool(const string_pool&)            = delete;
+  string_pool& operator=(const string_pool&) = delete;
+
+  /// Copy a string into the pool (thread safe).
+  std::string_view intern(std::string_view s) {
+    arena& a = arenas_.local();
+    if (a.used + s.size() > a.capacity) {
+      a.capacity = std::max(block_size_, s.size());
+      a.blocks.emplace_back(new char[a.capacity]);
+      a.used = 0;
+    }
+    char* p = a.blocks.back().get() + a.used;
+    std::memcpy(p, s.data(), s.size());
+    a.used += s.size();
+    return {p, s.size()};
+  }
+};
+
+/// Whether keys of type Key are stored as views into a string_pool.
+template <class Key>
+concept string_key = std::convertible_to<const Key&, std::string_view>;
+
+/// Whether keys of type Key can be stored in a concurrent_index_map, i.e.,
+/// whether std::hash is defined for the stored key type.
+template <class Key>
+concept hashable_key = string_key<Key> || requires(const Key& key) {
+  { std::hash<Key>{}(key) } -> std::convertible_to<std::size_t>;
+};
+
+/// Fixed-capacity concurrent open-addressing map from keys to indices.
+///
+/// This is the dictionary the data-to-graph builders use to turn vertex keys
+/// (strings or integers) into vertex indices.  Keys are inserted concurrently
+/// with linear probing: a thread claims an empty slot with a CAS, publishes the
+/// key, and then marks it full, while threads probing past a slot being filled
+/// wait for it.  A key inserted more than once keeps its largest index, which
+/// matches assigning range[i] = i in order.  String keys live in a string_pool
+/// owned by the map.
+///
+/// The capacity is fixed at construction to twice the expected number of keys
+/// (rounded up to a power of two); inserting more keys than slots throws.
+///
+/// @tparam Key   The key type, which std::hash must support; strings are stored as std::string_view.
+/// @tparam Index The index type.
+template <hashable_key Key, std::unsigned_integral Index = std::size_t>
+class concurrent_index_map {
+public:
+  using key_type   = std::conditional_t<string_key<Key>, std::string_view, Key>;
+  using index_type = Index;
+
+  static constexpr Index npos = std::numeric_limits<Index>::max();
+
+private:
+  enum : std::uint8_t { empty, busy, full };
+
+  std::size_t                  mask_;
+  std::vector<std::uint8_t>    state_;
+  std::vector<key_type>        keys_;
+  std::vector<Index>           values_;
+  std::size_t                  size_ = 0;
+  std::unique_ptr<string_pool> pool_;
+
+  std::size_t hash(const key_type& key) const {
+    // splitmix64 finalizer, as std::hash is the identity for integers
+    std::uint64_t h = std::hash<key_type>{}(key);
+    h               = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h               = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+  }
+
+  /// Wait for a slot that is being filled and return its final state.
+  std::uint8_t settled(std::size_t s) const {
+    std::uint8_t st;
+    while ((st = nw::graph::load<std::memory_order_acquire>(const_cast<std::uint8_t&>(state_[s]))) == busy) {
+    }
+    return st;
+  }
+
+public:
+  explicit concurrent_index_map(std::size_t expected)
+      : mask_(std::bit_ceil(std::max<std::size_t>(16, 2 * expected)) - 1)
+      , state_(mask_ + 1, empty)
+      , keys_(mask_ + 1)
+      , values_(mask_ + 1)
+      , pool_(string_key<Key> ? std::make_unique<string_pool>() : nullptr) {}
+
+  /// Map key to index, or raise the index of a key already present (thread safe).
+  void insert(const key_type& key, Index index) {
+    for (std::size_t s = hash(key) & mask_, probes = 0; probes <= mask_; s = (s + 1) & mask_, ++probes) {
+      std::uint8_t st = empty;
+      if (nw::graph::cas(state_[s], st, std::uint8_t(busy))) {
+        if constexpr (string_key<Key>) {
+          keys_[s] = pool_->intern(key);
+        } else {
+          keys_[s] = key;
+        }
+        values_[s] = index;
+        nw::graph::store<std::memory_order_release>(state_[s], std::uint8_t(full));
+        nw::graph::fetch_add(size_, std::size_t(1));
+        return;
+      }
+      if (st == busy) {
+        settled(s);
+      }
+      if (keys_[s] == key) {
+        for (Index v = nw::graph::load<std::memory_order_relaxed>(values_[s]); v < index && !nw::graph::cas(values_[s], v, index);) {
+        }
+        return;
+      }
+    }
+    throw std::length_error("concurrent_index_map is full");
+  }
+
+  /// Insert range[i] -> i for every element of a range, in parallel.
+  template <std::ranges::random_access_range R>
+  void insert_indices(const R& range) {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, std::ranges::size(range)), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        insert(range[i], i);
+      }
+    });
+  }
+
+  /// The index of a key, or npos.
+  Index find(const key_type& key) const {
+    for (std::size_t s = hash(key) & mask_, probes = 0; probes <= mask_; s = (s + 1) & mask_, ++probes) {
+      if (settled(s) == empty) {
+        return npos;
+      }
+      if (keys_[s] == key) {
+        return nw::graph::load<std::memory_order_relaxed>(const_cast<Index&>(values_[s]));
+      }
+    }
+    return npos;
+  }
+
+  /// The index of a key that is present.
+  /// @throws std::out_of_range if the key is not in the map.
+  Index at(const key_type& key) const {
+    if (Index index = find(key); index != npos) {
+      return index;
+    }
+    throw std::out_of_range("key not in concurrent_index_map");
+  }
+
+  /// The index of a key that is present, as at().
+  Index operator[](const key_type& key) const { return at(key); }
+
+  /// Look up keys[i] into out[i] for every element of a range, in parallel.
+  template <std::ranges::random_access_range R, std::ranges::random_access_range Out>
+  void find_all(const R& keys, Out&& out) const {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, std::ranges::size(keys)), [&](auto&& r) {
+      for (auto i = r.begin(), e = r.end(); i != e; ++i) {
+        out[i] = find(keys[i]);
+      }
+    });
+  }
+
+  bool contains(const key_type& key) const { return find(key) != npos; }
+
+  /// The number of distinct keys.
+  std::size_t size() const { return size_; }
+};
+
+template <class>
+inline constexpr bool is_concurrent_index_map_v = false;
+
+template <hashable_key Key, std::unsigned_integral Index>
+inline constexpr bool is_concurrent_index_map_v<concurrent_index_map<Key, Index>> = true;
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_INDEX_MAP_HPP
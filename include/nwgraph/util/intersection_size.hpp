@@ -24,16 +24,199 @@
 #include <execution>
 #include <numeric>
 #endif
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NW_GRAPH_X86_INTERSECTION 1
+#include <immintrin.h>
+#endif
+
 namespace nw {
 namespace graph {
+
+/// Iterators over ranges whose first column is a contiguous array of
+/// `uint32_t`, like the neighbor ranges of our compressed adjacencies.  These
+/// ranges are intersected with the kernels in `nw::graph::intersection`.
+template <class Iterator>
+concept contiguous_vertex_iterator = requires(const Iterator& i) {
+  { i - i } -> std::convertible_to<std::ptrdiff_t>;
+  requires std::same_as<std::remove_cvref_t<decltype(*i.template column_data<0>())>, std::uint32_t>;
+};
+
+/// Intersection kernels for sorted arrays of `uint32_t`.
+///
+/// The kernels count the values common to two nondecreasing arrays with the
+/// semantics of a merge: every copy of a repeated value matches at most one
+/// copy in the other array, as for `std::set_intersection`.  The neighborhoods
+/// of a simple graph are strictly increasing, and the SIMD kernels fall back to
+/// the scalar merge when they find repeats, e.g., in a multigraph.  `dispatch` picks
+/// galloping search when the arrays are lopsided, and otherwise the widest
+/// block-wise SIMD kernel that the CPU supports at runtime.
+namespace intersection {
+
+/// Use galloping search when one array is this many times longer than the other.
+inline constexpr std::size_t galloping_ratio = 32;
+
+/// Branch-free scalar merge.
+inline std::size_t scalar(const std::uint32_t* a, std::size_t na, const std::uint32_t* b, std::size_t nb) {
+  std::size_t i = 0, j = 0, n = 0;
+  while (i < na && j < nb) {
+    std::uint32_t x = a[i], y = b[j];
+    n += (x == y);
+    i += (x <= y);
+    j += (y <= x);
+  }
+  return n;
+}
+
+/// Search each value of the short array `a` in the long array `b`, with an
+/// exponential search from the previous match.
+inline std::size_t galloping(const std::uint32_t* a, std::size_t na, const std::uint32_t* b, std::size_t nb) {
+  std::size_t n = 0, j = 0;
+  for (std::size_t i = 0; i < na && j < nb; ++i) {
+    std::uint32_t x    = a[i];
+    std::size_t   step = 1, hi = j;
+    while (hi < nb && b[hi] < x) {
+      j = hi + 1;
+      hi += step;
+      step <<= 1;
+    }
+    j = std::lower_bound(b + j, b + std::min(hi, nb), x) - b;
+    if (j < nb && b[j] == x) {
+      ++n;
+      ++j;
+    }
+  }
+  return n;
+}
+
+#if defined(NW_GRAPH_X86_INTERSECTION)
+/// Whether the i-th value of `a` repeats the one before it.
+inline bool repeats(const std::uint32_t* a, std::size_t na, std::size_t i) { return 0 < i && i < na && a[i - 1] == a[i]; }
+
+/// Compare blocks of 8 values all-to-all, advancing the block with the smaller
+/// last value, and merge the leftovers.
+///
+/// An all-to-all compare would count a repeated value once per copy in the
+/// other block, so the blocks are also checked for repeats, and the arrays are
+/// merged from the start if there are any.
+__attribute__((target("avx2"))) inline std::size_t avx2(const std::uint32_t* a, std::size_t na, const std::uint32_t* b, std::size_t nb) {
+  const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+  std::size_t i = 0, j = 0, n = 0;
+  __m256i     dup  = _mm256_setzero_si256();
+  bool        seam = false;
+  while (i + 8 <= na && j + 8 <= nb) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+
+    // Neighboring lanes are equal only for repeats, and so are the first and
+    // last lanes of a nondecreasing block.
+    dup = _mm256_or_si256(dup, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(va, rotate)));
+    dup = _mm256_or_si256(dup, _mm256_cmpeq_epi32(vb, _mm256_permutevar8x32_epi32(vb, rotate)));
+    for (int k = 1; k < 8; ++k) {
+      vb = _mm256_permutevar8x32_epi32(vb, rotate);
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+    n += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(eq))));
+    seam |= repeats(a, na, i) | repeats(b, nb, j);
+
+    std::uint32_t x = a[i + 7], y = b[j + 7];
+    i += (x <= y) * 8;
+    j += (y <= x) * 8;
+  }
+  if (seam | repeats(a, na, i) | repeats(b, nb, j) | !_mm256_testz_si256(dup, dup)) {
+    return scalar(a, na, b, nb);
+  }
+  return n + scalar(a + i, na - i, b + j, nb - j);
+}
+
+/// Compare blocks of 16 values all-to-all, advancing the block with the smaller
+/// last value, and merge the leftovers.  Repeats are handled as in `avx2`.
+__attribute__((target("avx512f"))) inline std::size_t avx512(const std::uint32_t* a, std::size_t na, const std::uint32_t* b, std::size_t nb) {
+  const __m512i rotate = _mm512_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+
+  std::size_t i = 0, j = 0, n = 0;
+  __mmask16   dup  = 0;
+  bool        seam = false;
+  while (i + 16 <= na && j + 16 <= nb) {
+    __m512i   va = _mm512_loadu_si512(a + i);
+    __m512i   vb = _mm512_loadu_si512(b + j);
+    __mmask16 eq = _mm512_cmpeq_epi32_mask(va, vb);
+
+    // The zero-masking permute keeps GCC from warning that the pass-through
+    // operand of the unmasked one may be used uninitialized.
+    dup |= _mm512_cmpeq_epi32_mask(va, _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, va));
+    dup |= _mm512_cmpeq_epi32_mask(vb, _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, vb));
+    for (int k = 1; k < 16; ++k) {
+      vb = _mm512_maskz_permutexvar_epi32(0xFFFF, rotate, vb);
+      eq |= _mm512_cmpeq_epi32_mask(va, vb);
+    }
+    n += std::popcount(static_cast<unsigned>(eq));
+    seam |= repeats(a, na, i) | repeats(b, nb, j);
+
+    std::uint32_t x = a[i + 15], y = b[j + 15];
+    i += (x <= y) * 16;
+    j += (y <= x) * 16;
+  }
+  if (seam | repeats(a, na, i) | repeats(b, nb, j) | (dup != 0)) {
+    return scalar(a, na, b, nb);
+  }
+  return n + scalar(a + i, na - i, b + j, nb - j);
+}
+#endif
+
+using kernel = std::size_t (*)(const std::uint32_t*, std::size_t, const std::uint32_t*, std::size_t);
+
+/// The widest block-wise kernel that the CPU supports.
+inline kernel block_kernel() {
+  static const kernel k = [] {
+#if defined(NW_GRAPH_X86_INTERSECTION)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return &avx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+      return &avx2;
+    }
+#endif
+    return &scalar;
+  }();
+  return k;
+}
+
+/// Count the values common to two nondecreasing arrays.
+inline std::size_t dispatch(const std::uint32_t* a, std::size_t na, const std::uint32_t* b, std::size_t nb) {
+  if (na > nb) {
+    std::swap(a, b);
+    std::swap(na, nb);
+  }
+  if (na == 0) {
+    return 0;
+  }
+  if (na * galloping_ratio < nb) {
+    return galloping(a, na, b, nb);
+  }
+  return block_kernel()(a, na, b, nb);
+}
+
+}    // namespace intersection
+
 /// Basic helper used for all of the inner set intersections.
 ///
 /// This wraps `std::set_intersection` to produce the size of the set rather
 /// than the set itself, and also handles the fact that our iterator value types
 /// are tuples where we only care about the first element for ordering.
 ///
+/// With the sequential policy, ranges of contiguous `uint32_t` vertex ids are
+/// intersected by the kernels in `nw::graph::intersection`, and other ranges by
+/// a merge loop.  Other policies use `std::set_intersection`.
+///
 /// @tparam           A The type of the first iterator.
 /// @tparam           B The type of the second iterator.
 /// @tparam           C The type of the third iterator.
@@ -59,7 +242,15 @@ std::size_t intersection_size(A i, B&& ie, C j, D&& je, ExecutionPolicy&& ep) {
   // @todo We really don't need set intersection. You'd hope that it would be
   //       efficient with the output counter, but it just isn't. Parallelizing
   //       the intersection size seems non-trivial though.
-  if constexpr (std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>) {
+  //
+  // Sequential intersections of contiguous vertex ids go to the vectorized
+  // kernels.  Parallel policies still use std::set_intersection.
+  if constexpr (std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy> && contiguous_vertex_iterator<A> &&
+                contiguous_vertex_iterator<C> && std::same_as<A, std::decay_t<B>> && std::same_as<C, std::decay_t<D>>) {
+    (void)ep;
+    return intersection::dispatch(i.template column_data<0>(), ie - i, j.template column_data<0>(), je - j);
+  } else if constexpr (std::is_same_v<std::decay_t<ExecutionPolicy>, std::execution::sequenced_policy>) {
+    (void)ep;
     std::size_t n = 0;
     while (i != ie && j != je) {
       if (lt(*i, *j)) {
@@ -73,7 +264,6 @@ std::size_t intersection_size(A i, B&& ie, C j, D&& je, ExecutionPolicy&& ep) {
       }
     }
     return n;
-    (void)ep;
   } else {
     return std::set_intersection(std::forward<ExecutionPolicy>(ep), std::forward<A>(i), std::forward<B>(ie), std::forward<C>(j),
                                  std::forward<D>(je), nw::graph::counter{}, lt);
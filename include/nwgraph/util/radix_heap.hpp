@@ -0,0 +1,121 @@
+/**
+ * @file radix_heap.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_RADIX_HEAP_HPP
+#define NW_GRAPH_RADIX_HEAP_HPP
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace nw {
+namespace graph {
+
+/// A monotone min-priority queue for unsigned integer keys (a radix heap).
+///
+/// The keys pushed must never be smaller than the last key popped, which is
+/// the case for Dijkstra's algorithm with non-negative integer weights.  An
+/// entry lives in the bucket of the highest bit in which its key differs from
+/// the last key popped, so every entry moves to a lower bucket at most once
+/// per bit, and push and pop cost amortized O(log C) for keys up to C without
+/// any comparisons between entries.  There is no decrease-key: push a new
+/// entry and skip the stale one when it is popped.
+///
+/// @tparam Key   The key type.
+/// @tparam Value The type of the payload, e.g., a vertex id.
+template <std::unsigned_integral Key, class Value>
+class radix_heap {
+  static constexpr std::size_t num_buckets = std::numeric_limits<Key>::digits + 1;
+
+  using entry = std::pair<Key, Value>;
+
+  std::array<std::vector<entry>, num_buckets> buckets_;
+  std::array<Key, num_buckets>                minimum_;
+  Key                                         last_ = 0;
+  std::size_t                                 size_ = 0;
+
+  static std::size_t bucket(Key key, Key last) { return std::bit_width(Key(key ^ last)); }
+
+  // Make sure the smallest entries are in bucket 0, by redistributing the
+  // lowest non-empty bucket around its minimum.
+  void pull() {
+    if (!buckets_[0].empty()) {
+      return;
+    }
+    std::size_t i = 1;
+    while (buckets_[i].empty()) {
+      ++i;
+    }
+    last_ = minimum_[i];
+    for (auto&& e : buckets_[i]) {
+      std::size_t b = bucket(e.first, last_);
+      minimum_[b]   = buckets_[b].empty() ? e.first : std::min(minimum_[b], e.first);
+      buckets_[b].push_back(e);
+    }
+    buckets_[i].clear();
+  }
+
+public:
+  using value_type = entry;
+  using size_type  = std::size_t;
+
+  radix_heap() = default;
+
+  bool        empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  /// The last key popped, which is a lower bound for every key in the heap.
+  Key last() const { return last_; }
+
+  void push(Key key, Value value) {
+    assert(key >= last_ && "radix_heap requires monotone keys");
+    std::size_t b = bucket(key, last_);
+    minimum_[b]   = buckets_[b].empty() ? key : std::min(minimum_[b], key);
+    buckets_[b].emplace_back(key, value);
+    ++size_;
+  }
+
+  /// The entry with the smallest key.  Not const, since it may move entries between buckets.
+  const entry& top() {
+    assert(!empty());
+    pull();
+    return buckets_[0].back();
+  }
+
+  void pop() {
+    assert(!empty());
+    pull();
+    buckets_[0].pop_back();
+    --size_;
+  }
+
+  /// Remove every entry and start over from key 0, keeping the memory of the buckets.
+  void clear() {
+    for (auto&& b : buckets_) {
+      b.clear();
+    }
+    last_ = 0;
+    size_ = 0;
+  }
+};
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_RADIX_HEAP_HPP
@@ -0,0 +1,130 @@
+/**
+ * @file radix_sort.hpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#ifndef NW_GRAPH_RADIX_SORT_HPP
+#define NW_GRAPH_RADIX_SORT_HPP
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+namespace nw {
+namespace graph {
+
+/// Split [0, n) into contiguous chunks for the counting passes of a radix sort
+/// (and of the other scans that follow the same count / offset / scatter
+/// pattern).
+class radix_chunks {
+  std::size_t n_;
+  std::size_t chunks_;
+
+public:
+  explicit radix_chunks(std::size_t n, std::size_t grain = std::size_t(1) << 16)
+      : n_(n), chunks_(std::clamp<std::size_t>((n + grain - 1) / grain, 1, 4 * tbb::this_task_arena::max_concurrency())) {}
+
+  std::size_t size() const { return chunks_; }
+  std::size_t begin(std::size_t c) const { return n_ * c / chunks_; }
+  std::size_t end(std::size_t c) const { return n_ * (c + 1) / chunks_; }
+
+  /// Call f(c, begin, end) for every chunk in parallel.
+  template <class F>
+  void for_each(F&& f) const {
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, chunks_, 1), [&](auto&& r) {
+      for (auto c = r.begin(), e = r.end(); c != e; ++c) {
+        f(c, begin(c), end(c));
+      }
+    });
+  }
+};
+
+/**
+ * @brief Stable parallel LSD radix sort of integer keys, moving values along.
+ *
+ * Every pass sorts one byte of the keys: the chunks of the input count their
+ * digits, the counts are scanned digit-major so that equal digits keep the
+ * order of the chunks, and the chunks scatter their elements into place.
+ * Passes where every key has the same digit are skipped.
+ *
+ * @tparam Key Unsigned integer key type.
+ * @tparam Value Type of the values carried along with the keys.
+ * @param keys The keys to sort.
+ * @param values The values, one per key.
+ * @param bits Only the low `bits` bits of the keys are sorted on.
+ */
+template <std::unsigned_integral Key, class Value>
+void radix_sort(std::vector<Key>& keys, std::vector<Value>& values, unsigned bits = std::numeric_limits<Key>::digits) {
+  constexpr unsigned    radix   = 8;
+  constexpr std::size_t buckets = std::size_t(1) << radix;
+
+  const std::size_t n = keys.size();
+  if (n < 2) {
+    return;
+  }
+
+  radix_chunks             chunks(n);
+  std::vector<std::size_t> counts(chunks.size() * buckets);
+  std::vector<Key>         tmp_keys(n);
+  std::vector<Value>       tmp_values(n);
+
+  for (unsigned shift = 0; shift < bits; shift += radix) {
+    auto digit = [shift](Key k) { return (k >> shift) & (buckets - 1); };
+
+    chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+      std::size_t* count = counts.data() + c * buckets;
+      std::fill(count, count + buckets, 0);
+      for (; i != e; ++i) {
+        ++count[digit(keys[i])];
+      }
+    });
+
+    std::size_t offset = 0;
+    bool        skip   = false;
+    for (std::size_t d = 0; d < buckets; ++d) {
+      std::size_t start = offset;
+      for (std::size_t c = 0; c < chunks.size(); ++c) {
+        std::size_t count       = counts[c * buckets + d];
+        counts[c * buckets + d] = offset;
+        offset += count;
+      }
+      skip |= (offset - start == n);
+    }
+    if (skip) {
+      continue;
+    }
+
+    chunks.for_each([&](std::size_t c, std::size_t i, std::size_t e) {
+      std::size_t* offsets = counts.data() + c * buckets;
+      for (; i != e; ++i) {
+        std::size_t j = offsets[digit(keys[i])]++;
+        tmp_keys[j]   = keys[i];
+        tmp_values[j] = std::move(values[i]);
+      }
+    });
+
+    keys.swap(tmp_keys);
+    values.swap(tmp_values);
+  }
+}
+
+}    // namespace graph
+}    // namespace nw
+
+#endif    // NW_GRAPH_RADIX_SORT_HPP
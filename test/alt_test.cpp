@@ -0,0 +1,109 @@
+/**
+ * @file alt_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/alt.hpp"
+#include "nwgraph/algorithms/dijkstra.hpp"
+#include "nwgraph/edge_list.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+using distance_t = std::uint64_t;
+
+TEST_CASE("ALT queries on a road-like grid", "[alt]") {
+  // A weighted 40 x 40 grid, in both directions.
+  constexpr size_t                        W = 40, N = W * W;
+  std::mt19937                            gen(11);
+  std::uniform_int_distribution<unsigned> weight(1, 20);
+
+  edge_list<directedness::undirected, unsigned> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < W; ++i) {
+    for (size_t j = 0; j < W; ++j) {
+      if (i + 1 < W) E.push_back(i * W + j, (i + 1) * W + j, weight(gen));
+      if (j + 1 < W) E.push_back(i * W + j, i * W + j + 1, weight(gen));
+    }
+  }
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+
+  auto dijkstra = make_dijkstra_query<distance_t>(A);
+
+  for (auto selection : {landmark_selection::farthest, landmark_selection::avoid}) {
+    auto table = select_landmarks<distance_t>(A, 8, selection);
+    REQUIRE(table.size() == 8);
+    REQUIRE(table.symmetric());
+
+    auto                                  alt = make_alt_query<distance_t>(A, table);
+    std::uniform_int_distribution<size_t> vertex(0, N - 1);
+    size_t                                alt_settled = 0, dijkstra_settled = 0;
+    for (int q = 0; q < 50; ++q) {
+      size_t s = vertex(gen), t = vertex(gen);
+      auto   d = dijkstra.query(s, t);
+      REQUIRE(alt.query(s, t) == d);
+      REQUIRE(table.lower_bound(s, t) <= d);
+      auto path = alt.path(t);
+      REQUIRE(path.front() == s);
+      REQUIRE(path.back() == t);
+      alt_settled += alt.settled();
+      dijkstra_settled += dijkstra.settled();
+    }
+    REQUIRE(4 * alt_settled < dijkstra_settled);
+  }
+}
+
+TEST_CASE("ALT on a directed graph with a serialized table", "[alt]") {
+  constexpr size_t                        N = 800;
+  std::mt19937                            gen(5);
+  std::uniform_int_distribution<size_t>   vertex(0, N - 1);
+  std::uniform_int_distribution<unsigned> weight(1, 100);
+
+  edge_list<directedness::directed, unsigned> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < 3 * N; ++i) {
+    E.push_back(vertex(gen), vertex(gen), weight(gen));
+  }
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+  adjacency<1, unsigned> T(E);
+
+  auto table = select_landmarks<distance_t>(A, T, 6, landmark_selection::avoid, detail::first_attribute_weight{}, 3);
+  REQUIRE(!table.symmetric());
+
+  // Store the graph and its table in one stream, and read them back.
+  std::stringstream stream;
+  A.serialize(stream);
+  table.serialize(stream);
+
+  adjacency<0, unsigned>     B(0);
+  landmark_table<distance_t> restored;
+  B.deserialize(stream);
+  restored.deserialize(stream);
+  REQUIRE(B.num_edges() == A.num_edges());
+  REQUIRE(restored.landmarks() == table.landmarks());
+
+  auto dijkstra = make_dijkstra_query<distance_t>(A);
+  auto alt      = make_alt_query<distance_t>(B, restored);
+  for (int q = 0; q < 100; ++q) {
+    size_t s = vertex(gen), t = vertex(gen);
+    REQUIRE(alt.query(s, t) == dijkstra.query(s, t));
+  }
+}
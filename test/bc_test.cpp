@@ -0,0 +1,67 @@
+/**
+ * @file bc_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *
+ */
+
+#include <numeric>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/betweenness_centrality.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/io/mmio.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+TEST_CASE("betweenness centrality", "[bc]") {
+  auto         E = read_mm<directedness::undirected>(DATA_DIR "USAir97.mtx");
+  adjacency<0> A(E);
+
+  using vertex_id_type = vertex_id_t<adjacency<0>>;
+
+  SECTION("sampled sources, repeated and spread over workers") {
+    std::vector<vertex_id_type> sources = {0, 17, 42, 17, 100, 331, 5, 0, 200};
+    for (int threads : {1, 4}) {
+      auto bc = brandes_bc<float, double>(A, sources, threads);
+      REQUIRE(BCVerifier<float, double>(A, sources, bc));
+    }
+  }
+
+  SECTION("more sources than a batch, with sequential levels") {
+    std::vector<vertex_id_type> sources(150);
+    for (size_t i = 0; i < sources.size(); ++i) {
+      sources[i] = (i * 37) % A.size();
+    }
+    auto bc = brandes_bc<float, double>(A, sources, 1, std::execution::seq, std::execution::seq);
+    REQUIRE(BCVerifier<float, double>(A, sources, bc));
+  }
+
+  SECTION("narrow batches") {
+    std::vector<vertex_id_type> sources(70);
+    for (size_t i = 0; i < sources.size(); ++i) {
+      sources[i] = (i * 53) % A.size();
+    }
+    for (std::size_t width : {1, 7, 64}) {
+      auto bc = brandes_bc<float, double>(A, sources, 4, std::execution::par_unseq, std::execution::par_unseq, true, width);
+      REQUIRE(BCVerifier<float, double>(A, sources, bc));
+    }
+  }
+
+  SECTION("exact") {
+    auto                        bc = exact_brandes_bc<float, double>(A, 0);
+    std::vector<vertex_id_type> sources(A.size());
+    std::iota(sources.begin(), sources.end(), 0);
+    REQUIRE(BCVerifier<float, double>(A, sources, bc));
+  }
+}
@@ -19,7 +19,10 @@
 #include <vector>
 
 #include "nwgraph/algorithms/bfs.hpp"
+#include "nwgraph/adjacency.hpp"
 #include "nwgraph/containers/aos.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/util/frontier.hpp"
 
 #include "common/abstract_test.hpp"
 
@@ -112,3 +115,68 @@ TEST_CASE("BFS traversal", "[bfs]") {
     REQUIRE(validate(aos_a, 1, distance, predecessor));
   }
 }
+
+TEST_CASE("sliding queue", "[bfs]") {
+  sliding_queue<int> queue(8);
+  queue.push_back(0);
+  queue.slide_window();
+  REQUIRE(queue.size() == 1);
+
+  auto buffers = make_frontier_buffers(queue);
+  buffers.local().push_back(1);
+  buffers.local().push_back(2);
+  queue.flush(buffers);
+  REQUIRE(queue.size() == 1);
+  queue.slide_window();
+  REQUIRE(std::vector<int>(queue.begin(), queue.end()) == std::vector<int>{1, 2});
+
+  queue.slide_window();
+  REQUIRE(queue.empty());
+  REQUIRE(queue.num_windows() == 3);
+  REQUIRE(queue.window(0).size() == 1);
+  REQUIRE(queue.window(1)[1] == 2);
+}
+
+TEST_CASE("direction-optimizing BFS", "[bfs]") {
+  auto         E = read_mm<directedness::directed>(DATA_DIR "USAir97.mtx");
+  adjacency<0> A(E);
+  adjacency<1> At(E);
+
+  auto&& [level, pred] = bfs_m1(A, 0);
+
+  for (int alpha : {1, 15, 1000}) {
+    std::vector<frontier_level> trace;
+    auto                        parents = bfs(A, At, 0, 32, alpha, 18, &trace);
+    REQUIRE(BFSVerifier(A, At, 0, parents));
+
+    size_t reached = std::count_if(level.begin(), level.end(), [](auto l) { return l != std::numeric_limits<vertex_id_t<adjacency<0>>>::max(); });
+    REQUIRE(std::accumulate(trace.begin(), trace.end(), size_t(0), [](auto n, auto&& t) { return n + (t.bottom_up ? 0 : t.frontier); }) <= reached);
+    if (alpha == 1000) {
+      REQUIRE(std::any_of(trace.begin(), trace.end(), [](auto&& t) { return t.bottom_up; }));
+    }
+  }
+}
+
+TEST_CASE("multi-source BFS", "[bfs]") {
+  auto         E = read_mm<directedness::undirected>(DATA_DIR "USAir97.mtx");
+  adjacency<0> A(E);
+
+  using vertex_id_type = vertex_id_t<adjacency<0>>;
+
+  // More roots than a batch holds, with a repeated root.
+  std::vector<vertex_id_type> roots(70);
+  for (size_t i = 0; i < roots.size(); ++i) {
+    roots[i] = (i * 37) % A.size();
+  }
+  roots[69] = roots[0];
+
+  auto&& [levels, parents] = multi_source_bfs(A, roots);
+  auto&& [levels32, parents32] = multi_source_bfs<uint32_t>(A, roots);
+  REQUIRE(levels == levels32);
+
+  for (size_t i = 0; i < roots.size(); ++i) {
+    auto&& [level, pred] = bfs_m1(A, roots[i]);
+    REQUIRE(levels[i] == level);
+    REQUIRE(BFSVerifier(A, A, roots[i], parents[i]));
+  }
+}
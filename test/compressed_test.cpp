@@ -14,11 +14,15 @@
  */
 
 
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <stdexcept>
 
 #include "common/test_header.hpp"
 #include "nwgraph/adjacency.hpp"
 #include "nwgraph/edge_list.hpp"
+#include "nwgraph/io/mmio.hpp"
 
 using namespace nw::graph;
 using namespace nw::util;
@@ -173,6 +177,116 @@ TEST_CASE("indexed_struct_of_arrays const iteration", "[const]") {
   }
 }
 
+TEST_CASE("fill adjacency by counting sort", "[fill]") {
+  SECTION("directed keeps edge list order and attributes") {
+    edge_list<directedness::directed, double> E(N);
+    E.push_back(3, 1, 3.1);
+    E.push_back(0, 4, 0.4);
+    E.push_back(3, 0, 3.0);
+    E.push_back(1, 2, 1.2);
+    E.push_back(3, 2, 3.2);
+
+    adjacency<0, double> A(E);
+    REQUIRE(A.size() == N);
+    REQUIRE(A.num_edges() == 5);
+    REQUIRE(A[0].size() == 1);
+    REQUIRE(A[2].size() == 0);
+    REQUIRE(A[3].size() == 3);
+
+    std::vector<unsigned> targets;
+    for (auto&& [v, w] : A[3]) {
+      targets.push_back(v);
+      REQUIRE(w == Approx(3 + v / 10.0));
+    }
+    REQUIRE(targets == std::vector<unsigned>{1, 0, 2});
+
+    adjacency<1, double> B(E);
+    REQUIRE(B[2].size() == 2);
+    REQUIRE(std::get<0>(*B[2].begin()) == 1);
+    REQUIRE(std::get<1>(*B[2].begin()) == Approx(1.2));
+  }
+
+  SECTION("undirected places both directions") {
+    edge_list<directedness::undirected> E(N);
+    E.push_back(0, 1);
+    E.push_back(1, 2);
+    E.push_back(4, 1);
+
+    adjacency<0> A(E);
+    REQUIRE(A.num_edges() == 6);
+    REQUIRE(A[1].size() == 3);
+    REQUIRE(A[3].size() == 0);
+
+    std::vector<unsigned> targets;
+    for (auto&& [v] : A[1]) {
+      targets.push_back(v);
+    }
+    REQUIRE(targets == std::vector<unsigned>{2, 0, 4});
+  }
+
+  SECTION("placement keeps edge list order for any number of chunks and any policy") {
+    // Every neighborhood holds the edge indices in increasing order
+    auto check = [](auto&& E, auto&& A) {
+      REQUIRE(A.num_edges() == E.size());
+      for (size_t u = 0; u < A.size(); ++u) {
+        for (auto&& [v, i] : A[u]) {
+          REQUIRE(std::get<0>(E[i]) == u);
+          REQUIRE(std::get<1>(E[i]) == v);
+        }
+        REQUIRE(std::is_sorted(std::get<1>(A.to_be_indexed_).begin() + A.indices_[u],
+                               std::get<1>(A.to_be_indexed_).begin() + A.indices_[u + 1]));
+      }
+    };
+
+    const size_t m = 1 << 18;
+    for (size_t n : {size_t(1) << 20, size_t(1) << 10}) {    // fewer chunks than threads, and as many
+      edge_list<directedness::directed, unsigned> E(n);
+      for (size_t i = 0; i < m; ++i) {
+        E.push_back((i * 7919) % n, (i * 104729) % n, i);
+      }
+
+      tbb::task_arena arena(4);
+      arena.execute([&] {
+        adjacency<0, unsigned> A(E);
+        check(E, A);
+        adjacency<0, unsigned> B(n, E, false, std::execution::seq);
+        check(E, B);
+        REQUIRE(A.indices_ == B.indices_);
+        REQUIRE(A.to_be_indexed_ == B.to_be_indexed_);
+      });
+    }
+  }
+}
+
+TEST_CASE("64-bit offsets with 32-bit vertex ids", "[index64]") {
+  using wide_adjacency = index_adjacency<0, uint64_t, uint32_t, double>;
+  static_assert(sizeof(wide_adjacency::index_t) == 8);
+  static_assert(sizeof(wide_adjacency::vertex_id_type) == 4);
+
+  auto E = read_mm<directedness::directed, double>(DATA_DIR "USAir97.mtx");
+  adjacency<0, double> A(E);
+  wide_adjacency       B(E);
+
+  REQUIRE(B.size() == A.size());
+  REQUIRE(B.num_edges() == A.num_edges());
+  REQUIRE(std::equal(A.indices_.begin(), A.indices_.end(), B.indices_.begin()));
+  REQUIRE(std::get<0>(A.to_be_indexed_) == std::get<0>(B.to_be_indexed_));
+
+  std::string file = (std::filesystem::temp_directory_path() / "nwgraph_compressed_test_wide.nw").string();
+  B.serialize(file);
+  wide_adjacency C(0);
+  C.deserialize(file);
+  REQUIRE(C.size() == B.size());
+  REQUIRE(C.indices_ == B.indices_);
+  REQUIRE(std::get<0>(C.to_be_indexed_) == std::get<0>(B.to_be_indexed_));
+  REQUIRE(std::get<1>(C.to_be_indexed_) == std::get<1>(B.to_be_indexed_));
+
+  // A file with 64-bit offsets is rejected by an adjacency with 32-bit ones.
+  index_adjacency<0, uint32_t, uint32_t, double> D(0);
+  REQUIRE_THROWS_AS(D.deserialize(file), std::runtime_error);
+  std::remove(file.c_str());
+}
+
 #if 0
 
 // data/karate.mtx:%%MatrixMarket matrix coordinate pattern symmetric
@@ -83,4 +83,10 @@ TEST_CASE("connected component", "[cc]") {
       REQUIRE(component_id == 0);
     }
   }
+  SECTION("union-find") {
+    component_ids = union_find_components(std::execution::par_unseq, A);
+    for (auto component_id : component_ids) {
+      REQUIRE(component_id == 0);
+    }
+  }
 }
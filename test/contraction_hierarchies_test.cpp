@@ -0,0 +1,121 @@
+/**
+ * @file contraction_hierarchies_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/contraction_hierarchies.hpp"
+#include "nwgraph/algorithms/dijkstra.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/graphs/ospf-graph.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+using distance_t = std::uint64_t;
+
+TEST_CASE("contraction hierarchy of the OSPF graph", "[ch]") {
+  auto hierarchy = build_contraction_hierarchy<distance_t>(ospf_index_adjacency_list);
+  auto query     = make_contraction_hierarchy_query(hierarchy);
+  REQUIRE(hierarchy.num_vertices() == ospf_vertices.size());
+
+  for (auto&& [name, expected] : ospf_shortest_path_distances) {
+    size_t v = std::find(ospf_vertices.begin(), ospf_vertices.end(), name) - ospf_vertices.begin();
+    REQUIRE(query.query(5, v) == expected);
+  }
+}
+
+TEST_CASE("contraction hierarchy of a road-like grid", "[ch]") {
+  constexpr size_t                        W = 40, N = W * W;
+  std::mt19937                            gen(17);
+  std::uniform_int_distribution<unsigned> weight(1, 20);
+
+  edge_list<directedness::undirected, unsigned> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < W; ++i) {
+    for (size_t j = 0; j < W; ++j) {
+      if (i + 1 < W) E.push_back(i * W + j, (i + 1) * W + j, weight(gen));
+      if (j + 1 < W) E.push_back(i * W + j, i * W + j + 1, weight(gen));
+    }
+  }
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+
+  auto hierarchy = build_contraction_hierarchy<distance_t>(A);
+
+  // Every vertex has a rank, and every edge of the hierarchy climbs.
+  std::vector<bool> ranked(N, false);
+  for (size_t v = 0; v < N; ++v) {
+    REQUIRE(!ranked[hierarchy.rank(v)]);
+    ranked[hierarchy.rank(v)] = true;
+    for (auto&& [w, d] : hierarchy.upward()[v]) {
+      REQUIRE(hierarchy.rank(v) < hierarchy.rank(w));
+    }
+    for (auto&& [w, d] : hierarchy.downward()[v]) {
+      REQUIRE(hierarchy.rank(v) < hierarchy.rank(w));
+    }
+  }
+
+  auto                                  dijkstra = make_dijkstra_query<distance_t>(A);
+  auto                                  query    = make_contraction_hierarchy_query(hierarchy);
+  std::uniform_int_distribution<size_t> vertex(0, N - 1);
+  size_t                                ch_settled = 0, dijkstra_settled = 0;
+  for (int q = 0; q < 200; ++q) {
+    size_t s = vertex(gen), t = vertex(gen);
+    REQUIRE(query.query(s, t) == dijkstra.query(s, t));
+    ch_settled += query.settled();
+    dijkstra_settled += dijkstra.settled();
+  }
+  REQUIRE(4 * ch_settled < dijkstra_settled);
+}
+
+TEST_CASE("contraction hierarchy of a directed graph through the binary format", "[ch]") {
+  constexpr size_t                        N = 800;
+  std::mt19937                            gen(23);
+  std::uniform_int_distribution<size_t>   vertex(0, N - 1);
+  std::uniform_int_distribution<unsigned> weight(0, 100);
+
+  edge_list<directedness::directed, unsigned> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < 3 * N; ++i) {
+    E.push_back(vertex(gen), vertex(gen), weight(gen));
+  }
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+
+  // A small witness limit adds more shortcuts, but the distances stay exact.
+  for (size_t settle_limit : {1, 500}) {
+    auto hierarchy = build_contraction_hierarchy<distance_t>(A, detail::first_attribute_weight{}, settle_limit);
+
+    std::stringstream stream;
+    hierarchy.serialize(stream);
+    contraction_hierarchy<distance_t> restored;
+    restored.deserialize(stream);
+    REQUIRE(restored.num_vertices() == N);
+    REQUIRE(restored.num_shortcuts() == hierarchy.num_shortcuts());
+    REQUIRE(restored.upward().num_edges() == hierarchy.upward().num_edges());
+
+    auto dijkstra = make_dijkstra_query<distance_t>(A);
+    auto query    = make_contraction_hierarchy_query(restored);
+    for (int q = 0; q < 300; ++q) {
+      size_t s = vertex(gen), t = vertex(gen);
+      REQUIRE(query.query(s, t) == dijkstra.query(s, t));
+    }
+  }
+}
@@ -0,0 +1,98 @@
+/**
+ * @file delta_stepping_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <limits>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/delta_stepping.hpp"
+#include "nwgraph/edge_list.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+using distance_t = std::uint64_t;
+
+// Bellman-Ford, with unreachable vertices at the largest distance.
+template <class Graph>
+static auto oracle(const Graph& A, size_t source) {
+  std::vector<distance_t> dist(A.size(), std::numeric_limits<distance_t>::max());
+  dist[source]  = 0;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t u = 0; u < A.size(); ++u) {
+      if (dist[u] != std::numeric_limits<distance_t>::max()) {
+        for (auto&& [v, w] : A[u]) {
+          if (dist[u] + w < dist[v]) {
+            dist[v] = dist[u] + w;
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+  return dist;
+}
+
+TEST_CASE("parallel delta stepping", "[delta_stepping]") {
+  constexpr size_t                        N = 2000;
+  std::mt19937                            gen(42);
+  std::uniform_int_distribution<size_t>   vertex(0, N - 1);
+  std::uniform_int_distribution<unsigned> weight(1, 100);
+
+  edge_list<directedness::directed, unsigned> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < 6 * N; ++i) {
+    E.push_back(vertex(gen), vertex(gen), weight(gen));
+  }
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+
+  for (size_t source : {0, 17, 1999}) {
+    auto expected = oracle(A, source);
+    for (distance_t delta : {1, 8, 50, 1000}) {
+      size_t relaxed = 0;
+      auto   dist    = parallel_delta_stepping<distance_t>(A, source, delta, [](auto&& e) { return std::get<1>(e); }, &relaxed);
+      REQUIRE(dist == expected);
+      REQUIRE(relaxed >= A.num_edges() / 2);
+    }
+    REQUIRE(delta_stepping<distance_t>(A, source, distance_t(0)) == expected);
+  }
+
+  SECTION("automatic delta") {
+    distance_t delta = choose_delta<distance_t>(A);
+    REQUIRE(delta >= 1);
+    REQUIRE(delta <= 100);
+  }
+}
+
+TEST_CASE("delta stepping with zero weights and unreachable vertices", "[delta_stepping]") {
+  edge_list<directedness::directed, unsigned> E(6);
+  E.open_for_push_back();
+  E.push_back(0, 1, 0);
+  E.push_back(1, 2, 5);
+  E.push_back(0, 2, 7);
+  E.push_back(2, 3, 0);
+  E.push_back(4, 5, 1);
+  E.close_for_push_back();
+  adjacency<0, unsigned> A(E);
+
+  auto dist = delta_stepping<distance_t>(A, 0, distance_t(2));
+  REQUIRE(dist == std::vector<distance_t>{0, 0, 5, 5, std::numeric_limits<distance_t>::max(), std::numeric_limits<distance_t>::max()});
+}
@@ -0,0 +1,179 @@
+/**
+ * @file dijkstra_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/dijkstra.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/util/d_ary_heap.hpp"
+#include "nwgraph/util/radix_heap.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+// Bellman-Ford, with unreachable vertices at the largest distance.
+template <class Distance, class Graph>
+static auto oracle(const Graph& A, size_t source) {
+  std::vector<Distance> dist(A.size(), std::numeric_limits<Distance>::max());
+  dist[source] = 0;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (size_t u = 0; u < A.size(); ++u) {
+      if (dist[u] != std::numeric_limits<Distance>::max()) {
+        for (auto&& [v, w] : A[u]) {
+          if (dist[u] + w < dist[v]) {
+            dist[v] = dist[u] + w;
+            changed = true;
+          }
+        }
+      }
+    }
+  }
+  return dist;
+}
+
+// The length of a path, or the largest distance if it is not one.
+template <class Distance, class Graph, class Vertex>
+static Distance length(const Graph& A, const std::vector<Vertex>& path) {
+  Distance d = 0;
+  for (size_t i = 1; i < path.size(); ++i) {
+    Distance w = std::numeric_limits<Distance>::max();
+    for (auto&& [v, x] : A[path[i - 1]]) {
+      if (v == path[i]) {
+        w = std::min<Distance>(w, x);
+      }
+    }
+    if (w == std::numeric_limits<Distance>::max()) {
+      return w;
+    }
+    d += w;
+  }
+  return d;
+}
+
+// Exact for integers, up to rounding for paths summed in a different order.
+template <class Distance>
+static bool same(Distance a, Distance b) {
+  if constexpr (std::is_floating_point_v<Distance>) {
+    return a == b || std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(b));
+  } else {
+    return a == b;
+  }
+}
+
+template <class Weight, class Distance>
+static void check_queries(size_t N, size_t M, std::uniform_real_distribution<double> weight) {
+  std::mt19937                          gen(7);
+  std::uniform_int_distribution<size_t> vertex(0, N - 1);
+
+  edge_list<directedness::directed, Weight> E(N);
+  E.open_for_push_back();
+  for (size_t i = 0; i < M; ++i) {
+    E.push_back(vertex(gen), vertex(gen), Weight(weight(gen)));
+  }
+  E.close_for_push_back();
+  adjacency<0, Weight> A(E);
+  adjacency<1, Weight> T(E);
+
+  auto query         = make_dijkstra_query<Distance>(A);
+  auto bidirectional = make_bidirectional_dijkstra_query<Distance>(A, T);
+
+  for (size_t source : {0, 5, 123}) {
+    auto expected = oracle<Distance>(A, source);
+    auto dist     = dijkstra<Distance>(A, source);
+    auto lazy     = dijkstra_er<Distance>(A, source);
+    query.search(source);
+    for (size_t v = 0; v < N; ++v) {
+      REQUIRE(same(dist[v], expected[v]));
+      REQUIRE(same(lazy[v], expected[v]));
+      REQUIRE(same(query.distance(v), expected[v]));
+    }
+
+    for (size_t target = 0; target < N; target += 7) {
+      REQUIRE(same(query.query(source, target), expected[target]));
+      REQUIRE(same(bidirectional.query(source, target), expected[target]));
+      if (expected[target] != std::numeric_limits<Distance>::max()) {
+        auto path = bidirectional.path();
+        REQUIRE(path.front() == source);
+        REQUIRE(path.back() == target);
+        REQUIRE(same(length<Distance>(A, path), expected[target]));
+        REQUIRE(same(length<Distance>(A, query.path(target)), expected[target]));
+      } else {
+        REQUIRE(bidirectional.path().empty());
+      }
+    }
+  }
+}
+
+TEST_CASE("point-to-point queries", "[dijkstra]") {
+  SECTION("integer weights") {
+    check_queries<unsigned, std::uint64_t>(500, 2000, std::uniform_real_distribution<double>(0, 1000));
+  }
+  SECTION("floating point weights") {
+    check_queries<double, double>(500, 2000, std::uniform_real_distribution<double>(0, 1));
+  }
+}
+
+TEST_CASE("monotone priority queues", "[dijkstra]") {
+  std::mt19937 gen(3);
+
+  SECTION("radix heap") {
+    radix_heap<std::uint32_t, int> heap;
+    std::vector<std::uint32_t>     popped;
+    std::uint32_t                  last = 0;
+    for (int i = 0; i < 10000; ++i) {
+      heap.push(last + gen() % 1000, i);
+      if (i % 3 == 0) {
+        last = heap.top().first;
+        popped.push_back(last);
+        heap.pop();
+      }
+    }
+    while (!heap.empty()) {
+      popped.push_back(heap.top().first);
+      heap.pop();
+    }
+    REQUIRE(popped.size() == 10000);
+    REQUIRE(std::is_sorted(popped.begin(), popped.end()));
+  }
+
+  SECTION("indexed 4-ary heap") {
+    indexed_d_ary_heap<double, std::uint32_t> heap(1000);
+    std::vector<double>                       key(1000, 2.0);
+    for (std::uint32_t i = 0; i < 1000; ++i) {
+      heap.push(key[i] = double(gen() % 1000) / 1000, i);
+    }
+    for (std::uint32_t i = 0; i < 1000; i += 2) {
+      heap.push(key[i] /= 2, i);
+    }
+    REQUIRE(heap.size() == 1000);
+    double previous = 0;
+    while (!heap.empty()) {
+      auto [k, i] = heap.top();
+      REQUIRE(k == key[i]);
+      REQUIRE(k >= previous);
+      previous = k;
+      heap.pop();
+    }
+  }
+}
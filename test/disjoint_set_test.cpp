@@ -0,0 +1,106 @@
+/**
+ * @file disjoint_set_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <cstdint>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+
+#include "nwgraph/util/disjoint_set.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+// The component of every vertex as its smallest vertex, by repeated relaxation.
+template <class Edges>
+static std::vector<size_t> oracle(size_t n, const Edges& edges) {
+  std::vector<size_t> label(n);
+  for (size_t v = 0; v < n; ++v) {
+    label[v] = v;
+  }
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto&& [u, v] : edges) {
+      if (label[u] != label[v]) {
+        label[u] = label[v] = std::min(label[u], label[v]);
+        changed             = true;
+      }
+    }
+  }
+  return label;
+}
+
+TEST_CASE("disjoint set over unsigned ids", "[disjoint_set]") {
+  disjoint_set<std::uint16_t> sets(10);
+  REQUIRE(sets.num_sets() == 10);
+  REQUIRE(sets.unite(3, 7));
+  REQUIRE(sets.unite(7, 9));
+  REQUIRE(!sets.unite(9, 3));
+  REQUIRE(sets.unite(0, 9));
+  REQUIRE(sets.same(0, 7));
+  REQUIRE(!sets.same(1, 7));
+  REQUIRE(sets.find(9) == 0);
+  REQUIRE(sets.num_sets() == 7);
+
+  sets.reset();
+  REQUIRE(sets.num_sets() == 10);
+  REQUIRE(!sets.same(0, 7));
+}
+
+TEST_CASE("concurrent batch union and find", "[disjoint_set]") {
+  constexpr size_t                      n = 100000, m = 60000, batches = 6;
+  std::mt19937                          gen(29);
+  std::uniform_int_distribution<size_t> vertex(0, n - 1);
+
+  std::vector<std::vector<std::tuple<std::uint64_t, std::uint64_t>>> stream(batches);
+  std::vector<std::pair<size_t, size_t>>                             all;
+  for (auto&& batch : stream) {
+    for (size_t i = 0; i < m / batches; ++i) {
+      auto u = vertex(gen), v = vertex(gen);
+      batch.emplace_back(u, v);
+      all.emplace_back(u, v);
+    }
+  }
+  auto expected = oracle(n, all);
+
+  // Eight threads even on a smaller machine, so the unions race.
+  tbb::global_control threads(tbb::global_control::max_allowed_parallelism, 8);
+  tbb::task_arena     arena(8);
+  arena.execute([&] {
+    // Consume the edges one batch at a time, as they would arrive.
+    disjoint_set<std::uint64_t> sets(n);
+    size_t                      merges = 0;
+    for (auto&& batch : stream) {
+      merges += sets.batch_union(batch);
+      REQUIRE(sets.num_sets() == n - merges);
+    }
+
+    auto labels = sets.batch_find();
+    for (size_t v = 0; v < n; ++v) {
+      REQUIRE(labels[v] == expected[v]);
+    }
+
+    std::vector<std::uint64_t> some = {5, 17, 4242, n - 1};
+    auto                       roots = sets.batch_find(some);
+    for (size_t i = 0; i < some.size(); ++i) {
+      REQUIRE(roots[i] == expected[some[i]]);
+    }
+  });
+}
@@ -15,6 +15,12 @@
 
 #define EDGELIST_AOS
 
+#include <algorithm>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
 #include "nwgraph/build.hpp"
 #include "common/test_header.hpp"
 #include "nwgraph/edge_list.hpp"
@@ -89,6 +95,105 @@ TEST_CASE("sort", "[edge_list]") {
   }
 }
 
+TEST_CASE("radix sort", "[edge_list]") {
+  using edge = std::tuple<size_t, size_t, size_t>;
+
+  // Random edges with many duplicates and self loops; the attribute is the position.
+  std::mt19937                          gen(0);
+  std::uniform_int_distribution<size_t> dist(0, 63);
+  std::vector<edge>                     edges;
+  edge_list<nw::graph::directedness::directed, size_t> A(N);
+  for (size_t i = 0; i < 5 * N; ++i) {
+    size_t u = dist(gen), v = dist(gen);
+    edges.emplace_back(u, v, i);
+    A.push_back(u, v, i);
+  }
+
+  auto as_vector = [](auto&& el) {
+    std::vector<edge> v;
+    for (auto&& [x, y, i] : el) {
+      v.emplace_back(x, y, i);
+    }
+    return v;
+  };
+
+  SECTION("sort_by is stable") {
+    sort_by<1>(A);
+    std::stable_sort(edges.begin(), edges.end(), [](auto&& a, auto&& b) { return std::get<1>(a) < std::get<1>(b); });
+    REQUIRE(as_vector(A) == edges);
+  }
+
+  SECTION("lexical_sort_by orders ties by position") {
+    lexical_sort_by<0>(A);
+    std::sort(edges.begin(), edges.end());
+    REQUIRE(as_vector(A) == edges);
+  }
+
+  SECTION("lexical_sort_by orders ties by attribute") {
+    edge_list<nw::graph::directedness::directed, size_t> B(N);
+    for (auto&& [u, v, i] : edges) {
+      B.push_back(u, v, 5 * N - i);
+    }
+    lexical_sort_by<0>(B);
+    for (auto&& [u, v, i] : edges) {
+      i = 5 * N - i;
+    }
+    std::sort(edges.begin(), edges.end());
+    REQUIRE(as_vector(B) == edges);
+  }
+
+  SECTION("lexical_sort_by orders ties by signed attribute") {
+    edge_list<nw::graph::directedness::directed, int> B(N);
+    std::vector<std::tuple<size_t, size_t, int>> expected;
+    for (auto&& [u, v, i] : edges) {
+      B.push_back(u, v, -int(i));
+      expected.emplace_back(u, v, -int(i));
+    }
+    lexical_sort_by<0>(B);
+    std::sort(expected.begin(), expected.end());
+    REQUIRE(std::equal(B.begin(), B.end(), expected.begin(), [](auto&& e, auto&& f) {
+      return std::tuple(std::get<0>(e), std::get<1>(e), std::get<2>(e)) == f;
+    }));
+  }
+
+  SECTION("simplify_triangular") {
+    std::map<std::pair<size_t, size_t>, size_t> expected;
+    for (auto&& [u, v, i] : edges) {
+      if (u != v) {
+        expected.emplace(std::pair(std::max(u, v), std::min(u, v)), i);
+      }
+    }
+    simplify_triangular<0>(A);
+    REQUIRE(A.size() == expected.size());
+    auto e = expected.begin();
+    for (auto&& [u, v, i] : A) {
+      REQUIRE(std::tuple(u, v, i) == std::tuple(e->first.first, e->first.second, e->second));
+      ++e;
+    }
+  }
+
+  SECTION("simplify_symmetric") {
+    std::map<std::pair<size_t, size_t>, size_t> expected;    // keyed by (column 1, column 0)
+    for (auto&& [u, v, i] : edges) {
+      if (u != v) {
+        expected.emplace(std::pair(v, u), i);
+      }
+    }
+    for (auto&& [u, v, i] : edges) {
+      if (u != v) {
+        expected.emplace(std::pair(u, v), i);
+      }
+    }
+    simplify_symmetric<1>(A);
+    REQUIRE(A.size() == expected.size());
+    auto e = expected.begin();
+    for (auto&& [u, v, i] : A) {
+      REQUIRE(std::tuple(v, u, i) == std::tuple(e->first.first, e->first.second, e->second));
+      ++e;
+    }
+  }
+}
+
 #if 0
 
   array_of_structs<size_t> A;
@@ -0,0 +1,58 @@
+/**
+ * @file index64_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+// This test is built with NWGRAPH_64BIT_INDEX, so the default adjacency has
+// 64-bit offsets and 32-bit vertex ids.
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/bfs.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/io/mmio.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+static_assert(sizeof(default_index_t) == 8);
+static_assert(sizeof(default_vertex_id_type) == 4);
+
+TEST_CASE("default adjacency with 64-bit offsets", "[index64]") {
+  auto                 E = read_mm<directedness::undirected, double>(DATA_DIR "USAir97.mtx");
+  adjacency<0, double> A(E);
+  static_assert(sizeof(A.indices_[0]) == 8);
+
+  index_adjacency<0, uint32_t, uint32_t, double> narrow(E);
+  REQUIRE(A.num_edges() == narrow.num_edges());
+  REQUIRE(std::equal(A.indices_.begin(), A.indices_.end(), narrow.indices_.begin(), narrow.indices_.end()));
+  REQUIRE(bfs(A, 0) == bfs(narrow, 0));
+
+  std::string file = (std::filesystem::temp_directory_path() / "nwgraph_index64_test.nw").string();
+  A.serialize(file);
+
+  adjacency<0, double> B(0);
+  B.deserialize(file);
+  REQUIRE(B.size() == A.size());
+  REQUIRE(B.indices_ == A.indices_);
+  REQUIRE(std::get<0>(B.to_be_indexed_) == std::get<0>(A.to_be_indexed_));
+  REQUIRE(std::get<1>(B.to_be_indexed_) == std::get<1>(A.to_be_indexed_));
+
+  index_adjacency<0, uint32_t, uint32_t, double> C(0);
+  REQUIRE_THROWS_AS(C.deserialize(file), std::runtime_error);
+  std::remove(file.c_str());
+}
@@ -0,0 +1,115 @@
+/**
+ * @file index_map_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "nwgraph/build.hpp"
+#include "nwgraph/util/index_map.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+TEST_CASE("concurrent index map", "[index_map]") {
+  SECTION("integer keys") {
+    std::vector<size_t> keys;
+    for (size_t i = 0; i < 100000; ++i) {
+      keys.push_back(i * 7919 % 100003);
+    }
+    auto map = make_index_map(keys);
+    REQUIRE(map.size() == keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      REQUIRE(map[keys[i]] == i);
+    }
+    REQUIRE(map.find(100003) == map.npos);
+    REQUIRE(!map.contains(100003));
+  }
+
+  SECTION("string keys and duplicates") {
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < 50000; ++i) {
+      keys.push_back("vertex " + std::to_string(i % 20000));
+    }
+    auto map = make_index_map(keys);
+    REQUIRE(map.size() == 20000);
+
+    // A duplicated key maps to its last position, as with std::map.
+    std::vector<size_t> found(keys.size());
+    map.find_all(keys, found);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      REQUIRE(found[i] == 40000 + i % 20000 - (i % 20000 >= 10000 ? 20000 : 0));
+    }
+    REQUIRE(map.find("no such vertex") == map.npos);
+    REQUIRE_THROWS_AS(map["no such vertex"], std::out_of_range);
+  }
+
+  SECTION("full map throws") {
+    concurrent_index_map<int> map(4);
+    for (int i = 0; i < 16; ++i) {
+      map.insert(i, i);
+    }
+    REQUIRE_THROWS_AS(map.insert(16, 16), std::length_error);
+  }
+}
+
+TEST_CASE("build from string-keyed data", "[index_map]") {
+  std::vector<std::string>                          people = {"ann", "bob", "cy", "dee"};
+  std::vector<std::string>                          films  = {"alien", "brazil"};
+  std::vector<std::tuple<std::string, std::string>> knows  = {{"ann", "bob"}, {"bob", "cy"}, {"dee", "ann"}};
+  std::vector<std::tuple<std::string, std::string>> cast   = {{"ann", "alien"}, {"dee", "brazil"}, {"cy", "alien"}};
+
+  auto map = make_index_map(people);
+
+  SECTION("plain edges") {
+    auto edges = make_plain_edges(map, knows);
+    REQUIRE(edges == std::vector<std::tuple<size_t, size_t>>{{0, 1}, {1, 2}, {3, 0}});
+  }
+
+  SECTION("index edges") {
+    auto edges = make_index_edges(map, knows);
+    REQUIRE(edges == std::vector<std::tuple<size_t, size_t, size_t>>{{0, 1, 0}, {1, 2, 1}, {3, 0, 2}});
+  }
+
+  SECTION("bipartite edges") {
+    std::vector<std::string> left  = {"ann", "bob", "cy", "dee"};
+    auto                     edges = data_to_graph_edge_list(left, films, cast);
+    REQUIRE(edges == std::vector<std::tuple<size_t, size_t>>{{0, 0}, {3, 1}, {2, 0}});
+  }
+
+  SECTION("unknown vertices throw") {
+    std::vector<std::tuple<std::string, std::string>> stranger = {{"ann", "bob"}, {"eve", "cy"}};
+    REQUIRE_THROWS_AS(make_plain_edges(map, stranger), std::out_of_range);
+    REQUIRE_THROWS_AS(make_index_edges(map, stranger), std::out_of_range);
+    REQUIRE_THROWS_AS(data_to_graph_edge_list(people, films, knows), std::out_of_range);
+  }
+}
+
+TEST_CASE("build from keys without std::hash", "[index_map]") {
+  using key = std::tuple<int, int>;
+  std::vector<key>                  cells = {{0, 0}, {0, 1}, {1, 0}};
+  std::vector<std::tuple<key, key>> moves = {{{0, 0}, {0, 1}}, {{1, 0}, {0, 0}}};
+
+  auto map = make_index_map(cells);
+  static_assert(std::is_same_v<decltype(map), std::map<key, size_t>>);
+  REQUIRE(make_plain_edges(map, moves) == std::vector<std::tuple<size_t, size_t>>{{0, 1}, {2, 0}});
+
+  std::vector<std::tuple<key, key>> off_grid = {{{0, 0}, {2, 2}}};
+  REQUIRE_THROWS_AS(make_plain_edges(map, off_grid), std::out_of_range);
+}
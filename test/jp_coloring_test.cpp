@@ -19,10 +19,13 @@
 #include <iostream>
 #include <limits>
 #include <list>
+#include <random>
+#include <vector>
 
 #include "nwgraph/algorithms/jones_plassmann_coloring.hpp"
 #include "nwgraph/containers/aos.hpp"
 #include "nwgraph/containers/compressed.hpp"
+#include "nwgraph/edge_list.hpp"
 #include "nwgraph/io/mmio.hpp"
 #include "nwgraph/util/util.hpp"
 
@@ -33,23 +36,72 @@ using namespace nw::util;
 
 typedef adjacency<0> csr_graph;
 
+/// Whether every vertex has a color, and no two neighbors share one.
+template <class Graph>
+bool is_proper_coloring(const Graph& A, const std::vector<size_t>& colors, size_t num_colors) {
+  for (size_t u = 0; u < A.size(); ++u) {
+    if (colors[u] >= num_colors) {
+      return false;
+    }
+    for (auto&& [v] : A[u]) {
+      if (v != u && colors[v] == colors[u]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 TEST_CASE("Jones-Plassmann Coloring", "[jp]") {
 
   /* Read the edgelist */
   auto aos_a = read_mm<directedness::undirected>(DATA_DIR "coloringData.mmio");
 
-  swap_to_triangular<0>(aos_a, succession::predecessor);
-  sort_by<1>(aos_a);
-  stable_sort_by<0>(aos_a);
-
-  /* Construct the graph */
+  /* Construct the (symmetric) graph */
   adjacency<0> A(aos_a);
 
   size_t              N = A.size();
   std::vector<size_t> colors(N, std::numeric_limits<std::uint32_t>::max());
 
+  // The graph is a tree, which the largest-first order colors with two colors.
   std::vector<size_t> result = {0, 1, 1, 0, 0, 0, 0, 1};
   std::vector<size_t> result2 = {1, 0, 0, 1, 1, 1, 1, 0};
-  jones_plassmann_coloring(A, colors);
+  REQUIRE(jones_plassmann_coloring(A, colors, coloring_order::largest_first) == 2);
   REQUIRE((colors == result || colors == result2));
+
+  for (auto order : {coloring_order::random, coloring_order::smallest_last}) {
+    size_t num_colors = jones_plassmann_coloring(A, colors, order);
+    REQUIRE(is_proper_coloring(A, colors, num_colors));
+  }
+}
+
+TEST_CASE("parallel coloring", "[jp]") {
+  size_t                                n_vtx = 500;
+  std::mt19937                          gen(7);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1), dense(0, 39);
+
+  edge_list<directedness::undirected> E_list(n_vtx);
+  for (size_t i = 0; i < 4000; ++i) {
+    auto u = i % 4 ? any(gen) : dense(gen), v = i % 4 ? any(gen) : dense(gen);
+    if (u != v) {
+      E_list.push_back(u, v);
+    }
+  }
+  adjacency<0> A(E_list);
+
+  size_t max_degree = 0;
+  for (size_t u = 0; u < A.size(); ++u) {
+    max_degree = std::max<size_t>(max_degree, A[u].size());
+  }
+
+  std::vector<size_t> colors;
+  for (auto order : {coloring_order::random, coloring_order::largest_first, coloring_order::smallest_last}) {
+    size_t jp = jones_plassmann_coloring(A, colors, order, 3);
+    REQUIRE(is_proper_coloring(A, colors, jp));
+    REQUIRE(jp <= max_degree + 1);
+
+    size_t speculative = speculative_coloring(A, colors, order, 3);
+    REQUIRE(is_proper_coloring(A, colors, speculative));
+    REQUIRE(speculative <= max_degree + 1);
+  }
 }
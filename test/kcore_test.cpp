@@ -11,9 +11,10 @@
  *   Kevin Deweese
  *   liux238
  *
- * /
+ */
 
 #include <algorithm>
+#include <random>
 #include <vector>
 
 #include "nwgraph/adaptors/new_dfs_range.hpp"
@@ -161,3 +162,63 @@ TEST_CASE("disconnected", "[disconnected]") {
   REQUIRE(degree[7] == 3);
   REQUIRE(degree[8] == 3);
 }
+
+TEST_CASE("core numbers", "[k-core]") {
+  // A random graph with a dense part, so that core numbers run past the open buckets.
+  size_t                                n_vtx = 400;
+  std::mt19937                          gen(3);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1), dense(0, 149);
+
+  edge_list<directedness::undirected> E_list(n_vtx);
+  for (size_t i = 0; i < 12000; ++i) {
+    auto u = i % 2 ? dense(gen) : any(gen), v = i % 2 ? dense(gen) : any(gen);
+    if (u != v) {
+      E_list.push_back(u, v);
+    }
+  }
+  uniq(E_list);
+  adjacency<0> A(E_list);
+
+  auto core = core_numbers(A);
+  REQUIRE(core.size() == n_vtx);
+
+  // Sequential peeling, removing one vertex of minimum degree at a time.
+  std::vector<size_t> degree(n_vtx), expected(n_vtx);
+  std::vector<bool>   removed(n_vtx);
+  for (size_t u = 0; u < n_vtx; ++u) {
+    degree[u] = A[u].size();
+  }
+  for (size_t i = 0, k = 0; i < n_vtx; ++i) {
+    size_t u = n_vtx;
+    for (size_t v = 0; v < n_vtx; ++v) {
+      if (!removed[v] && (u == n_vtx || degree[v] < degree[u])) {
+        u = v;
+      }
+    }
+    k           = std::max(k, degree[u]);
+    expected[u] = k;
+    removed[u]  = true;
+    for (auto&& [v] : A[u]) {
+      --degree[v];
+    }
+  }
+  REQUIRE(*std::max_element(expected.begin(), expected.end()) > 64);
+  for (size_t u = 0; u < n_vtx; ++u) {
+    REQUIRE(core[u] == expected[u]);
+  }
+
+  // Every vertex of the k core has at least k neighbors in it.
+  size_t k = 40;
+  auto   K = k_core_subgraph(A, core, k);
+  REQUIRE(K.size() == n_vtx);
+  for (size_t u = 0; u < n_vtx; ++u) {
+    if (core[u] >= k) {
+      REQUIRE(K[u].size() >= k);
+    } else {
+      REQUIRE(K[u].size() == 0);
+    }
+    for (auto&& [v] : K[u]) {
+      REQUIRE(core[v] >= k);
+    }
+  }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file ktruss_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/k_truss.hpp"
+#include "nwgraph/build.hpp"
+#include "nwgraph/edge_list.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+TEST_CASE("truss decomposition", "[k-truss]") {
+  // A random graph with a denser part, stored once per edge as (u, v), u < v,
+  // in a directed edge list so that the adjacency keeps one orientation.
+  size_t                                n_vtx = 120;
+  std::mt19937                          gen(29);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1), dense(0, 29);
+
+  edge_list<directedness::directed> E_list(n_vtx);
+  for (size_t i = 0; i < 1500; ++i) {
+    auto u = i % 2 ? dense(gen) : any(gen), v = i % 2 ? dense(gen) : any(gen);
+    E_list.push_back(u, v);
+  }
+  simplify_triangular<0>(E_list, succession::successor);
+  adjacency<0> U(E_list);
+
+  auto truss = truss_numbers(U);
+  REQUIRE(truss.size() == U.num_edges());
+
+  // The edges of U, in order, and a brute force decomposition that removes
+  // the edges with too little support until every edge of the k truss has k - 2.
+  std::vector<std::tuple<size_t, size_t>> edges;
+  for (size_t u = 0; u < U.size(); ++u) {
+    for (auto&& [v] : U[u]) {
+      REQUIRE(u < v);
+      edges.emplace_back(u, v);
+    }
+  }
+
+  std::vector<size_t>         expected(edges.size(), 2);
+  std::set<std::tuple<size_t, size_t>> graph(edges.begin(), edges.end());
+  auto                        has = [&](size_t a, size_t b) { return graph.count({std::min(a, b), std::max(a, b)}) != 0; };
+  for (size_t k = 3; !graph.empty(); ++k) {
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (auto it = graph.begin(); it != graph.end();) {
+        auto [u, v]   = *it;
+        size_t common = 0;
+        for (size_t w = 0; w < n_vtx; ++w) {
+          common += w != u && w != v && has(u, w) && has(v, w);
+        }
+        if (common < k - 2) {
+          it      = graph.erase(it);
+          changed = true;
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (size_t e = 0; e < edges.size(); ++e) {
+      if (graph.count(edges[e])) {
+        expected[e] = k;
+      }
+    }
+  }
+
+  REQUIRE(*std::max_element(expected.begin(), expected.end()) > 4);
+  for (size_t e = 0; e < edges.size(); ++e) {
+    REQUIRE(truss[e] == expected[e]);
+  }
+
+  SECTION("k truss") {
+    size_t k = 4;
+    auto   T = k_truss(U, truss, k);
+    REQUIRE(T.num_edges() == size_t(std::count_if(expected.begin(), expected.end(), [k](auto t) { return t >= k; })));
+    for (size_t u = 0; u < T.size(); ++u) {
+      for (auto&& [v] : T[u]) {
+        auto e = std::find(edges.begin(), edges.end(), std::tuple<size_t, size_t>(u, v)) - edges.begin();
+        REQUIRE(expected[e] >= k);
+      }
+    }
+  }
+}
@@ -0,0 +1,205 @@
+/**
+ * @file mapped_graph_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/bfs.hpp"
+#include "nwgraph/algorithms/triangle_count.hpp"
+#include "nwgraph/edge_list.hpp"
+#include "nwgraph/io/mapped_graph.hpp"
+#include "nwgraph/io/mmio.hpp"
+#include "nwgraph/io/out_of_core_build.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+static_assert(adjacency_list_graph<mapped_adjacency<0>>);
+static_assert(adjacency_list_graph<mapped_adjacency<0, double>>);
+static_assert(degree_enumerable_graph<mapped_adjacency<1, double>>);
+static_assert(edge_list_graph<mapped_edge_list<directedness::directed, double>>);
+
+TEST_CASE("mapped adjacency", "[mapped]") {
+  auto E = read_mm<directedness::undirected, double>(DATA_DIR "USAir97.mtx");
+  adjacency<0, double> A(E);
+
+  std::string file = "mapped_adjacency_test.nwg";
+  write_mapped(file, A);
+
+  SECTION("view matches the adjacency it was written from") {
+    mapped_adjacency<0, double> B(file);
+    REQUIRE(B.size() == A.size());
+    REQUIRE_NOTHROW(B.validate());
+    REQUIRE(B.num_edges() == A.num_edges());
+    REQUIRE(num_vertices(B) == num_vertices(A));
+
+    for (size_t u = 0; u < A.size(); ++u) {
+      REQUIRE(degree(B, u) == A[u].size());
+      REQUIRE(std::equal(A[u].begin(), A[u].end(), B[u].begin(), B[u].end(), [](auto&& a, auto&& b) {
+        return std::get<0>(a) == std::get<0>(b) && std::get<1>(a) == std::get<1>(b);
+      }));
+    }
+  }
+
+  SECTION("copies share the mapping and run algorithms") {
+    auto B = mapped_adjacency<0, double>(file);
+    auto C = B;
+    REQUIRE(bfs(C, 0) == bfs(A, 0));
+  }
+
+  SECTION("mismatched views are rejected") {
+    REQUIRE_THROWS_AS((mapped_adjacency<1, double>(file)), std::runtime_error);
+    REQUIRE_THROWS_AS((mapped_adjacency<0>(file)), std::runtime_error);
+    REQUIRE_THROWS_AS((mapped_adjacency<0, float>(file)), std::runtime_error);
+    REQUIRE_THROWS_AS((mapped_edge_list<directedness::undirected, double>(file)), std::runtime_error);
+    REQUIRE_THROWS_AS((mapped_adjacency<0, std::uint64_t>(file)), std::runtime_error);
+    REQUIRE_THROWS_AS((mapped_adjacency<0, double>("no_such_file.nwg")), std::runtime_error);
+  }
+
+  SECTION("corrupt files are rejected") {
+    std::ifstream     in(file, std::ifstream::binary);
+    std::vector<char> bytes(std::istreambuf_iterator<char>(in), {});
+
+    // Write a copy of the file after corrupting its header or offsets; a middle offset is only caught by validate.
+    auto corrupt = [&](auto&& f, bool validate = false) {
+      auto copy    = bytes;
+      auto header  = reinterpret_cast<mapped_graph_header*>(copy.data());
+      auto offsets = reinterpret_cast<default_index_t*>(copy.data() + header->blocks[0].offset);
+      f(*header, offsets);
+      std::string   corrupt_file = "mapped_adjacency_corrupt.nwg";
+      std::ofstream out(corrupt_file, std::ofstream::binary);
+      out.write(copy.data(), copy.size());
+      out.close();
+      if (validate) {
+        mapped_adjacency<0, double> view(corrupt_file);
+        REQUIRE_THROWS_AS(view.validate(), std::runtime_error);
+        REQUIRE_THROWS_AS((mapped_adjacency<0, double>(corrupt_file, true)), std::runtime_error);
+      } else {
+        REQUIRE_THROWS_AS((mapped_adjacency<0, double>(corrupt_file)), std::runtime_error);
+      }
+      std::remove(corrupt_file.c_str());
+    };
+
+    corrupt([](auto& h, auto) { h.blocks[1].count = ~uint64_t(0) / 2; });
+    corrupt([](auto& h, auto) { h.blocks[2].element_size = 0; });
+    corrupt([](auto&, auto offsets) { std::swap(offsets[3], offsets[5]); }, true);
+    corrupt([&](auto&, auto offsets) { offsets[A.size()] -= 1; });
+  }
+
+  std::remove(file.c_str());
+}
+
+TEST_CASE("mapped edge list", "[mapped]") {
+  auto E = read_mm<directedness::directed, double>(DATA_DIR "USAir97.mtx");
+
+  std::string file = "mapped_edge_list_test.nwg";
+  write_mapped(file, E);
+
+  mapped_edge_list<directedness::directed, double> F(file);
+  REQUIRE(F.size() == E.size());
+  REQUIRE(num_vertices(F) == E.num_vertices()[0]);
+
+  size_t i = 0;
+  for (auto&& e : F) {
+    REQUIRE(source(F, e) == std::get<0>(E[i]));
+    REQUIRE(target(F, e) == std::get<1>(E[i]));
+    REQUIRE(std::get<2>(e) == std::get<2>(E[i]));
+    ++i;
+  }
+  REQUIRE(i == E.size());
+
+  REQUIRE_THROWS_AS((mapped_edge_list<directedness::undirected, double>(file)), std::runtime_error);
+  std::remove(file.c_str());
+}
+
+TEST_CASE("mapped triangle count", "[mapped]") {
+  auto E = read_mm<directedness::undirected>(DATA_DIR "karate.mtx");
+  swap_to_triangular<0>(E, succession::successor);
+  sort_by<1>(E);
+  stable_sort_by<0>(E);
+  adjacency<0> A(E);
+
+  std::string file = "mapped_tc_test.nwg";
+  write_mapped(file, A);
+  mapped_adjacency<0> B(file);
+  REQUIRE(triangle_count(B) == triangle_count(A));
+  std::remove(file.c_str());
+}
+
+static std::string slurp(const std::string& file) {
+  std::ifstream in(file, std::ifstream::binary);
+  return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+}
+
+TEST_CASE("out of core build", "[mapped]") {
+  std::string expected = "out_of_core_expected.nwg", built = "out_of_core_built.nwg";
+
+  SECTION("symmetric file read as directed, spilled to many runs") {
+    auto                 E = read_mm<directedness::directed, double>(DATA_DIR "USAir97.mtx");
+    adjacency<0, double> A(E);
+    write_mapped(expected, A);
+    out_of_core_build<0, directedness::directed, double>(DATA_DIR "USAir97.mtx", built, 4096, ".");
+    REQUIRE(slurp(built) == slurp(expected));
+  }
+
+  SECTION("undirected, in memory") {
+    auto                 E = read_mm<directedness::undirected, double>(DATA_DIR "USAir97.mtx");
+    adjacency<1, double> A(E);
+    write_mapped(expected, A);
+    out_of_core_build<1, directedness::undirected, double>(DATA_DIR "USAir97.mtx", built);
+    REQUIRE(slurp(built) == slurp(expected));
+
+    mapped_adjacency<1, double> B(built);
+    REQUIRE(B.num_edges() == A.num_edges());
+  }
+
+  SECTION("from a mapped edge list") {
+    auto E = read_mm<directedness::undirected>(DATA_DIR "karate.mtx");
+    write_mapped("out_of_core_edges.nwg", E);
+    adjacency<0> A(E);
+    write_mapped(expected, A);
+    out_of_core_build<0, directedness::undirected>("out_of_core_edges.nwg", built, 1024, ".");
+    REQUIRE(slurp(built) == slurp(expected));
+    std::remove("out_of_core_edges.nwg");
+  }
+
+  SECTION("ids that do not fit are rejected, and nothing is left behind") {
+    auto dir = std::filesystem::temp_directory_path() / "out_of_core_test";
+    std::filesystem::create_directories(dir);
+    auto bad = (dir / "too_wide.mtx").string();
+    {
+      std::ofstream out(bad);
+      out << "%%MatrixMarket matrix coordinate pattern general\n5000000000 5000000000 1101\n";
+      for (int i = 1; i <= 1100; ++i) {
+        out << i << " " << i % 7 + 1 << "\n";
+      }
+      out << "5000000000 1\n";
+    }
+    // A small memory bound spills runs before the bad line is reached.
+    REQUIRE_THROWS_AS((out_of_core_build<0>(bad, built, 1024, dir.string())), std::runtime_error);
+    REQUIRE(std::distance(std::filesystem::directory_iterator(dir), std::filesystem::directory_iterator()) == 1);
+    REQUIRE(!std::filesystem::exists(built));
+    std::filesystem::remove_all(dir);
+  }
+
+  std::remove(expected.c_str());
+  std::remove(built.c_str());
+}
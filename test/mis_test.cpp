@@ -17,6 +17,12 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
 
 #include "nwgraph/graph_traits.hpp"
 
@@ -24,6 +30,7 @@
 #include "nwgraph/algorithms/maximal_independent_set.hpp"
 #include "nwgraph/containers/aos.hpp"
 #include "nwgraph/containers/compressed.hpp"
+#include "nwgraph/edge_list.hpp"
 #include "nwgraph/io/mmio.hpp"
 #include "nwgraph/util/util.hpp"
 
@@ -69,3 +76,74 @@ TEST_CASE("Maximal independent set", "[mis]") {
   CHECK_FALSE(mis2 == result);
   CHECK(mis2 == result2);
 }
+
+TEST_CASE("Luby maximal independent set", "[mis]") {
+  size_t                                n_vtx = 2000;
+  std::mt19937                          gen(13);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1);
+
+  edge_list<directedness::undirected> E_list(n_vtx);
+  for (size_t i = 0; i < 10000; ++i) {
+    if (auto u = any(gen), v = any(gen); u != v) {
+      E_list.push_back(u, v);
+    }
+  }
+  adjacency<0> A(E_list);
+
+  for (std::uint64_t seed : {0, 1, 2}) {
+    auto mis = luby_mis(A, seed);
+    REQUIRE(std::is_sorted(mis.begin(), mis.end()));
+
+    // Independent, and maximal: every other vertex has a neighbor in the set.
+    std::vector<bool> in(n_vtx);
+    for (auto u : mis) {
+      in[u] = true;
+    }
+    for (size_t u = 0; u < n_vtx; ++u) {
+      bool covered = in[u];
+      for (auto&& [v] : A[u]) {
+        REQUIRE(!(in[u] && in[v]));
+        covered = covered || in[v];
+      }
+      REQUIRE(covered);
+    }
+  }
+  REQUIRE(luby_mis(A, 5) == luby_mis(A, 5));
+}
+
+TEST_CASE("DAG-based maximal independent set", "[mis]") {
+  size_t                                n_vtx = 3000;
+  std::mt19937                          gen(31);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1);
+
+  edge_list<directedness::undirected> E_list(n_vtx);
+  for (size_t i = 0; i < 12000; ++i) {
+    if (auto u = any(gen), v = any(gen); u != v) {
+      E_list.push_back(u, v);
+    }
+  }
+  adjacency<0> A(E_list);
+
+  // The greedy sweep in order of decreasing degree, ties by increasing id.
+  std::vector<size_t> order(n_vtx);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](auto u, auto v) { return A[u].size() > A[v].size(); });
+  std::vector<bool> expected(n_vtx), removed(n_vtx);
+  for (auto u : order) {
+    if (!removed[u]) {
+      expected[u] = true;
+      for (auto&& [v] : A[u]) {
+        removed[v] = true;
+      }
+    }
+  }
+
+  // Four threads even on a smaller machine, so the rounds race.
+  tbb::global_control threads(tbb::global_control::max_allowed_parallelism, 4);
+  tbb::task_arena     arena(4);
+  arena.execute([&] {
+    std::vector<bool> mis(n_vtx, true);
+    dag_based_mis(A, mis);
+    REQUIRE(mis == expected);
+  });
+}
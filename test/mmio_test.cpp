@@ -14,6 +14,9 @@
  */
 
 
+#include <filesystem>
+#include <stdexcept>
+
 #include "nwgraph/containers/compressed.hpp"
 
 #include "common/test_header.hpp"
@@ -63,6 +66,93 @@ TEST_CASE("constructing graphs using mmio-testing with auto", "[mmio]") {
   }
 }
 
+template <directedness sym, typename... Attributes>
+void check_against_stream(const std::string& filename) {
+  std::ifstream                 in(filename);
+  edge_list<sym, Attributes...> expected = read_mm<sym, Attributes...>(in);
+  edge_list<sym, Attributes...> actual   = read_mm<sym, Attributes...>(filename);
+
+  REQUIRE(num_vertices(actual) == num_vertices(expected));
+  REQUIRE(actual.size() == expected.size());
+
+  // The stream reader interleaves mirrored entries, the mmap reader appends them
+  auto a = std::vector<typename edge_list<sym, Attributes...>::element>(actual.begin(), actual.end());
+  auto b = std::vector<typename edge_list<sym, Attributes...>::element>(expected.begin(), expected.end());
+  std::sort(a.begin(), a.end());
+  std::sort(b.begin(), b.end());
+  REQUIRE(a == b);
+}
+
+TEST_CASE("mmap-ed parallel reader matches stream reader", "[mmio]") {
+  for (auto&& file : {"karate.mtx", "USAir97.mtx", "tree.mmio", "spmatA.mmio", "bktest1.mtx", "G1.mtx"}) {
+    auto filename = std::string(DATA_DIR) + file;
+    check_against_stream<directedness::undirected>(filename);
+    check_against_stream<directedness::directed>(filename);
+    check_against_stream<directedness::undirected, double>(filename);
+    check_against_stream<directedness::directed, double>(filename);
+  }
+}
+
+TEST_CASE("mmap-ed parallel reader splits large files at line boundaries", "[mmio]") {
+  std::string filename = (std::filesystem::temp_directory_path() / "nwgraph_mmio_test_large.mtx").string();
+  {
+    std::ofstream out(filename);
+    out << "%%MatrixMarket matrix coordinate real general\n% generated\n5000 5000 300000\n";
+    for (size_t i = 0; i < 300000; ++i) {
+      out << (i * 7919) % 5000 + 1 << " " << (i * 104729) % 5000 + 1 << " " << i * 0.5;
+      if (i + 1 != 300000) {
+        out << "\n";
+      }
+    }
+  }
+  tbb::task_arena arena(4);
+  arena.execute([&] { check_against_stream<directedness::directed, double>(filename); });
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("mmap-ed reader rejects files it cannot read", "[mmio]") {
+  REQUIRE_THROWS_AS((read_mm<directedness::directed>(std::string(DATA_DIR) + "no_such_file.mtx")), std::runtime_error);
+
+  std::string filename = (std::filesystem::temp_directory_path() / "nwgraph_mmio_test_rejected.mtx").string();
+  for (auto&& header : {"not a banner\n3 3 1\n1 2\n", "%%MatrixMarket matrix coordinate real skew-symmetric\n3 3 1\n2 1 1.5\n",
+                        "%%MatrixMarket matrix coordinate complex hermitian\n3 3 1\n2 1 1.5 2.5\n",
+                        "%%MatrixMarket matrix coordinate complex general\n3 3 1\n2 1 1.5 2.5\n",
+                        "%%MatrixMarket matrix coordinate pattern general\n% no size line\n"}) {
+    {
+      std::ofstream out(filename);
+      out << header;
+    }
+    REQUIRE_THROWS_AS((read_mm<directedness::directed>(filename)), std::runtime_error);
+  }
+  std::remove(filename.c_str());
+}
+
+TEST_CASE("mmap-ed reader keeps values that underflow", "[mmio]") {
+  std::string filename = (std::filesystem::temp_directory_path() / "nwgraph_mmio_test_underflow.mtx").string();
+  {
+    std::ofstream out(filename);
+    out << "%%MatrixMarket matrix coordinate real general\n3 3 3\n1 2 1e-310\n2 3 -1e-400\n3 1 2.5\n";
+  }
+  auto A = read_mm<directedness::directed, double>(filename);
+  auto B = read_mm<directedness::directed, float>(filename);
+  std::remove(filename.c_str());
+
+  REQUIRE(A.size() == 3);
+  REQUIRE(std::get<2>(A[0]) == 1e-310);
+  REQUIRE(std::get<2>(A[1]) == 0.0);
+  REQUIRE(std::get<2>(A[2]) == 2.5);
+  REQUIRE(B.size() == 3);
+  REQUIRE(std::get<2>(B[0]) == 0.0f);
+  REQUIRE(std::get<2>(B[2]) == 2.5f);
+
+  {
+    std::ofstream out(filename);
+    out << "%%MatrixMarket matrix coordinate real general\n3 3 1\n2 1 1e400\n";
+  }
+  REQUIRE_THROWS_AS((read_mm<directedness::directed, double>(filename)), std::runtime_error);
+  std::remove(filename.c_str());
+}
+
 #if 0
 TEST_CASE("constructing graphs using par_mmio", "[parmmio]") {
 
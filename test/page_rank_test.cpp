@@ -101,6 +101,24 @@ TEST_CASE("PageRank") {
       REQUIRE(page_rank[idx] == Approx(answer[idx]).epsilon(tolerance));
     }
   }
+  SECTION("page_rank on two threads") {
+    adjacency<1, RealT> graph(A);
+    std::vector<RealT>  page_rank(graph.size());
+
+    std::vector<default_vertex_id_type> degrees(graph.size());
+    tbb::parallel_for(edge_range(graph), [&](auto&& edges) {
+      for (auto&& [i, j] : edges) {
+        __atomic_fetch_add(&degrees[j], 1, __ATOMIC_ACQ_REL);
+      }
+    });
+
+    nw::graph::page_rank(graph, degrees, page_rank, 0.85, 1.e-7, 100, 2);
+
+    REQUIRE(answer.size() == page_rank.size());
+    for (size_t idx = 0; idx < page_rank.size(); ++idx) {
+      REQUIRE(page_rank[idx] == Approx(answer[idx]).epsilon(0.005));
+    }
+  }
   SECTION("adj_list") {
     adj_list<0, RealT> graph(A);
     //std::cout << "Number vertices: " << graph.size() << std::endl;
@@ -129,3 +147,58 @@ TEST_CASE("PageRank") {
     }
   }
 }
+
+TEST_CASE("PageRank engine", "[pr]") {
+  edge_list<directedness::directed, double> A(0);
+  build_karate_edge_list(A);
+
+  std::vector<double> answer = {0.0972041, 0.0529611, 0.0570794,  0.0358651, 0.0220110, 0.0291618, 0.0291618, 0.0244569, 0.0297064,
+                                0.0142740, 0.0220110, 0.00955609, 0.0146330, 0.0294733, 0.0144766, 0.0144766, 0.0168304, 0.0145342,
+                                0.0144766, 0.0195506, 0.0144766,  0.0145342, 0.0144766, 0.0314621, 0.0210849, 0.0210187, 0.0150202,
+                                0.0256012, 0.0195538, 0.0262432,  0.0245261, 0.0370686, 0.0718675, 0.101166};
+
+  adjacency<0, double> out(A);
+  adjacency<1, double> in(A);
+
+  SECTION("pull, float") {
+    std::vector<float> rank(in.size());
+    REQUIRE(page_rank_pull(in, rank, 0.85, 1.e-7) < 100);
+    for (size_t v = 0; v < rank.size(); ++v) {
+      REQUIRE(rank[v] == Approx(answer[v]).epsilon(0.005));
+    }
+  }
+
+  SECTION("delta, double") {
+    std::vector<double> rank(in.size());
+    REQUIRE(page_rank_delta<double>(out, in, rank, 0.85, 1.e-7) < 100);
+    for (size_t v = 0; v < rank.size(); ++v) {
+      REQUIRE(rank[v] == Approx(answer[v]).epsilon(0.005));
+    }
+  }
+
+  SECTION("personalized, with a dangling vertex") {
+    edge_list<directedness::directed> B(0);
+    B.open_for_push_back();
+    for (auto&& [u, v, w] : A) {
+      if (u != 33) {
+        B.push_back(u, v);
+      }
+    }
+    B.close_for_push_back();
+    adjacency<0> out_b(B);
+    adjacency<1> in_b(B);
+    REQUIRE(out_b.size() == 34);
+
+    std::vector<double> teleport(34, 0.0);
+    teleport[0] = teleport[33] = 0.5;
+
+    std::vector<double> pull(34), delta(34);
+    page_rank_pull<double>(in_b, pull, 0.85, 1.e-10, 1000, teleport);
+    page_rank_delta<double>(out_b, in_b, delta, 0.85, 1.e-10, 1000, teleport);
+
+    REQUIRE(std::accumulate(pull.begin(), pull.end(), 0.0) == Approx(1.0));
+    for (size_t v = 0; v < 34; ++v) {
+      REQUIRE(delta[v] == Approx(pull[v]).epsilon(1.e-6));
+    }
+  }
+}
@@ -0,0 +1,102 @@
+/**
+ * @file projection_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/projection.hpp"
+#include "nwgraph/build.hpp"
+#include "nwgraph/edge_list.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+TEST_CASE("bipartite projection", "[projection]") {
+  // Random hyperedges (left) over nodes (right), with duplicate incidences removed.
+  constexpr size_t                      N0 = 300, N1 = 60;
+  std::mt19937                          gen(17);
+  std::uniform_int_distribution<size_t> left(0, N0 - 1), right(0, N1 - 1);
+  std::set<std::tuple<size_t, size_t>>  incidences;
+  while (incidences.size() < 1500) {
+    incidences.emplace(left(gen), right(gen));
+  }
+
+  bi_edge_list<directedness::directed> E(N0, N1);
+  for (auto&& [u, v] : incidences) {
+    E.push_back(u, v);
+  }
+  E.close_for_push_back();
+  biadjacency<0> G(E);
+  biadjacency<1> H(E);
+
+  // Brute force overlaps between distinct hyperedges, and the smallest shared node.
+  std::vector<std::set<size_t>> nodes(N0);
+  for (auto&& [u, v] : incidences) {
+    nodes[u].insert(v);
+  }
+  std::map<std::tuple<size_t, size_t>, size_t> overlap;
+  for (size_t u = 0; u < N0; ++u) {
+    for (size_t w = 0; w < N0; ++w) {
+      size_t k = 0;
+      for (auto v : nodes[u]) {
+        k += nodes[w].count(v);
+      }
+      if (u != w && k) {
+        overlap[{u, w}] = k;
+      }
+    }
+  }
+
+  for (size_t s : {1, 2, 3}) {
+    auto L = s_line_graph(G, H, s);
+    REQUIRE(L.size() == N0);
+
+    size_t m = 0;
+    for (size_t u = 0; u < L.size(); ++u) {
+      std::vector<size_t> row;
+      for (auto&& [w, k] : L[u]) {
+        row.push_back(w);
+        REQUIRE(overlap.at({u, w}) == k);
+        REQUIRE(k >= s);
+        ++m;
+      }
+      REQUIRE(std::is_sorted(row.begin(), row.end()));
+    }
+    REQUIRE(m == size_t(std::count_if(overlap.begin(), overlap.end(), [s](auto&& e) { return e.second >= s; })));
+  }
+
+  SECTION("structure only") {
+    auto L = bipartite_projection<projection_value::none>(G, H, 2);
+    auto W = s_line_graph(G, H, 2);
+    REQUIRE(L.num_edges() == W.num_edges());
+  }
+
+  SECTION("witnesses") {
+    auto L = bipartite_projection<projection_value::witness>(G, H);
+    REQUIRE(L.num_edges() == overlap.size());
+    for (size_t u = 0; u < L.size(); ++u) {
+      for (auto&& [w, v] : L[u]) {
+        REQUIRE(nodes[u].count(v));
+        REQUIRE(nodes[w].count(v));
+      }
+    }
+  }
+}
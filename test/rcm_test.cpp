@@ -13,21 +13,36 @@
  *
  */
 
+#include <algorithm>
 #include <execution>
 #include <iostream>
 #include <unordered_set>
 
+#include "nwgraph/adjacency.hpp"
 #include "nwgraph/algorithms/triangle_count.hpp"
+#include "nwgraph/build.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/io/mmio.hpp"
-#include "rcm.hpp"
+#include "nwgraph/reorder.hpp"
 
 #include "common/test_header.hpp"
 
 using namespace nw::graph;
 using namespace nw::util;
 
+template <class Graph>
+static size_t bandwidth(const Graph& A) {
+  size_t b = 0;
+  for (size_t u = 0; u < A.size(); ++u) {
+    for (auto&& e : A[u]) {
+      size_t v = std::get<0>(e);
+      b        = std::max(b, u < v ? v - u : u - v);
+    }
+  }
+  return b;
+}
+
 TEST_CASE("Reverse Cuthill-Mckee Ordering", "[rcm]") {
   edge_list<directedness::directed> el(10);
   el.push_back(0, 1);
@@ -61,9 +76,63 @@ TEST_CASE("Reverse Cuthill-Mckee Ordering", "[rcm]") {
   el.push_back(9, 4);
   el.push_back(9, 7);
 
-  el.lexical_sort_by<0>();
-  auto perm = rcm(el);
-  REQUIRE(perm[0] == 8);
+  lexical_sort_by<0>(el);
+  adjacency<0> A(el);
+  auto         perm = rcm(A);
+
+  // Vertex 0 is already pseudo-peripheral (5 is three hops away), so the search
+  // starts there, and it is last in the reversed order.
+  REQUIRE(perm.back() == 0);
+
+  relabel(el, perm);
+  lexical_sort_by<0>(el);
+  adjacency<0> B(el);
+  REQUIRE(bandwidth(B) < bandwidth(A));
+}
+
+TEST_CASE("vertex orderings", "[rcm]") {
+  auto                 E = read_mm<directedness::undirected, double>(DATA_DIR "USAir97.mtx");
+  adjacency<0, double> A(E);
+
+  auto check = [&](const std::vector<default_vertex_id_type>& perm) {
+    REQUIRE(perm.size() == A.size());
+    std::vector<bool> seen(perm.size());
+    for (auto u : perm) {
+      REQUIRE(!seen[u]);
+      seen[u] = true;
+    }
+
+    // Permuting the adjacency matches building it from the relabeled edges.
+    auto B = permute_vertices(A, perm);
+    auto F = E;
+    relabel(F, perm);
+    adjacency<0, double> C(F);
+    REQUIRE(B.num_edges() == C.num_edges());
+    for (size_t u = 0; u < B.size(); ++u) {
+      std::vector<std::tuple<size_t, double>> b, c;
+      for (auto&& [v, w] : B[u]) {
+        b.emplace_back(v, w);
+      }
+      for (auto&& [v, w] : C[u]) {
+        c.emplace_back(v, w);
+      }
+      REQUIRE(std::is_sorted(b.begin(), b.end()));
+      std::sort(c.begin(), c.end());
+      REQUIRE(b == c);
+    }
+    return B;
+  };
 
-  el.relabel(perm);
+  SECTION("rcm") {
+    auto B = check(rcm(A));
+    REQUIRE(bandwidth(B) < bandwidth(A));
+  }
+  SECTION("degree based grouping") { check(degree_based_grouping(A)); }
+  SECTION("hub cluster") {
+    auto perm = hub_cluster(A);
+    check(perm);
+    REQUIRE(degree(A, perm.front()) > degree(A, perm.back()));
+  }
+  SECTION("gorder") { check(gorder(A)); }
+  SECTION("rabbit order") { check(rabbit_order(A)); }
 }
@@ -0,0 +1,142 @@
+/**
+ * @file similarity_test.cpp
+ *
+ * @copyright SPDX-FileCopyrightText: 2022 Battelle Memorial Institute
+ * @copyright SPDX-FileCopyrightText: 2022 University of Washington
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ *
+ * @authors
+ *   Andrew Lumsdaine
+ *   Luke D'Alessandro
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "nwgraph/adjacency.hpp"
+#include "nwgraph/algorithms/jaccard.hpp"
+#include "nwgraph/algorithms/similarity.hpp"
+#include "nwgraph/build.hpp"
+#include "nwgraph/edge_list.hpp"
+
+#include "common/test_header.hpp"
+
+using namespace nw::graph;
+using namespace nw::util;
+
+TEST_CASE("similarity", "[similarity]") {
+  // A random simple graph, with both directions of every edge.
+  size_t                                n_vtx = 150;
+  std::mt19937                          gen(41);
+  std::uniform_int_distribution<size_t> any(0, n_vtx - 1), hub(0, 4);
+
+  edge_list<directedness::directed> E_list(n_vtx);
+  for (size_t i = 0; i < 900; ++i) {
+    auto u = i % 3 ? any(gen) : hub(gen), v = any(gen);
+    E_list.push_back(u, v);
+  }
+  simplify_symmetric<0>(E_list);
+  adjacency<0> A(E_list);
+
+  std::vector<std::set<size_t>> N(n_vtx);
+  for (size_t u = 0; u < A.size(); ++u) {
+    for (auto&& [v] : A[u]) {
+      N[u].insert(v);
+    }
+  }
+  REQUIRE(N[1].count(1) == 0);
+
+  auto common = [&](size_t u, size_t v) {
+    double c = 0, aa = 0;
+    for (auto w : N[u]) {
+      if (N[v].count(w)) {
+        c += 1;
+        aa += 1 / std::log(double(N[w].size()));
+      }
+    }
+    return std::tuple(c, aa);
+  };
+  auto expected = [&](similarity_measure m, size_t u, size_t v) {
+    auto [c, aa] = common(u, v);
+    double du = N[u].size(), dv = N[v].size();
+    switch (m) {
+      case similarity_measure::jaccard:
+        return c / (du + dv - c);
+      case similarity_measure::cosine:
+        return c / std::sqrt(du * dv);
+      case similarity_measure::overlap:
+        return c / std::min(du, dv);
+      default:
+        return aa;
+    }
+  };
+
+  SECTION("edges") {
+    auto jaccard = edge_similarity<similarity_measure::jaccard>(A);
+    auto cosine  = edge_similarity<similarity_measure::cosine>(A);
+    auto overlap = edge_similarity<similarity_measure::overlap>(A);
+    auto aa      = edge_similarity<similarity_measure::adamic_adar>(A);
+    REQUIRE(jaccard.size() == A.num_edges());
+
+    size_t e = 0;
+    for (size_t u = 0; u < A.size(); ++u) {
+      for (auto&& [v] : A[u]) {
+        REQUIRE(jaccard[e] == Approx(expected(similarity_measure::jaccard, u, v)));
+        REQUIRE(cosine[e] == Approx(expected(similarity_measure::cosine, u, v)));
+        REQUIRE(overlap[e] == Approx(expected(similarity_measure::overlap, u, v)));
+        REQUIRE(aa[e] == Approx(expected(similarity_measure::adamic_adar, u, v)));
+        ++e;
+      }
+    }
+  }
+
+  SECTION("jaccard_similarity writes the upper triangle") {
+    edge_list<directedness::directed, double> E_weighted(n_vtx);
+    for (auto&& [u, v] : E_list) {
+      E_weighted.push_back(u, v, 0.0);
+    }
+    adjacency<0, double> W(E_weighted);
+    size_t scored = jaccard_similarity(W, [](auto&& e) -> auto& { return std::get<1>(e); });
+    REQUIRE(scored * 2 == W.num_edges());
+    for (size_t u = 0; u < W.size(); ++u) {
+      for (auto&& [v, w] : W[u]) {
+        if (u < v) {
+          REQUIRE(w == Approx(expected(similarity_measure::jaccard, u, v)));
+        }
+      }
+    }
+  }
+
+  SECTION("top k") {
+    size_t k = 5;
+    for (auto m : {similarity_measure::jaccard, similarity_measure::adamic_adar}) {
+      auto T = m == similarity_measure::jaccard ? top_k_similar<similarity_measure::jaccard>(A, k)
+                                                : top_k_similar<similarity_measure::adamic_adar>(A, k);
+      for (size_t u = 0; u < n_vtx; ++u) {
+        // All the candidates two hops away, best first.
+        std::vector<std::tuple<double, size_t>> all;
+        for (size_t w = 0; w < n_vtx; ++w) {
+          if (w != u && !N[u].count(w) && std::get<0>(common(u, w)) > 0) {
+            all.emplace_back(-expected(m, u, w), w);
+          }
+        }
+        std::sort(all.begin(), all.end());
+        all.resize(std::min(all.size(), k));
+
+        REQUIRE(size_t(T[u].size()) == all.size());
+        size_t i = 0;
+        for (auto&& [w, s] : T[u]) {
+          REQUIRE(s == Approx(-std::get<0>(all[i])));
+          REQUIRE(!N[u].count(w));
+          ++i;
+        }
+      }
+    }
+  }
+}
@@ -12,6 +12,9 @@
  */
 
 
+#include <algorithm>
+#include <map>
+#include <random>
 #include <tuple>
 #include <vector>
 
@@ -58,3 +61,143 @@ TEST_CASE("Row times Row", "[row-row") {
 
   REQUIRE(std::equal(begin(d), end(d), begin(nw::graph::make_edge_range<0>(C))));
 }
+
+TEST_CASE("Gustavson SpGEMM", "[spgemm]") {
+  // Random sparse matrices, dense enough that some rows use the dense
+  // accumulator and sparse enough that others hash.
+  using SparseMatrix = std::vector<std::vector<std::tuple<int, double>>>;
+
+  auto random_matrix = [](size_t m, size_t n, size_t nnz, unsigned seed) {
+    std::mt19937                          gen(seed);
+    std::uniform_int_distribution<size_t> row(0, m - 1), col(0, n - 1);
+    std::uniform_int_distribution<int>    val(1, 9);
+    std::vector<std::map<int, double>>    entries(m);
+    for (size_t k = 0; k < nnz; ++k) {
+      entries[row(gen) % (k % 7 == 0 ? 4 : m)][col(gen)] = val(gen);
+    }
+    SparseMatrix A(m);
+    for (size_t i = 0; i < m; ++i) {
+      A[i].assign(entries[i].begin(), entries[i].end());
+    }
+    return A;
+  };
+
+  auto dense = [](const SparseMatrix& A, size_t n) {
+    std::vector<std::vector<double>> D(A.size(), std::vector<double>(n));
+    for (size_t i = 0; i < A.size(); ++i) {
+      for (auto&& [j, v] : A[i]) {
+        D[i][j] = v;
+      }
+    }
+    return D;
+  };
+
+  constexpr size_t M = 200, K = 150, N = 400;
+  auto             A = random_matrix(M, K, 1200, 5);
+  auto             B = random_matrix(K, N, 900, 6);
+  auto             DA = dense(A, K), DB = dense(B, N);
+
+  std::vector<std::vector<double>> DC(M, std::vector<double>(N));
+  std::vector<std::vector<bool>>   SC(M, std::vector<bool>(N));
+  for (size_t i = 0; i < M; ++i) {
+    for (size_t k = 0; k < K; ++k) {
+      for (size_t j = 0; j < N; ++j) {
+        DC[i][j] += DA[i][k] * DB[k][j];
+        SC[i][j] = SC[i][j] || (DA[i][k] != 0 && DB[k][j] != 0);
+      }
+    }
+  }
+
+  SECTION("plus times") {
+    auto   C   = nw::graph::spgemm<nw::graph::plus_times<double>>(A, B);
+    size_t nnz = 0;
+    for (size_t i = 0; i < M; ++i) {
+      int last = -1;
+      for (auto&& [j, v] : C[i]) {
+        REQUIRE(int(j) > last);
+        REQUIRE(SC[i][j]);
+        REQUIRE(v == DC[i][j]);
+        last = j;
+        ++nnz;
+      }
+    }
+    size_t expected = 0;
+    for (auto&& row : SC) {
+      expected += std::count(row.begin(), row.end(), true);
+    }
+    REQUIRE(nnz == expected);
+  }
+
+  SECTION("masked") {
+    auto mask = random_matrix(M, N, 3000, 7);
+    auto C    = nw::graph::spgemm<nw::graph::plus_times<double>>(A, B, mask);
+    for (size_t i = 0; i < M; ++i) {
+      std::vector<int> expected;
+      for (auto&& [j, _] : mask[i]) {
+        if (SC[i][j]) {
+          expected.push_back(j);
+        }
+      }
+      std::vector<int> found;
+      for (auto&& [j, v] : C[i]) {
+        found.push_back(j);
+        REQUIRE(v == DC[i][j]);
+      }
+      REQUIRE(found == expected);
+    }
+  }
+
+  SECTION("edge list interfaces") {
+    auto C = nw::graph::spMatspMat<double>(A, B);
+    REQUIRE(C.size() == nw::graph::spgemm<nw::graph::plus_times<double>>(A, B).num_edges());
+    for (auto&& [i, j, v] : C) {
+      REQUIRE(v == DC[i][j]);
+    }
+
+    // A * A' is symmetric, with the row dot products on the diagonal.
+    auto T = nw::graph::spMatspMatT<double>(A, A);
+    for (auto&& [i, j, v] : T) {
+      double dot = 0;
+      for (size_t k = 0; k < K; ++k) {
+        dot += DA[i][k] * DA[j][k];
+      }
+      REQUIRE(v == dot);
+    }
+  }
+}
+
+TEST_CASE("masked triangle counting", "[spgemm]") {
+  // The strictly lower triangle of a random graph, without values.
+  std::mt19937                                   gen(11);
+  std::uniform_int_distribution<size_t>          vertex(0, 99);
+  std::vector<std::vector<std::tuple<size_t>>>   L(100);
+  std::vector<std::vector<bool>>                 adj(100, std::vector<bool>(100));
+  for (size_t k = 0; k < 800; ++k) {
+    auto u = vertex(gen), v = vertex(gen);
+    if (u != v && !adj[u][v]) {
+      adj[u][v] = adj[v][u] = true;
+      L[std::max(u, v)].emplace_back(std::min(u, v));
+    }
+  }
+  for (auto&& row : L) {
+    std::sort(row.begin(), row.end());
+  }
+
+  size_t expected = 0;
+  for (size_t u = 0; u < 100; ++u) {
+    for (size_t v = 0; v < u; ++v) {
+      for (size_t w = 0; w < v; ++w) {
+        expected += adj[u][v] && adj[v][w] && adj[u][w];
+      }
+    }
+  }
+
+  auto   C         = nw::graph::spgemm<nw::graph::plus_pair<size_t>>(L, L, L);
+  size_t triangles = 0;
+  for (size_t u = 0; u < C.size(); ++u) {
+    for (auto&& [v, k] : C[u]) {
+      triangles += k;
+    }
+  }
+  REQUIRE(triangles == expected);
+}
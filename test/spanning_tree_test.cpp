@@ -51,4 +51,27 @@ TEST_CASE("max/min weight spanning tree", "[mst]") {
 
     REQUIRE(totalweight == 59);
   }
+
+  SECTION("parallel min weight") {
+    edge_list<directedness::undirected, double> T_list = parallel_kruskal(A_list);
+
+    double totalweight = 0.0;
+    for (auto y : T_list) {
+      totalweight += std::get<2>(y);
+    }
+
+    REQUIRE(totalweight == 39);
+  }
+
+  SECTION("parallel max weight") {
+    auto                                        compare = [](auto t1, auto t2) { return std::get<2>(t1) > std::get<2>(t2); };
+    edge_list<directedness::undirected, double> T_list  = parallel_kruskal(A_list, compare);
+
+    double totalweight = 0.0;
+    for (auto y : T_list) {
+      totalweight += std::get<2>(y);
+    }
+
+    REQUIRE(totalweight == 59);
+  }
 }
@@ -14,13 +14,16 @@
  */
 
 #include <iostream>
+#include <numeric>
 #include <queue>
+#include <random>
 
 #include "nwgraph/algorithms/triangle_count.hpp"
 #include "nwgraph/containers/compressed.hpp"
 #include "nwgraph/experimental/algorithms/triangle_count.hpp"
 #include "nwgraph/edge_list.hpp"
 #include "nwgraph/io/mmio.hpp"
+#include "nwgraph/util/intersection_size.hpp"
 
 #include "common/test_header.hpp"
 
@@ -118,3 +121,88 @@ TEST_CASE("triangle counting", "[tc]") {
   }
 
 }
+
+TEST_CASE("intersection kernels", "[tc]") {
+  std::mt19937 gen(7);
+
+  // A strictly increasing array of n values with random gaps.
+  auto make_set = [&](std::size_t n, std::uint32_t max_gap) {
+    std::vector<std::uint32_t>                   s(n);
+    std::uniform_int_distribution<std::uint32_t> gap(1, max_gap);
+    std::uint32_t                                x = 0;
+    for (auto&& v : s) {
+      v = x += gap(gen);
+    }
+    return s;
+  };
+
+  for (auto [na, nb] : {std::pair{0, 5}, {7, 9}, {33, 47}, {100, 100}, {250, 31}, {3, 1000}, {1000, 17}}) {
+    auto a = make_set(na, 4), b = make_set(nb, 4);
+
+    std::vector<std::uint32_t> c;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(c));
+
+    REQUIRE(intersection::scalar(a.data(), na, b.data(), nb) == c.size());
+    REQUIRE(intersection::galloping(a.data(), na, b.data(), nb) == c.size());
+    REQUIRE(intersection::galloping(b.data(), nb, a.data(), na) == c.size());
+    REQUIRE(intersection::block_kernel()(a.data(), na, b.data(), nb) == c.size());
+    REQUIRE(intersection::dispatch(a.data(), na, b.data(), nb) == c.size());
+#if defined(NW_GRAPH_X86_INTERSECTION)
+    if (__builtin_cpu_supports("avx2")) {
+      REQUIRE(intersection::avx2(a.data(), na, b.data(), nb) == c.size());
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+      REQUIRE(intersection::avx512(a.data(), na, b.data(), nb) == c.size());
+    }
+#endif
+  }
+
+  SECTION("repeated values match one to one, as in a merge") {
+    for (auto [na, nb] : {std::pair{40, 40}, {64, 33}, {17, 90}, {200, 180}}) {
+      // Nondecreasing arrays where most values repeat.
+      auto a = make_set(na, 2), b = make_set(nb, 2);
+      for (std::size_t k = 1; k < a.size(); k += 2) a[k] = a[k - 1];
+      for (std::size_t k = 2; k < b.size(); k += 3) b[k] = b[k - 1];
+
+      std::vector<std::uint32_t> c;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(c));
+
+      REQUIRE(intersection::scalar(a.data(), na, b.data(), nb) == c.size());
+      REQUIRE(intersection::dispatch(a.data(), na, b.data(), nb) == c.size());
+#if defined(NW_GRAPH_X86_INTERSECTION)
+      if (__builtin_cpu_supports("avx2")) {
+        REQUIRE(intersection::avx2(a.data(), na, b.data(), nb) == c.size());
+      }
+      if (__builtin_cpu_supports("avx512f")) {
+        REQUIRE(intersection::avx512(a.data(), na, b.data(), nb) == c.size());
+      }
+#endif
+    }
+
+    // A repeat that straddles two blocks of the longer array.
+    std::vector<std::uint32_t> a(32), b(32);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 0);
+    a[16] = a[15];
+    a[8]  = a[7];
+    REQUIRE(intersection::block_kernel()(a.data(), a.size(), b.data(), b.size()) == 30);
+    REQUIRE(intersection::block_kernel()(b.data(), b.size(), a.data(), a.size()) == 30);
+  }
+
+  SECTION("neighbor ranges use the kernels") {
+    static_assert(contiguous_vertex_iterator<decltype(std::declval<const adjacency<0>&>()[0].begin())>);
+    static_assert(contiguous_vertex_iterator<decltype(std::declval<const adjacency<0, double>&>()[0].begin())>);
+
+    auto         E = read_mm<directedness::undirected>(DATA_DIR "karate.mtx");
+    adjacency<0> A(E);
+    for (std::size_t u = 0; u < A.size(); ++u) {
+      for (auto&& [v] : A[u]) {
+        std::size_t n = 0;
+        for (auto&& [w] : A[u]) {
+          n += std::any_of(A[v].begin(), A[v].end(), [&](auto&& x) { return std::get<0>(x) == w; });
+        }
+        REQUIRE(intersection_size(A[u], A[v]) == n);
+      }
+    }
+  }
+}